@@ -4,6 +4,7 @@
 #include <wmtk/ExecutionScheduler.hpp>
 #include <wmtk/utils/EnergyHarmonicTet.hpp>
 #include <wmtk/utils/ExecutorUtils.hpp>
+#include <wmtk/utils/Predicates.hpp>
 #include <wmtk/utils/TetraQualityUtils.hpp>
 #include <wmtk/utils/TupleUtils.hpp>
 #include <wmtk/utils/io.hpp>
@@ -45,7 +46,7 @@ bool HarmonicTet::is_inverted(const Tuple& loc)
         ps[j] = vertex_attrs[tups[j]].pos;
     }
 
-    igl::predicates::exactinit();
+    wmtk::predicates::init();
     auto res = igl::predicates::orient3d(ps[0], ps[1], ps[2], ps[3]);
     if (res == igl::predicates::Orientation::NEGATIVE) return false; // extremely annoying.
     return true;
@@ -82,8 +83,8 @@ bool harmonic_tet::HarmonicTet::smooth_after(const Tuple& t)
     auto old_pos = vertex_attrs[vid].pos;
     vertex_attrs[vid].pos = wmtk::gradient_descent_from_stack(
         assembles,
-        wmtk::harmonic_tet_energy,
-        wmtk::harmonic_tet_jacobian);
+        wmtk::harmonic_tet_energy_batch,
+        wmtk::harmonic_tet_jacobian_batch);
     if (vertex_attrs[vid].pos == old_pos) return false;
     wmtk::logger().trace(
         "old pos {} -> new pos {}",
@@ -245,6 +246,18 @@ void HarmonicTet::output_mesh(std::string file) const
     msh.save(file, true);
 }
 
+void HarmonicTet::output_snapshot(std::string file) const
+{
+    wmtk::MeshSnapshotWriter writer(*this);
+    writer.add_attribute<double, 3>("position", vert_capacity(), [&](size_t i) {
+        return vertex_attrs.at(i).pos;
+    });
+    writer.add_attribute<double>("quality", tet_capacity(), [&](size_t i) {
+        return tet_attrs.at(i).quality;
+    });
+    writer.write(file);
+}
+
 auto renewal_all = [](const auto& m, auto op, const auto& newt) {
     auto optup1 = wmtk::renewal_edges(m, op, newt);
     auto optup2 = wmtk::renewal_faces(m, op, newt);
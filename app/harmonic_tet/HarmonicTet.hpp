@@ -10,11 +10,13 @@
 // clang-format on
 
 #include "wmtk/utils/Logger.hpp"
+#include <wmtk/utils/MeshSnapshot.hpp>
 #include <wmtk/utils/partition_utils.hpp>
 
 #include <Eigen/Core>
 #include <atomic>
 #include <memory>
+#include <stdexcept>
 
 namespace harmonic_tet {
 
@@ -57,6 +59,34 @@ public:
         
         compute_vertex_partition_morton();
     }
+    /**
+     * From a snapshot written by output_snapshot(), the positions are read from its "position"
+     * column.
+     * @throws std::runtime_error if the snapshot has no position per vertex
+     */
+    HarmonicTet(const wmtk::MeshSnapshot& snapshot, int num_threads = 1)
+    {
+        p_vertex_attrs = &vertex_attrs;
+        p_tet_attrs = &tet_attrs;
+
+        NUM_THREADS = num_threads;
+        init(snapshot);
+
+        const auto position = snapshot.attribute<double>("position");
+        if (position.num_fields != 3 || position.size < vert_capacity()) {
+            throw std::runtime_error("Snapshot position is not one 3D point per vertex");
+        }
+        for_each_vertex([&](auto& v) {
+            auto i = v.vid(*this);
+            vertex_attrs[i].pos = Eigen::Vector3d(position[i]);
+        });
+        for_each_tetra([&](auto& t) {
+            auto i = t.tid(*this);
+            tet_attrs[i].quality = get_quality(t);
+        });
+
+        compute_vertex_partition_morton();
+    }
     HarmonicTet(){};
     ~HarmonicTet(){};
 
@@ -78,6 +108,8 @@ public:
     }
 
     void output_mesh(std::string file) const;
+    /// native snapshot for the next stage of a pipeline, see wmtk::MeshSnapshot
+    void output_snapshot(std::string file) const;
     
     size_t get_partition_id(const Tuple& loc) const
     {
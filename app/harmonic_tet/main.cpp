@@ -2,6 +2,7 @@
 
 #include <wmtk/utils/Delaunay.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/RunReport.hpp>
 #include <wmtk/utils/TetraQualityUtils.hpp>
 #include <wmtk/utils/io.hpp>
 #include "wmtk/utils/Delaunay.hpp"
@@ -21,13 +22,31 @@
 #include <igl/read_triangle_mesh.h>
 #include <igl/remove_duplicate_vertices.h>
 
+#include <optional>
+
 struct
 {
     std::string input;
     std::string output;
     int thread = 1;
+    std::string report;
 } args;
 
+// meshes ending with .wmtk are native snapshots, see wmtk::MeshSnapshot
+auto is_snapshot = [](const std::string& file) {
+    const std::string ext = ".wmtk";
+    return file.size() >= ext.size() &&
+           file.compare(file.size() - ext.size(), ext.size(), ext) == 0;
+};
+
+auto save = [](const harmonic_tet::HarmonicTet& har_tet, const std::string& output) {
+    wmtk::ScopedPhase phase("output");
+    if (is_snapshot(output))
+        har_tet.output_snapshot(output);
+    else
+        har_tet.output_mesh(output);
+};
+
 auto stats = [](auto& har_tet) {
     auto total_e = 0.;
     auto cnt = 0;
@@ -50,41 +69,75 @@ auto stats = [](auto& har_tet) {
     return std::pair(total_e, cnt);
 };
 
+// results of the run for --report
+auto report_quality = [](auto& har_tet) {
+    auto [total_e, cnt] = stats(har_tet);
+    auto& report = wmtk::RunReport::global();
+    report.set("tets", cnt);
+    report.set("vertices", har_tet.get_vertices().size());
+    report.set("total_energy", total_e);
+    report.set("avg_energy", total_e / cnt);
+};
+
 auto process_mesh = [&args = args]() {
     auto& input = args.input;
     auto& output = args.output;
     auto& thread = args.thread;
-    auto vec_attrs = std::vector<Eigen::Vector3d>();
-    auto tets = std::vector<std::array<size_t, 4>>();
-    wmtk::MshData msh;
-    msh.load(input);
-    vec_attrs.resize(msh.get_num_tet_vertices());
-    tets.resize(msh.get_num_tets());
-    msh.extract_tet_vertices(
-        [&](size_t i, double x, double y, double z) { vec_attrs[i] << x, y, z; });
-    msh.extract_tets([&](size_t i, size_t v0, size_t v1, size_t v2, size_t v3) {
-        tets[i] = {{v0, v1, v2, v3}};
-    });
     igl::Timer timer;
     auto time = 0.;
-    timer.start();
-    auto har_tet = harmonic_tet::HarmonicTet(vec_attrs, tets, thread);
-    time += timer.getElapsedTimeInMilliSec();
+    // HarmonicTet can't be moved, it is built in place
+    std::optional<harmonic_tet::HarmonicTet> loaded;
+    igl::Timer input_timer;
+    input_timer.start();
+    if (is_snapshot(input)) {
+        wmtk::MeshSnapshot snapshot(input);
+        wmtk::RunReport::global().add_time("input", input_timer.getElapsedTimeInSec());
+        wmtk::RunReport::global().start_total();
+        timer.start();
+        loaded.emplace(snapshot, thread);
+        time += timer.getElapsedTimeInMilliSec();
+    } else {
+        auto vec_attrs = std::vector<Eigen::Vector3d>();
+        auto tets = std::vector<std::array<size_t, 4>>();
+        wmtk::MshData msh;
+        msh.load(input);
+        vec_attrs.resize(msh.get_num_tet_vertices());
+        tets.resize(msh.get_num_tets());
+        msh.extract_tet_vertices(
+            [&](size_t i, double x, double y, double z) { vec_attrs[i] << x, y, z; });
+        msh.extract_tets([&](size_t i, size_t v0, size_t v1, size_t v2, size_t v3) {
+            tets[i] = {{v0, v1, v2, v3}};
+        });
+        wmtk::RunReport::global().add_time("input", input_timer.getElapsedTimeInSec());
+        wmtk::RunReport::global().start_total();
+        timer.start();
+        loaded.emplace(vec_attrs, tets, thread);
+        time += timer.getElapsedTimeInMilliSec();
+    }
+    auto& har_tet = *loaded;
     for (int i = 0; i <= 10; i++) {
         auto [E0, cnt0] = stats(har_tet);
         timer.start();
         auto swp = har_tet.swap_all();
         time += timer.getElapsedTimeInMilliSec();
+        wmtk::RunReport::global().add_time("swap", timer.getElapsedTimeInSec());
         stats(har_tet);
         timer.start();
         har_tet.consolidate_mesh();
+        time += timer.getElapsedTimeInMilliSec();
+        wmtk::RunReport::global().add_time("consolidate", timer.getElapsedTimeInSec());
+        timer.start();
         har_tet.smooth_all_vertices(true);
         time += timer.getElapsedTimeInMilliSec();
+        wmtk::RunReport::global().add_time("smooth", timer.getElapsedTimeInSec());
+        har_tet.memory_report().log(fmt::format("after iteration {}", i));
         auto [E1, cnt1] = stats(har_tet);
         if (swp == 0) break;
     }
     wmtk::logger().info("Time cost {}s", time / 1e3);
-    har_tet.output_mesh(output);
+    wmtk::RunReport::global().stop_total();
+    save(har_tet, output);
+    if (!args.report.empty()) report_quality(har_tet);
 };
 
 auto process_points = [&args = args]() {
@@ -94,6 +147,7 @@ auto process_points = [&args = args]() {
     auto vec_attrs = std::vector<Eigen::Vector3d>();
     auto tets = std::vector<std::array<size_t, 4>>();
     {
+        wmtk::ScopedPhase phase("input");
         Eigen::MatrixXd V;
         Eigen::MatrixXi F;
         igl::read_triangle_mesh(input, V, F);
@@ -115,16 +169,21 @@ auto process_points = [&args = args]() {
     igl::Timer timer;
     auto time = 0.;
     timer.start();
+    wmtk::RunReport::global().start_total();
     auto har_tet = harmonic_tet::HarmonicTet(vec_attrs, tets, thread);
     // auto [E0, cnt0] = stats(har_tet);
     har_tet.swap_all_edges(true);
     time = timer.getElapsedTimeInMilliSec();
+    wmtk::RunReport::global().add_time("swap", time / 1e3);
     wmtk::logger().info("Time cost: {}", time / 1e3);
     stats(har_tet);
     har_tet.consolidate_mesh();
+    har_tet.memory_report().log("after swap");
+    wmtk::RunReport::global().stop_total();
     // auto [E1, cnt1] = stats(har_tet);
     // wmtk::logger().info("E {} -> {} cnt {} -> {}", E0, E1, cnt0, cnt1);
-    har_tet.output_mesh(output);
+    save(har_tet, output);
+    if (!args.report.empty()) report_quality(har_tet);
 };
 
 int main(int argc, char** argv)
@@ -135,11 +194,14 @@ int main(int argc, char** argv)
     app.add_option("output", args.output, "output mesh.");
     app.add_option("-j, --thread", args.thread, "thread.");
     app.add_flag("--harmonize", harmonize, "Delaunay harmonize.");
+    app.add_option("--report", args.report, "file of the phase times and results of the run");
     CLI11_PARSE(app, argc, argv);
 
     if (harmonize)
         process_points();
     else
         process_mesh();
+
+    if (!args.report.empty()) wmtk::RunReport::global().write(args.report);
     return 0;
 }
\ No newline at end of file
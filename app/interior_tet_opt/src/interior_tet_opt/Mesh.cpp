@@ -2,6 +2,7 @@
 #include <Eigen/src/Core/functors/UnaryFunctors.h>
 #include <igl/predicates/predicates.h>
 #include <wmtk/utils/Morton.h>
+#include <wmtk/utils/Predicates.hpp>
 #include <cassert>
 #include <cmath>
 #include "wmtk/ExecutionScheduler.hpp"
@@ -270,9 +271,9 @@ bool InteriorTetOpt::smooth_after(const Tuple& t)
     auto old_asssembles = assembles;
     m_vertex_attribute[vid].pos = wmtk::newton_method_from_stack(
         assembles,
-        wmtk::AMIPS_energy,
-        wmtk::AMIPS_jacobian,
-        wmtk::AMIPS_hessian);
+        wmtk::AMIPS_energy_batch,
+        wmtk::AMIPS_jacobian_batch,
+        wmtk::AMIPS_hessian_batch);
     wmtk::logger().trace(
         "old pos {} -> new pos {}",
         old_pos.transpose(),
@@ -572,7 +573,7 @@ bool InteriorTetOpt::is_inverted(const Tuple& loc) const
 
     auto vs = oriented_tet_vertices(loc);
 
-    igl::predicates::exactinit();
+    wmtk::predicates::init();
     auto res = igl::predicates::orient3d(
         m_vertex_attribute[vs[0].vid(*this)].pos,
         m_vertex_attribute[vs[1].vid(*this)].pos,
@@ -9,6 +9,7 @@
 #include <igl/read_triangle_mesh.h>
 #include <igl/writeDMAT.h>
 #include <wmtk/utils/Reader.hpp>
+#include <wmtk/utils/RunReport.hpp>
 
 #include <stdlib.h>
 #include <chrono>
@@ -25,7 +26,11 @@ void run_qslim_collapse(std::string input, int target, std::string output, QSLIM
     wmtk::logger().info("target number of verts: {}", target);
     assert(m.check_mesh_connectivity_validity());
     wmtk::logger().info("mesh is valid");
-    m.collapse_qslim(target);
+    {
+        wmtk::ScopedPhase phase("collapse");
+        m.collapse_qslim(target);
+    }
+    m.memory_report().log("after collapse");
     wmtk::logger().info("collapsed");
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(stop - start);
@@ -39,6 +44,7 @@ int main(int argc, char** argv)
     double target_pec = 0.1;
     int thread = 1;
     double target_verts_percent = 0.1;
+    std::string report_path;
 
     CLI::App app{argv[0]};
     app.add_option("input", input_path, "Input mesh.")->check(CLI::ExistingFile);
@@ -47,6 +53,7 @@ int main(int argc, char** argv)
     app.add_option("-t, --target", target_pec, "Percentage of input vertices in output.");
     app.add_option("-e,--envelope", env_rel, "Relative envelope size, negative to disable");
     app.add_option("-j, --thread", thread, "thread.");
+    app.add_option("--report", report_path, "file of the phase times and results of the run");
     CLI11_PARSE(app, argc, argv);
 
     std::vector<Eigen::Vector3d> verts;
@@ -54,19 +61,23 @@ int main(int argc, char** argv)
     std::pair<Eigen::Vector3d, Eigen::Vector3d> box_minmax;
     double remove_duplicate_esp = 1e-5;
     std::vector<size_t> modified_nonmanifold_v;
-    wmtk::stl_to_manifold_wmtk_input(
-        input_path,
-        remove_duplicate_esp,
-        box_minmax,
-        verts,
-        tris,
-        modified_nonmanifold_v);
+    {
+        wmtk::ScopedPhase phase("input");
+        wmtk::stl_to_manifold_wmtk_input(
+            input_path,
+            remove_duplicate_esp,
+            box_minmax,
+            verts,
+            tris,
+            modified_nonmanifold_v);
+    }
 
     double diag = (box_minmax.first - box_minmax.second).norm();
     const double envelope_size = env_rel * diag;
 
     igl::Timer timer;
     timer.start();
+    wmtk::RunReport::global().start_total();
     QSLIM m(verts, thread);
     m.create_mesh(verts.size(), tris, modified_nonmanifold_v, envelope_size);
     assert(m.check_mesh_connectivity_validity());
@@ -74,13 +85,25 @@ int main(int argc, char** argv)
     int target_verts = verts.size() * target_pec;
 
     run_qslim_collapse(input_path, target_verts, output, m);
+    m.consolidate_mesh();
     timer.stop();
+    wmtk::RunReport::global().stop_total();
     logger().info("Took {}", timer.getElapsedTimeInSec());
-    m.consolidate_mesh();
-    m.write_triangle_mesh(output);
+    {
+        wmtk::ScopedPhase phase("output");
+        m.write_triangle_mesh(output);
+    }
     wmtk::logger().info(
         "After_vertices#: {} \n After_tris#: {}",
         m.vert_capacity(),
         m.tri_capacity());
+
+    if (!report_path.empty()) {
+        auto& report = wmtk::RunReport::global();
+        report.set("vertices", m.vert_capacity());
+        report.set("faces", m.tri_capacity());
+        wmtk::report_edge_length_valence(m, [&m](size_t i) { return m.vertex_attrs[i].pos; });
+        report.write(report_path);
+    }
     return 0;
 }
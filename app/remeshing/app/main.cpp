@@ -3,6 +3,7 @@
 #include <CLI/CLI.hpp>
 
 #include <wmtk/utils/Reader.hpp>
+#include <wmtk/utils/RunReport.hpp>
 
 #include <igl/Timer.h>
 #include <igl/read_triangle_mesh.h>
@@ -18,10 +19,6 @@ using namespace wmtk;
 using namespace app::remeshing;
 using namespace std::chrono;
 
-extern "C" {
-#include <wmtk/utils/getRSS.c>
-}
-
 void run_remeshing(std::string input, double len, std::string output, UniformRemeshing& m, int itrs)
 {
     auto start = high_resolution_clock::now();
@@ -30,9 +27,13 @@ void run_remeshing(std::string input, double len, std::string output, UniformRem
     m.consolidate_mesh();
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(stop - start);
+    wmtk::RunReport::global().stop_total();
 
-    m.consolidate_mesh();
-    m.write_triangle_mesh(output);
+    {
+        wmtk::ScopedPhase phase("output");
+        m.consolidate_mesh();
+        m.write_triangle_mesh(output);
+    }
     auto properties = m.average_len_valen();
     wmtk::logger().info("runtime in ms {}", duration.count());
     wmtk::logger().info("current_memory {}", getCurrentRSS() / (1024. * 1024));
@@ -42,6 +43,11 @@ void run_remeshing(std::string input, double len, std::string output, UniformRem
         "After_vertices#: {} \n\t After_tris#: {}",
         m.vert_capacity(),
         m.tri_capacity());
+
+    auto& report = wmtk::RunReport::global();
+    report.set("vertices", m.vert_capacity());
+    report.set("faces", m.tri_capacity());
+    wmtk::report_edge_length_valence(m, [&m](size_t i) { return m.vertex_attrs[i].pos; });
 }
 
 int main(int argc, char** argv)
@@ -56,6 +62,7 @@ int main(int argc, char** argv)
     bool freeze = true;
     bool bnd_output = false;
     bool sample_envelope = false;
+    std::string report_path;
 
     CLI::App app{argv[0]};
     app.add_option("input", input_path, "Input mesh.")->check(CLI::ExistingFile);
@@ -68,6 +75,7 @@ int main(int argc, char** argv)
     app.add_option("-i, --iterations", itrs, "number of remeshing itrs.");
     app.add_option("-f, --freeze", freeze, "to freeze the boundary, default to true");
     app.add_flag("--sample-envelope", sample_envelope, "use sample envelope, default to false.");
+    app.add_option("--report", report_path, "file of the phase times and results of the run");
 
     CLI11_PARSE(app, argc, argv);
 
@@ -78,18 +86,22 @@ int main(int argc, char** argv)
     std::pair<Eigen::Vector3d, Eigen::Vector3d> box_minmax;
     double remove_duplicate_esp = 1e-5;
     std::vector<size_t> modified_nonmanifold_v;
-    wmtk::stl_to_manifold_wmtk_input(
-        input_path,
-        remove_duplicate_esp,
-        box_minmax,
-        verts,
-        tris,
-        modified_nonmanifold_v);
+    {
+        wmtk::ScopedPhase phase("input");
+        wmtk::stl_to_manifold_wmtk_input(
+            input_path,
+            remove_duplicate_esp,
+            box_minmax,
+            verts,
+            tris,
+            modified_nonmanifold_v);
+    }
 
     double diag = (box_minmax.first - box_minmax.second).norm();
     const double envelope_size = env_rel * diag;
     igl::Timer timer;
 
+    wmtk::RunReport::global().start_total();
     UniformRemeshing m(verts, thread, !sample_envelope);
     m.create_mesh(verts.size(), tris, modified_nonmanifold_v, freeze, envelope_size);
 
@@ -105,5 +117,6 @@ int main(int argc, char** argv)
         run_remeshing(input_path, len, output, m, itrs);
     }
 
+    if (!report_path.empty()) wmtk::RunReport::global().write(report_path);
     return 0;
 }
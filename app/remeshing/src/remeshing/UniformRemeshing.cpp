@@ -8,6 +8,7 @@
 #include <Eigen/Geometry>
 #include <atomic>
 #include <wmtk/ExecutionScheduler.hpp>
+#include <wmtk/utils/RunReport.hpp>
 #include <wmtk/utils/TupleUtils.hpp>
 using namespace app::remeshing;
 using namespace wmtk;
@@ -663,21 +664,26 @@ bool UniformRemeshing::uniform_remeshing(double L, int iterations)
         // split
         timer.start();
         split_remeshing(L);
+        wmtk::RunReport::global().add_time("split", timer.getElapsedTime());
         wmtk::logger().info("--------split time-------: {} ms", timer.getElapsedTimeInMilliSec());
         // collpase
         timer.start();
         collapse_remeshing(L);
+        wmtk::RunReport::global().add_time("collapse", timer.getElapsedTime());
         wmtk::logger().info(
             "--------collapse time-------: {} ms",
             timer.getElapsedTimeInMilliSec());
         // swap edges
         timer.start();
         swap_remeshing();
+        wmtk::RunReport::global().add_time("swap", timer.getElapsedTime());
         wmtk::logger().info("--------swap time-------: {} ms", timer.getElapsedTimeInMilliSec());
         // smoothing
         timer.start();
         smooth_all_vertices();
+        wmtk::RunReport::global().add_time("smooth", timer.getElapsedTime());
         wmtk::logger().info("--------smooth time-------: {} ms", timer.getElapsedTimeInMilliSec());
+        memory_report().log(fmt::format("after pass {}", cnt));
 
         partition_mesh_morton();
     }
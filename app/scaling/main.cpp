@@ -0,0 +1,114 @@
+#include <scaling/Scaling.hpp>
+
+#include <wmtk/utils/Logger.hpp>
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <CLI/CLI.hpp>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace app::scaling;
+
+/**
+ * Scaling driver of the applications, runs the jobs of a config and writes the medians, speedups
+ * and efficiencies to <output>.csv and <output>.json, see scaling/Scaling.hpp for the format.
+ */
+int main(int argc, char** argv)
+{
+    std::string config_path;
+    std::string output = "scaling";
+    std::string work_dir = "scaling_runs";
+    std::string data_dir = WMT_DATA_DIR;
+    std::vector<std::string> apps;
+    std::vector<std::string> only;
+
+    CLI::App app{argv[0]};
+    app.add_option("-c,--config", config_path, "Scaling config.")->required();
+    app.add_option("-o,--output", output, "Prefix of the .csv and .json summaries.");
+    app.add_option("-w,--work", work_dir, "Folder of the outputs and reports of the runs.");
+    app.add_option("-d,--data", data_dir, "Data folder, {data} in the commands.");
+    app.add_option("--app", apps, "<name>=<path> of an application, {name} in the commands.");
+    app.add_option("--only", only, "Run only these jobs.");
+    CLI11_PARSE(app, argc, argv);
+
+    std::map<std::string, std::string> placeholders = {{"data", data_dir}};
+    for (const auto& a : apps) {
+        const auto eq = a.find('=');
+        if (eq == std::string::npos) {
+            wmtk::logger().error("--app {} is not <name>=<path>", a);
+            return 1;
+        }
+        placeholders[a.substr(0, eq)] = a.substr(eq + 1);
+    }
+
+    std::vector<Result> results;
+    try {
+        const auto jobs = read_config(config_path);
+        std::filesystem::create_directories(work_dir);
+        for (const auto& job : jobs) {
+            if (!only.empty() && std::find(only.begin(), only.end(), job.name) == only.end())
+                continue;
+            for (size_t t = 0; t < job.threads.size(); t++) {
+                const int threads = job.threads[t];
+                std::vector<Values> reports;
+                for (int repeat = 0; repeat < job.repeats; repeat++) {
+                    const auto out = (std::filesystem::path(work_dir) /
+                                      fmt::format("{}_{}_{}", job.name, threads, repeat))
+                                          .string();
+                    auto values = placeholders;
+                    values["threads"] = std::to_string(threads);
+                    values["out"] = out;
+                    values["report"] = out + ".report";
+                    if (!job.inputs.empty()) values["input"] = job.inputs[t];
+                    const auto command = substitute(job.command, values);
+                    std::filesystem::remove(values["report"]);
+
+                    wmtk::logger().info(
+                        "[{}] {} threads, run {}: {}",
+                        job.name,
+                        threads,
+                        repeat,
+                        command);
+                    const auto log = out + ".log";
+                    const int status = std::system((command + " > " + log + " 2>&1").c_str());
+                    if (status != 0) {
+                        wmtk::logger().error("[{}] failed ({}), see {}", job.name, status, log);
+                        continue;
+                    }
+                    try {
+                        reports.push_back(read_report(values["report"]));
+                    } catch (const std::exception& e) {
+                        wmtk::logger().error("[{}] failed ({}), see {}", job.name, e.what(), log);
+                    }
+                }
+                results.push_back(summarize(job, threads, reports));
+            }
+        }
+    } catch (const std::exception& e) {
+        wmtk::logger().error("{}", e.what());
+        return 1;
+    }
+
+    compute_scaling(results);
+    for (const auto& r : results) {
+        wmtk::logger().info(
+            "[{}] {} threads: time {:.3f}s speedup {:.2f} efficiency {:.2f}",
+            r.job,
+            r.threads,
+            value_of(r, "total_time"),
+            r.speedup,
+            r.efficiency);
+    }
+    write_csv(output + ".csv", results);
+    write_json(output + ".json", results);
+    wmtk::logger().info("summaries written to {}.csv and {}.json", output, output);
+    return 0;
+}
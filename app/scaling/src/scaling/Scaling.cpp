@@ -0,0 +1,256 @@
+#include "Scaling.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace app::scaling {
+
+namespace {
+std::string trim(const std::string& s)
+{
+    const auto begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+}
+
+std::vector<std::string> split_words(const std::string& s)
+{
+    std::istringstream in(s);
+    std::vector<std::string> words;
+    for (std::string w; in >> w;) words.push_back(w);
+    return words;
+}
+
+std::vector<int> parse_threads(const std::string& s)
+{
+    std::vector<int> threads;
+    for (const auto& w : split_words(s)) threads.push_back(std::stoi(w));
+    return threads;
+}
+
+double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+/// keys of all the results, in order of first appearance
+std::vector<std::string> all_keys(const std::vector<Result>& results)
+{
+    std::vector<std::string> keys;
+    for (const auto& r : results) {
+        for (const auto& kv : r.values) {
+            if (std::find(keys.begin(), keys.end(), kv.first) == keys.end())
+                keys.push_back(kv.first);
+        }
+    }
+    return keys;
+}
+
+/// s as the contents of a JSON string
+std::string json_escape(const std::string& s)
+{
+    std::string out;
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+} // namespace
+
+std::vector<Job> read_config(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot read the scaling config " + path);
+
+    std::vector<int> threads = {1};
+    int repeats = 1;
+    std::vector<Job> jobs;
+    int line_number = 0;
+    for (std::string line; std::getline(in, line);) {
+        line_number++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        if (line.front() == '[' && line.back() == ']') {
+            jobs.emplace_back();
+            jobs.back().name = trim(line.substr(1, line.size() - 2));
+            jobs.back().threads = threads;
+            jobs.back().repeats = repeats;
+            continue;
+        }
+        const auto eq = line.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error(
+                path + ":" + std::to_string(line_number) + ": expected key = value");
+        }
+        const auto key = trim(line.substr(0, eq)), value = trim(line.substr(eq + 1));
+        if (jobs.empty()) { // defaults of the jobs that follow
+            if (key == "threads")
+                threads = parse_threads(value);
+            else if (key == "repeats")
+                repeats = std::stoi(value);
+            else
+                throw std::runtime_error(path + ": unknown global key " + key);
+            continue;
+        }
+        auto& job = jobs.back();
+        if (key == "command")
+            job.command = value;
+        else if (key == "threads")
+            job.threads = parse_threads(value);
+        else if (key == "repeats")
+            job.repeats = std::stoi(value);
+        else if (key == "scaling" && (value == "strong" || value == "weak"))
+            job.weak = value == "weak";
+        else if (key == "inputs")
+            job.inputs = split_words(value);
+        else
+            throw std::runtime_error(path + ": unknown key " + key + " in [" + job.name + "]");
+    }
+
+    for (const auto& job : jobs) {
+        if (job.command.empty()) throw std::runtime_error("[" + job.name + "] has no command");
+        if (job.threads.empty()) throw std::runtime_error("[" + job.name + "] has no threads");
+        if (!job.inputs.empty() && job.inputs.size() != job.threads.size()) {
+            throw std::runtime_error("[" + job.name + "] needs one input per thread count");
+        }
+    }
+    return jobs;
+}
+
+std::string substitute(std::string s, const std::map<std::string, std::string>& values)
+{
+    for (const auto& [key, value] : values) {
+        const auto pattern = "{" + key + "}";
+        for (auto pos = s.find(pattern); pos != std::string::npos;
+             pos = s.find(pattern, pos + value.size())) {
+            s.replace(pos, pattern.size(), value);
+        }
+    }
+    return s;
+}
+
+Values read_report(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("The run wrote no report " + path);
+    Values values;
+    for (std::string line; std::getline(in, line);) {
+        const auto colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        values.emplace_back(trim(line.substr(0, colon)), std::stod(line.substr(colon + 1)));
+    }
+    return values;
+}
+
+Result summarize(const Job& job, int threads, const std::vector<Values>& reports)
+{
+    Result result;
+    result.job = job.name;
+    result.weak = job.weak;
+    result.threads = threads;
+    result.runs = int(reports.size());
+    std::vector<std::pair<std::string, std::vector<double>>> samples;
+    for (const auto& report : reports) {
+        for (const auto& [key, value] : report) {
+            auto it = std::find_if(samples.begin(), samples.end(), [&](const auto& s) {
+                return s.first == key;
+            });
+            if (it == samples.end()) it = samples.insert(samples.end(), {key, {}});
+            it->second.push_back(value);
+        }
+    }
+    for (const auto& [key, values] : samples) result.values.emplace_back(key, median(values));
+    return result;
+}
+
+double value_of(const Result& r, const std::string& key)
+{
+    for (const auto& [k, v] : r.values) {
+        if (k == key) return v;
+    }
+    return 0;
+}
+
+void compute_scaling(std::vector<Result>& results)
+{
+    for (size_t first = 0; first < results.size();) {
+        size_t last = first;
+        while (last < results.size() && results[last].job == results[first].job) last++;
+        const auto& base = results[first];
+        // 0 threads is the sequential version of the apps
+        const double p0 = std::max(base.threads, 1), t0 = value_of(base, "total_time");
+        for (size_t i = first; i < last; i++) {
+            auto& r = results[i];
+            const double p = std::max(r.threads, 1), t = value_of(r, "total_time");
+            if (r.runs == 0 || base.runs == 0 || t <= 0) continue;
+            if (r.weak) {
+                r.efficiency = t0 / t;
+                r.speedup = r.efficiency * p / p0;
+            } else {
+                r.speedup = t0 / t;
+                r.efficiency = r.speedup * p0 / p;
+            }
+        }
+        first = last;
+    }
+}
+
+void write_csv(const std::string& path, const std::vector<Result>& results)
+{
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    out.precision(10);
+    const auto keys = all_keys(results);
+    out << "job,scaling,threads,runs,speedup,efficiency";
+    for (const auto& k : keys) out << "," << k;
+    out << "\n";
+    for (const auto& r : results) {
+        out << r.job << "," << (r.weak ? "weak" : "strong") << "," << r.threads << "," << r.runs
+            << "," << r.speedup << "," << r.efficiency;
+        for (const auto& k : keys) {
+            const auto it = std::find_if(r.values.begin(), r.values.end(), [&](const auto& kv) {
+                return kv.first == k;
+            });
+            out << ",";
+            if (it != r.values.end()) out << it->second;
+        }
+        out << "\n";
+    }
+}
+
+void write_json(const std::string& path, const std::vector<Result>& results)
+{
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    out.precision(10);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << "  {\"job\": \"" << json_escape(r.job) << "\", \"scaling\": \""
+            << (r.weak ? "weak" : "strong") << "\", \"threads\": " << r.threads
+            << ", \"runs\": " << r.runs << ", \"speedup\": " << r.speedup
+            << ", \"efficiency\": " << r.efficiency << ", \"median\": {";
+        for (size_t j = 0; j < r.values.size(); j++) {
+            out << (j ? ", " : "") << "\"" << json_escape(r.values[j].first)
+                << "\": " << r.values[j].second;
+        }
+        out << "}}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+} // namespace app::scaling
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Scaling study of the applications, used by the wmtk_scaling driver. It runs the jobs of a config
+ * file for each thread count, several times, reads the --report of every run (see wmtk::RunReport)
+ * and writes the median of each reported value with the speedup and the efficiency.
+ *
+ * The config has "key = value" lines and a [section] per job, # starts a comment:
+ *
+ *     threads = 1 2 4 8     # default thread counts and repeats of the jobs
+ *     repeats = 3
+ *
+ *     [tetwild]
+ *     command = {tetwild} -i {data}/37322.stl -o {out} -j {threads} --report {report}
+ *
+ *     [sec-weak]
+ *     scaling = weak        # strong (default) or weak
+ *     threads = 1 2 4
+ *     inputs = a.stl b.stl c.stl    # weak scaling: the {input} of each thread count
+ *     command = {sec_app} {input} {out}.obj -j {threads} --report {report}
+ *
+ * {threads}, {input}, {data} (the data folder), {out} (an output prefix in the work folder),
+ * {report} and {<app>} for each --app <app>=<path> are replaced in the commands.
+ */
+namespace app::scaling {
+
+using Values = std::vector<std::pair<std::string, double>>;
+
+struct Job
+{
+    std::string name;
+    std::string command;
+    std::vector<int> threads;
+    std::vector<std::string> inputs;
+    int repeats = 1;
+    bool weak = false;
+};
+
+/// median of the reported values of the runs of one job at one thread count
+struct Result
+{
+    std::string job;
+    bool weak = false;
+    int threads = 0;
+    int runs = 0;
+    double speedup = 0;
+    double efficiency = 0;
+    Values values;
+};
+
+/**
+ * @brief The jobs of a scaling config, with the global thread counts and repeats as defaults.
+ * @throws std::runtime_error if the file cannot be read, on an unknown key, a job without command
+ * or threads, or a job with inputs that are not one per thread count
+ */
+std::vector<Job> read_config(const std::string& path);
+
+/// s with each {key} replaced by its value
+std::string substitute(std::string s, const std::map<std::string, std::string>& values);
+
+/// the "key: value" lines of a RunReport, @throws std::runtime_error if there is no report
+Values read_report(const std::string& path);
+
+/// the reports of the runs of a job at one thread count, reduced to their medians
+Result summarize(const Job& job, int threads, const std::vector<Values>& reports);
+
+/// the median of key in the result, 0 if it was not reported
+double value_of(const Result& r, const std::string& key);
+
+/**
+ * @brief Speedup and efficiency of the results, consecutive results of the same job are its
+ * thread counts. They are relative to the first thread count p0 (0, the sequential version of the
+ * apps, counts as 1), with T the median total_time: T(p0) / T(p) and T(p0) p0 / (T(p) p) for strong
+ * scaling, where the problem is fixed, and T(p0) p / (T(p) p0) and T(p0) / T(p) for weak scaling,
+ * where it grows with p. Results without runs are left at 0.
+ */
+void compute_scaling(std::vector<Result>& results);
+
+/// one row per result, one column per reported key
+void write_csv(const std::string& path, const std::vector<Result>& results);
+/// an array with one object per result, the medians in "median"
+void write_json(const std::string& path, const std::vector<Result>& results);
+
+} // namespace app::scaling
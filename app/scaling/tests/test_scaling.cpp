@@ -0,0 +1,190 @@
+#include <scaling/Scaling.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace app::scaling;
+
+namespace {
+std::string temp_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::string write_file(const std::string& name, const std::string& text)
+{
+    const auto path = temp_path(name);
+    std::ofstream(path) << text;
+    return path;
+}
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+/// a result of job with the given thread count and median total_time
+Result timed(const std::string& job, bool weak, int threads, double total_time)
+{
+    Result r;
+    r.job = job;
+    r.weak = weak;
+    r.threads = threads;
+    r.runs = 1;
+    r.values = {{"total_time", total_time}};
+    return r;
+}
+} // namespace
+
+TEST_CASE("scaling_config", "[scaling]")
+{
+    const auto path = write_file(
+        "wmtk_scaling.cfg",
+        "# defaults\n"
+        "threads = 1 2 4 # of all the jobs\n"
+        "repeats = 3\n"
+        "\n"
+        "[strong]\n"
+        "command = {app} -j {threads} --report {report}\n"
+        "\n"
+        "[ weak ]\n"
+        "scaling = weak\r\n"
+        "threads = 1 2\n"
+        "repeats = 1\n"
+        "inputs = a.stl b.stl\n"
+        "command = {app} {input} -j {threads}\n");
+    const auto jobs = read_config(path);
+    REQUIRE(jobs.size() == 2);
+    REQUIRE(jobs[0].name == "strong");
+    REQUIRE(jobs[0].command == "{app} -j {threads} --report {report}");
+    REQUIRE(jobs[0].threads == std::vector<int>{1, 2, 4});
+    REQUIRE(jobs[0].repeats == 3);
+    REQUIRE_FALSE(jobs[0].weak);
+    REQUIRE(jobs[0].inputs.empty());
+    REQUIRE(jobs[1].name == "weak");
+    REQUIRE(jobs[1].weak);
+    REQUIRE(jobs[1].threads == std::vector<int>{1, 2});
+    REQUIRE(jobs[1].repeats == 1);
+    REQUIRE(jobs[1].inputs == std::vector<std::string>{"a.stl", "b.stl"});
+
+    const auto command = substitute(
+        jobs[1].command,
+        {{"app", "/bin/app"}, {"input", "b.stl"}, {"threads", "2"}});
+    REQUIRE(command == "/bin/app b.stl -j 2");
+
+    // invalid configs
+    const auto invalid = [](const std::string& text) {
+        REQUIRE_THROWS(read_config(write_file("wmtk_scaling_invalid.cfg", text)));
+    };
+    invalid("[job]\nthreads = 1\n");
+    invalid("[job]\ncommand = a\nthreads = 1 2\ninputs = a.stl\n");
+    invalid("[job]\ncommand = a\nscaling = linear\n");
+    invalid("processes = 4\n");
+    invalid("[job]\ncommand\n");
+    REQUIRE_THROWS(read_config(temp_path("wmtk_scaling_missing.cfg")));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(temp_path("wmtk_scaling_invalid.cfg"));
+}
+
+TEST_CASE("scaling_summarize", "[scaling]")
+{
+    const auto path = write_file(
+        "wmtk_scaling.report",
+        "time_input: 0.5\ntotal_time: 2\npeak_memory_mb: 10\n");
+    const auto report = read_report(path);
+    REQUIRE(report == Values{{"time_input", 0.5}, {"total_time", 2}, {"peak_memory_mb", 10}});
+    std::filesystem::remove(path);
+    REQUIRE_THROWS(read_report(path));
+
+    // medians of the runs, a key missing from a run has the median of the others
+    Job job;
+    job.name = "job";
+    const auto r = summarize(
+        job,
+        4,
+        {{{"total_time", 3}, {"tets", 10}},
+         {{"total_time", 1}, {"tets", 20}},
+         {{"total_time", 2}}});
+    REQUIRE(r.job == "job");
+    REQUIRE(r.threads == 4);
+    REQUIRE(r.runs == 3);
+    REQUIRE(value_of(r, "total_time") == 2);
+    REQUIRE(value_of(r, "tets") == 15);
+    REQUIRE(value_of(r, "vertices") == 0);
+}
+
+TEST_CASE("scaling_strong", "[scaling]")
+{
+    std::vector<Result> results = {
+        timed("a", false, 1, 8),
+        timed("a", false, 2, 4),
+        timed("a", false, 4, 2.5),
+        timed("b", false, 2, 6),
+        timed("b", false, 4, 4)};
+    results.push_back(timed("b", false, 8, 0));
+    results.back().runs = 0; // all the runs failed
+    compute_scaling(results);
+
+    REQUIRE(results[0].speedup == Approx(1));
+    REQUIRE(results[0].efficiency == Approx(1));
+    REQUIRE(results[1].speedup == Approx(2));
+    REQUIRE(results[1].efficiency == Approx(1));
+    REQUIRE(results[2].speedup == Approx(3.2));
+    REQUIRE(results[2].efficiency == Approx(0.8));
+    // relative to the first thread count of the job
+    REQUIRE(results[3].speedup == Approx(1));
+    REQUIRE(results[4].speedup == Approx(1.5));
+    REQUIRE(results[4].efficiency == Approx(0.75));
+    REQUIRE(results[5].speedup == 0);
+    REQUIRE(results[5].efficiency == 0);
+}
+
+TEST_CASE("scaling_weak", "[scaling]")
+{
+    // 0 threads, the sequential version, counts as 1
+    std::vector<Result> results = {
+        timed("w", true, 0, 1),
+        timed("w", true, 2, 1),
+        timed("w", true, 4, 1.25)};
+    compute_scaling(results);
+    REQUIRE(results[0].efficiency == Approx(1));
+    REQUIRE(results[0].speedup == Approx(1));
+    REQUIRE(results[1].efficiency == Approx(1));
+    REQUIRE(results[1].speedup == Approx(2));
+    REQUIRE(results[2].efficiency == Approx(0.8));
+    REQUIRE(results[2].speedup == Approx(3.2));
+}
+
+TEST_CASE("scaling_output", "[scaling]")
+{
+    std::vector<Result> results = {timed("a \"quoted\" \\job", false, 1, 2)};
+    results[0].values.emplace_back("tab\tkey", 3);
+    compute_scaling(results);
+
+    const auto json_path = temp_path("wmtk_scaling.json");
+    write_json(json_path, results);
+    const auto json = read_file(json_path);
+    REQUIRE(json.find("\"job\": \"a \\\"quoted\\\" \\\\job\"") != std::string::npos);
+    REQUIRE(json.find("\"tab\\u0009key\": 3") != std::string::npos);
+    REQUIRE(json.find("\"total_time\": 2") != std::string::npos);
+    REQUIRE(json.find('\t') == std::string::npos);
+
+    const auto csv_path = temp_path("wmtk_scaling.csv");
+    write_csv(csv_path, results);
+    std::istringstream csv(read_file(csv_path));
+    std::string header, row;
+    std::getline(csv, header);
+    std::getline(csv, row);
+    REQUIRE(header == "job,scaling,threads,runs,speedup,efficiency,total_time,tab\tkey");
+    REQUIRE(row == "a \"quoted\" \\job,strong,1,1,1,1,2,3");
+
+    std::filesystem::remove(json_path);
+    std::filesystem::remove(csv_path);
+}
@@ -1,6 +1,7 @@
 #include <sec/ShortestEdgeCollapse.h>
 
 #include <wmtk/utils/ManifoldUtils.hpp>
+#include <wmtk/utils/RunReport.hpp>
 
 #include <CLI/CLI.hpp>
 
@@ -31,13 +32,21 @@ void run_shortest_collapse(
     wmtk::logger().info("target number of verts: {}", target);
     assert(m.check_mesh_connectivity_validity());
     wmtk::logger().info("mesh is valid");
-    m.collapse_shortest(target);
+    {
+        wmtk::ScopedPhase phase("collapse");
+        m.collapse_shortest(target);
+    }
+    m.memory_report().log("after collapse");
     wmtk::logger().info("collapsed");
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(stop - start);
     wmtk::logger().info("runtime {}", duration.count());
     m.consolidate_mesh();
-    m.write_triangle_mesh(output);
+    wmtk::RunReport::global().stop_total();
+    {
+        wmtk::ScopedPhase phase("output");
+        m.write_triangle_mesh(output);
+    }
     wmtk::logger().info(
         "After_vertices#: {} \n After_tris#: {}",
         m.vert_capacity(),
@@ -50,6 +59,7 @@ int main(int argc, char** argv)
     double env_rel = -1;
     double target_pec = 0.1;
     int thread = 1;
+    std::string report_path;
 
     CLI::App app{argv[0]};
     app.add_option("input", path, "Input mesh.")->check(CLI::ExistingFile);
@@ -58,8 +68,11 @@ int main(int argc, char** argv)
     app.add_option("-e,--envelope", env_rel, "Relative envelope size, negative to disable");
     app.add_option("-j, --thread", thread, "thread.");
     app.add_option("-t, --target", target_pec, "Percentage of input vertices in output.");
+    app.add_option("--report", report_path, "file of the phase times and results of the run");
     CLI11_PARSE(app, argc, argv);
 
+    igl::Timer input_timer;
+    input_timer.start();
     Eigen::MatrixXd V;
     Eigen::MatrixXi F;
     bool ok = igl::read_triangle_mesh(path, V, F);
@@ -94,7 +107,9 @@ int main(int argc, char** argv)
         auto tri1 = tri;
         wmtk::separate_to_manifold(v1, tri1, v, tri, modified_v);
     }
+    wmtk::RunReport::global().add_time("input", input_timer.getElapsedTimeInSec());
 
+    wmtk::RunReport::global().start_total();
     ShortestEdgeCollapse m(v, thread);
     m.create_mesh(v.size(), tri, modified_v, envelope_size);
     assert(m.check_mesh_connectivity_validity());
@@ -106,5 +121,13 @@ int main(int argc, char** argv)
     timer.stop();
     logger().info("Took {}", timer.getElapsedTimeInSec());
     m.consolidate_mesh();
+
+    if (!report_path.empty()) {
+        auto& report = wmtk::RunReport::global();
+        report.set("vertices", m.vert_capacity());
+        report.set("faces", m.tri_capacity());
+        wmtk::report_edge_length_valence(m, [&m](size_t i) { return m.vertex_attrs[i].pos; });
+        report.write(report_path);
+    }
     return 0;
 }
@@ -78,13 +78,12 @@ void ShortestEdgeCollapse::partition_mesh()
 bool ShortestEdgeCollapse::invariants(const std::vector<Tuple>& new_tris)
 {
     if (m_has_envelope) {
-        for (auto& t : new_tris) {
-            std::array<Eigen::Vector3d, 3> tris;
-            auto vs = oriented_tri_vertices(t);
-            for (auto j = 0; j < 3; j++) tris[j] = vertex_attrs[vs[j].vid(*this)].pos;
-            bool outside = m_envelope.is_outside(tris);
-            if (outside) return false;
+        std::vector<std::array<Eigen::Vector3d, 3>> tris(new_tris.size());
+        for (auto i = 0; i < new_tris.size(); i++) {
+            auto vs = oriented_tri_vertices(new_tris[i]);
+            for (auto j = 0; j < 3; j++) tris[i][j] = vertex_attrs[vs[j].vid(*this)].pos;
         }
+        if (m_envelope.any_outside(tris)) return false;
     }
     return true;
 }
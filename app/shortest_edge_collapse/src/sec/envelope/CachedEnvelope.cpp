@@ -0,0 +1,258 @@
+#include "CachedEnvelope.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace wmtk {
+
+namespace {
+uint64_t bits(double d)
+{
+    uint64_t b;
+    std::memcpy(&b, &d, sizeof(double));
+    return b;
+}
+
+std::array<uint64_t, 9> make_key(const std::array<Eigen::Vector3d, 3>& tris)
+{
+    std::array<uint64_t, 9> key;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) key[i * 3 + j] = bits(tris[i][j]);
+    return key;
+}
+
+std::array<uint64_t, 9> make_key(const Eigen::Vector3d& pts)
+{
+    std::array<uint64_t, 9> key = {};
+    for (int j = 0; j < 3; j++) key[j] = bits(pts[j]);
+    return key;
+}
+} // namespace
+
+size_t CachedEnvelope::KeyHash::operator()(const Key& k) const
+{
+    // boost::hash_combine with a 64 bit mixer
+    uint64_t h = 0;
+    for (auto b : k) {
+        b *= 0x9E3779B97F4A7C15ull;
+        b ^= b >> 32;
+        h ^= b + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    }
+    return static_cast<size_t>(h);
+}
+
+size_t CachedEnvelope::LruCache::find_slot(const Key& key, size_t hash) const
+{
+    const size_t mask = m_table.size() - 1;
+    size_t slot = hash & mask;
+    while (m_table[slot] != kNone && m_entries[m_table[slot]].key != key) slot = (slot + 1) & mask;
+    return slot;
+}
+
+void CachedEnvelope::LruCache::erase_slot(size_t slot)
+{
+    // backward shift: move up the entries whose probe sequence went through the freed slot
+    const size_t mask = m_table.size() - 1;
+    for (size_t next = (slot + 1) & mask; m_table[next] != kNone; next = (next + 1) & mask) {
+        const size_t home = m_entries[m_table[next]].hash & mask;
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            m_table[slot] = m_table[next];
+            slot = next;
+        }
+    }
+    m_table[slot] = kNone;
+}
+
+void CachedEnvelope::LruCache::unlink(uint32_t e)
+{
+    auto& entry = m_entries[e];
+    (entry.prev == kNone ? m_head : m_entries[entry.prev].next) = entry.next;
+    (entry.next == kNone ? m_tail : m_entries[entry.next].prev) = entry.prev;
+}
+
+void CachedEnvelope::LruCache::push_front(uint32_t e)
+{
+    m_entries[e].prev = kNone;
+    m_entries[e].next = m_head;
+    (m_head == kNone ? m_tail : m_entries[m_head].prev) = e;
+    m_head = e;
+}
+
+const bool* CachedEnvelope::LruCache::find(const Key& key)
+{
+    if (m_entries.empty()) return nullptr;
+    const uint32_t e = m_table[find_slot(key, KeyHash()(key))];
+    if (e == kNone) return nullptr;
+    if (e != m_head) {
+        unlink(e);
+        push_front(e);
+    }
+    return &m_entries[e].value;
+}
+
+void CachedEnvelope::LruCache::insert(const Key& key, bool value, size_t capacity)
+{
+    if (find(key)) return; // repeated in a batch, same answer
+    if (m_table.empty()) {
+        size_t table_size = 2;
+        while (table_size < 2 * capacity) table_size *= 2;
+        m_table.assign(table_size, kNone);
+        m_entries.reserve(capacity);
+    }
+
+    uint32_t e;
+    if (m_entries.size() < capacity) {
+        e = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+    } else { // evict the least recently used entry
+        e = m_tail;
+        erase_slot(find_slot(m_entries[e].key, m_entries[e].hash));
+        unlink(e);
+    }
+    auto& entry = m_entries[e];
+    entry.key = key;
+    entry.hash = KeyHash()(key);
+    entry.value = value;
+    m_table[find_slot(key, entry.hash)] = e;
+    push_front(e);
+}
+
+void CachedEnvelope::LruCache::clear()
+{
+    m_entries.clear(); // keeps the capacity
+    std::fill(m_table.begin(), m_table.end(), kNone);
+    m_head = m_tail = kNone;
+}
+
+CachedEnvelope::CachedEnvelope(Envelope& envelope, size_t capacity)
+    : m_envelope(envelope)
+    , m_capacity(capacity)
+    , m_enabled(capacity > 0)
+{}
+
+void CachedEnvelope::init(
+    const std::vector<Eigen::Vector3d>& m_ver,
+    const std::vector<Eigen::Vector3i>& m_faces,
+    const double eps)
+{
+    clear();
+    m_envelope.init(m_ver, m_faces, eps);
+}
+
+template <typename Query>
+bool CachedEnvelope::lookup(LruCache ThreadCache::*cache, const Key& key, Query&& query)
+{
+    auto& local = m_caches.local();
+    if (const bool* res = (local.*cache).find(key)) {
+        local.stats.hits++;
+        return *res;
+    }
+    local.stats.misses++;
+    const bool res = query();
+    (local.*cache).insert(key, res, m_capacity);
+    return res;
+}
+
+bool CachedEnvelope::is_outside(const std::array<Eigen::Vector3d, 3>& tris)
+{
+    if (!m_enabled) return m_envelope.is_outside(tris);
+    return lookup(&ThreadCache::triangles, make_key(tris), [&]() {
+        return m_envelope.is_outside(tris);
+    });
+}
+
+bool CachedEnvelope::is_outside(const Eigen::Vector3d& pts)
+{
+    if (!m_enabled) return m_envelope.is_outside(pts);
+    return lookup(&ThreadCache::points, make_key(pts), [&]() {
+        return m_envelope.is_outside(pts);
+    });
+}
+
+template <typename T>
+std::vector<bool> CachedEnvelope::lookup_batch(
+    LruCache ThreadCache::*cache,
+    const std::vector<T>& queries)
+{
+    auto& local = m_caches.local();
+    std::vector<bool> result(queries.size());
+    std::vector<size_t> miss_ids;
+    std::vector<T> misses;
+    for (size_t i = 0; i < queries.size(); i++) {
+        if (const bool* res = (local.*cache).find(make_key(queries[i]))) {
+            result[i] = *res;
+            continue;
+        }
+        miss_ids.push_back(i);
+        misses.push_back(queries[i]);
+    }
+    local.stats.hits += queries.size() - misses.size();
+    local.stats.misses += misses.size();
+    if (misses.empty()) return result;
+
+    const auto answers = m_envelope.is_outside_batch(misses);
+    for (size_t k = 0; k < misses.size(); k++) {
+        result[miss_ids[k]] = answers[k];
+        (local.*cache).insert(make_key(misses[k]), answers[k], m_capacity);
+    }
+    return result;
+}
+
+std::vector<bool> CachedEnvelope::is_outside_batch(
+    const std::vector<std::array<Eigen::Vector3d, 3>>& tris)
+{
+    if (!m_enabled) return m_envelope.is_outside_batch(tris);
+    return lookup_batch(&ThreadCache::triangles, tris);
+}
+
+std::vector<bool> CachedEnvelope::is_outside_batch(const std::vector<Eigen::Vector3d>& pts)
+{
+    if (!m_enabled) return m_envelope.is_outside_batch(pts);
+    return lookup_batch(&ThreadCache::points, pts);
+}
+
+bool CachedEnvelope::any_outside(const std::vector<std::array<Eigen::Vector3d, 3>>& tris)
+{
+    if (!m_enabled) return m_envelope.any_outside(tris);
+    auto& local = m_caches.local();
+    std::vector<std::array<Eigen::Vector3d, 3>> misses;
+    for (const auto& tri : tris) {
+        if (const bool* res = local.triangles.find(make_key(tri))) {
+            local.stats.hits++;
+            if (*res) return true;
+            continue;
+        }
+        misses.push_back(tri);
+    }
+    local.stats.misses += misses.size();
+    if (misses.empty()) return false;
+
+    if (m_envelope.any_outside(misses)) return true;
+    for (const auto& tri : misses) local.triangles.insert(make_key(tri), false, m_capacity);
+    return false;
+}
+
+CachedEnvelope::Stats CachedEnvelope::stats() const
+{
+    Stats total;
+    for (const auto& local : m_caches) {
+        total.hits += local.stats.hits;
+        total.misses += local.stats.misses;
+    }
+    return total;
+}
+
+void CachedEnvelope::reset_stats()
+{
+    for (auto& local : m_caches) local.stats = Stats();
+}
+
+void CachedEnvelope::clear()
+{
+    for (auto& local : m_caches) {
+        local.triangles.clear();
+        local.points.clear();
+    }
+}
+
+} // namespace wmtk
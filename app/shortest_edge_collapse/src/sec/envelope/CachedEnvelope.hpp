@@ -0,0 +1,132 @@
+#pragma once
+
+#include "SampleEnvelope.hpp"
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief Envelope that remembers the answers of another one.
+ *
+ * The same triangles and points are queried many times (by the collapse and smoothing checks,
+ * by check_attributes and again when an operation is retried), so every thread keeps a small
+ * LRU cache of is_outside results keyed by the exact bits of the query coordinates. Cached
+ * answers are therefore always identical to the wrapped envelope's, and no locking is needed.
+ *
+ * It is an Envelope itself and can be passed wherever a wmtk::Envelope& is expected. init() is
+ * forwarded and clears the caches.
+ */
+class CachedEnvelope : public Envelope
+{
+public:
+    struct Stats
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        double hit_rate() const
+        {
+            return hits + misses == 0 ? 0. : double(hits) / double(hits + misses);
+        }
+    };
+
+    /**
+     * @param envelope the envelope answering the cache misses, must outlive this object
+     * @param capacity number of triangles (and of points) remembered per thread, 0 disables the
+     * cache
+     */
+    explicit CachedEnvelope(Envelope& envelope, size_t capacity = 4096);
+
+    void init(
+        const std::vector<Eigen::Vector3d>& m_ver,
+        const std::vector<Eigen::Vector3i>& m_faces,
+        const double eps) override;
+    bool is_outside(const std::array<Eigen::Vector3d, 3>& tris) override;
+    bool is_outside(const Eigen::Vector3d& pts) override;
+    /// the misses are sent to the wrapped envelope as one batch
+    std::vector<bool> is_outside_batch(
+        const std::vector<std::array<Eigen::Vector3d, 3>>& tris) override;
+    std::vector<bool> is_outside_batch(const std::vector<Eigen::Vector3d>& pts) override;
+    /**
+     * A cached triangle outside answers at once, the misses go to the wrapped envelope's
+     * any_outside. They are all cached as inside if it finds none outside.
+     */
+    bool any_outside(const std::vector<std::array<Eigen::Vector3d, 3>>& tris) override;
+
+    /// turn the cache on or off for this run, when off every query goes to the wrapped envelope
+    void set_enabled(bool enabled) { m_enabled = enabled && m_capacity > 0; }
+    bool enabled() const { return m_enabled; }
+
+    /// hit and miss counts summed over all threads, not thread safe with concurrent queries
+    Stats stats() const;
+    void reset_stats();
+    /// drops all cached results, e.g. if the wrapped envelope changed
+    void clear();
+
+private:
+    using Key = std::array<uint64_t, 9>;
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const;
+    };
+
+    /**
+     * One per thread, points use the first three entries of the key. The entries are allocated
+     * for the whole capacity on the first insertion and recycled from the least recently used
+     * one, so a miss allocates nothing. They are linked by index in order of use and found
+     * through an open addressing table of entry indices, at most half full.
+     */
+    class LruCache
+    {
+    public:
+        // nullptr on miss
+        const bool* find(const Key& key);
+        void insert(const Key& key, bool value, size_t capacity);
+        void clear();
+
+    private:
+        static constexpr uint32_t kNone = ~uint32_t(0);
+        struct Entry
+        {
+            Key key;
+            size_t hash;
+            uint32_t prev;
+            uint32_t next;
+            bool value;
+        };
+
+        // slot of key in the table, or the empty slot where its probe sequence ends
+        size_t find_slot(const Key& key, size_t hash) const;
+        void erase_slot(size_t slot);
+        void unlink(uint32_t e);
+        void push_front(uint32_t e);
+
+        std::vector<Entry> m_entries;
+        std::vector<uint32_t> m_table; // entry indices, kNone if empty
+        uint32_t m_head = kNone; // most recent
+        uint32_t m_tail = kNone; // least recent
+    };
+
+    struct ThreadCache
+    {
+        LruCache triangles;
+        LruCache points;
+        Stats stats;
+    };
+
+    template <typename Query>
+    bool lookup(LruCache ThreadCache::*cache, const Key& key, Query&& query);
+    template <typename T>
+    std::vector<bool> lookup_batch(LruCache ThreadCache::*cache, const std::vector<T>& queries);
+
+    Envelope& m_envelope;
+    size_t m_capacity;
+    bool m_enabled;
+    tbb::enumerable_thread_specific<ThreadCache> m_caches;
+};
+
+} // namespace wmtk
@@ -1,51 +1,30 @@
 #include "SampleEnvelope.hpp"
-#include "mesh_AABB.h"
 
-#include <geogram/basic/attributes.h>
-#include <geogram/basic/command_line.h>
-#include <geogram/basic/geometry_nd.h>
-#include <geogram/mesh/mesh_geometry.h>
+#include <geogram/basic/geometry.h>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/MortonOrder.hpp>
 
-void to_geogram_mesh(
-    const std::vector<Eigen::Vector3d>& V,
-    const std::vector<Eigen::Vector3i>& F,
-    GEO::Mesh& M)
-{
-    static std::once_flag once_flag;
-    std::call_once(once_flag, []() { GEO::initialize(); });
-    
-    M.clear();
-    // Setup vertices
-    M.vertices.create_vertices((int)V.size());
-    for (int i = 0; i < (int)M.vertices.nb(); ++i) {
-        GEO::vec3& p = M.vertices.point(i);
-        p[0] = V[i][0];
-        p[1] = V[i][1];
-        p[2] = V[i][2];
-    }
-    {
-        GEO::Attribute<int> indices(M.vertices.attributes(), "vertex_id");
-        for (int i = 0; i < V.size(); i++) indices[i] = i;
-    }
-
-    M.facets.create_triangles((int)F.size());
-    // Setup faces
-    for (int i = 0; i < F.size(); i++)
-        for (int j = 0; j < 3; j++) M.facets.set_vertex(i, j, F[i][j]);
-    M.facets.connect();
-    GEO::Attribute<int> indices(M.facets.attributes(), "facet_id");
-    for (int i = 0; i < F.size(); i++) indices[i] = i;
-}
+#include <algorithm>
+#include <limits>
 
 namespace sample_envelope {
 
+namespace {
+// stores the samples as Eigen points, which is what the BVH takes
+struct SampleList
+{
+    std::vector<Eigen::Vector3d>& points;
+    void push_back(const GEO::vec3& v) { points.emplace_back(v[0], v[1], v[2]); }
+};
+} // namespace
+
 // From TetWild
 void sampleTriangle(
     const std::array<GEO::vec3, 3>& vs,
-    std::vector<GEO::vec3>& ps,
+    std::vector<Eigen::Vector3d>& samples,
     const double sampling_dist)
 {
+    SampleList ps{samples};
     double sqrt3_2 = std::sqrt(3) / 2;
 
     std::array<double, 3> ls;
@@ -128,26 +107,6 @@ void sampleTriangle(
 }
 
 
-inline void get_point_facet_nearest_point(
-    const GEO::Mesh& M,
-    const GEO::vec3& p,
-    GEO::index_t f,
-    GEO::vec3& nearest_p,
-    double& squared_dist)
-{
-    using namespace GEO;
-    geo_debug_assert(M.facets.nb_vertices(f) == 3);
-    index_t c = M.facets.corners_begin(f);
-    const vec3& p1 = Geom::mesh_vertex(M, M.facet_corners.vertex(c));
-    ++c;
-    const vec3& p2 = Geom::mesh_vertex(M, M.facet_corners.vertex(c));
-    ++c;
-    const vec3& p3 = Geom::mesh_vertex(M, M.facet_corners.vertex(c));
-    double lambda1, lambda2, lambda3; // barycentric coords, not used.
-    squared_dist =
-        Geom::point_triangle_squared_distance(p, p1, p2, p3, nearest_p, lambda1, lambda2, lambda3);
-}
-
 void SampleEnvelope::init(
     const std::vector<Eigen::Vector3d>& V,
     const std::vector<Eigen::Vector3i>& F,
@@ -157,35 +116,35 @@ void SampleEnvelope::init(
 
     eps2 = _eps * _eps;
     sampling_dist = std::sqrt(eps2);
+    bvh.init(V, F);
+    m_contexts.clear(); // the hints refer to the old tree
+}
 
-    geo_polyhedron_ptr_ = std::make_unique<GEO::Mesh>();
-    to_geogram_mesh(V, F, *geo_polyhedron_ptr_);
-    geo_tree_ptr_ = std::make_unique<GEO::MeshFacetsAABBWithEps>(*geo_polyhedron_ptr_, true);
-
-    geo_vertex_ind.resize(V.size());
-    GEO::Attribute<int> original_indices(geo_polyhedron_ptr_->vertices.attributes(), "vertex_id");
-    for (int i = 0; i < original_indices.size(); i++) geo_vertex_ind[i] = original_indices[i];
+bool SampleEnvelope::is_outside(const Eigen::Vector3d& pts)
+{
+    return is_outside(pts, m_contexts.local());
+}
 
-    geo_face_ind.resize(F.size());
-    GEO::Attribute<int> face_indices(geo_polyhedron_ptr_->facets.attributes(), "facet_id");
-    for (int i = 0; i < face_indices.size(); i++) geo_face_ind[i] = face_indices[i];
+bool SampleEnvelope::is_outside(const std::array<Eigen::Vector3d, 3>& tri)
+{
+    return is_outside(tri, m_contexts.local());
 }
 
-bool SampleEnvelope::is_outside(const Eigen::Vector3d& pts)
+bool SampleEnvelope::is_outside(const Eigen::Vector3d& pts, QueryContext& context) const
 {
     if (use_exact) return exact_envelope.is_outside(pts);
-    auto dist2 = geo_tree_ptr_->squared_distance(GEO::vec3(pts[0], pts[1], pts[2]));
-    return (dist2 > eps2);
+    return !bvh.is_within(pts, eps2, context.hint);
 }
 
-bool SampleEnvelope::is_outside(const std::array<Eigen::Vector3d, 3>& tri)
+bool SampleEnvelope::is_outside(const std::array<Eigen::Vector3d, 3>& tri, QueryContext& context)
+    const
 {
     if (use_exact) return exact_envelope.is_outside(tri);
     std::array<GEO::vec3, 3> vs = {
         {GEO::vec3(tri[0][0], tri[0][1], tri[0][2]),
          GEO::vec3(tri[1][0], tri[1][1], tri[1][2]),
          GEO::vec3(tri[2][0], tri[2][1], tri[2][2])}};
-    static thread_local std::vector<GEO::vec3> ps;
+    auto& ps = context.samples;
     ps.clear();
 
 
@@ -194,32 +153,12 @@ bool SampleEnvelope::is_outside(const std::array<Eigen::Vector3d, 3>& tri)
     size_t num_queries = 0;
     size_t num_samples = ps.size();
 
-    GEO::vec3 nearest_point;
-    double sq_dist = std::numeric_limits<double>::max();
-    GEO::index_t prev_facet = GEO::NO_FACET;
     int cnt = 0;
     const unsigned int ps_size = ps.size();
     for (unsigned int i = ps_size / 2; i < ps.size();
          i = (i + 1) % ps_size) { // check from the middle
-        GEO::vec3& current_point = ps[i];
-        if (prev_facet != GEO::NO_FACET) {
-            get_point_facet_nearest_point(
-                *geo_polyhedron_ptr_,
-                current_point,
-                prev_facet,
-                nearest_point,
-                sq_dist);
-        }
-        if (sq_dist > eps2) {
-            geo_tree_ptr_->facet_in_envelope_with_hint(
-                current_point,
-                eps2,
-                prev_facet,
-                nearest_point,
-                sq_dist);
-        }
         ++num_queries;
-        if (sq_dist > eps2) {
+        if (!bvh.is_within(ps[i], eps2, context.hint)) {
             wmtk::logger().trace("num_queries {} / {}", num_queries, num_samples);
             return true;
         }
@@ -232,5 +171,55 @@ bool SampleEnvelope::is_outside(const std::array<Eigen::Vector3d, 3>& tri)
     return false;
 }
 
+namespace {
+std::vector<uint32_t> centroid_order(const std::vector<std::array<Eigen::Vector3d, 3>>& tris)
+{
+    std::vector<Eigen::Vector3d> centroids(tris.size());
+    for (size_t i = 0; i < tris.size(); i++) {
+        centroids[i] = (tris[i][0] + tris[i][1] + tris[i][2]) / 3;
+    }
+    return wmtk::morton_order(centroids);
+}
+} // namespace
+
+std::vector<bool> SampleEnvelope::is_outside_batch(
+    const std::vector<std::array<Eigen::Vector3d, 3>>& tris)
+{
+    std::vector<bool> result(tris.size(), false);
+    if (use_exact) {
+        for (size_t i = 0; i < tris.size(); i++) result[i] = exact_envelope.is_outside(tris[i]);
+        return result;
+    }
+    auto& context = m_contexts.local();
+    for (auto i : centroid_order(tris)) result[i] = is_outside(tris[i], context);
+    return result;
+}
+
+std::vector<bool> SampleEnvelope::is_outside_batch(const std::vector<Eigen::Vector3d>& pts)
+{
+    std::vector<bool> result(pts.size(), false);
+    if (use_exact) {
+        for (size_t i = 0; i < pts.size(); i++) result[i] = exact_envelope.is_outside(pts[i]);
+        return result;
+    }
+    auto& context = m_contexts.local();
+    for (auto i : wmtk::morton_order(pts)) result[i] = is_outside(pts[i], context);
+    return result;
+}
+
+bool SampleEnvelope::any_outside(const std::vector<std::array<Eigen::Vector3d, 3>>& tris)
+{
+    if (use_exact) {
+        for (const auto& tri : tris) {
+            if (exact_envelope.is_outside(tri)) return true;
+        }
+        return false;
+    }
+    auto& context = m_contexts.local();
+    for (auto i : centroid_order(tris)) {
+        if (is_outside(tris[i], context)) return true;
+    }
+    return false;
+}
 
 } // namespace sample_envelope
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <wmtk/utils/TriangleBVH.hpp>
+
 #include <Eigen/Core>
+#include <tbb/enumerable_thread_specific.h>
+#include <array>
 #include <memory>
+#include <vector>
 
 // clang-format off
 #include <wmtk/utils/DisableWarnings.hpp>
@@ -9,12 +14,13 @@
 #include <wmtk/utils/EnableWarnings.hpp>
 // clang-format on
 
-namespace GEO {
-class MeshFacetsAABBWithEps;
-class Mesh;
-} // namespace GEO
-
 namespace wmtk {
+/**
+ * Queries (is_outside, is_outside_batch, any_outside) may be issued concurrently from any number of threads,
+ * e.g. from the workers of a parallel ExecutePass, once init() has returned. init() must not run
+ * concurrently with queries. Implementations keep per-query state in per-thread contexts, never
+ * in shared members.
+ */
 class Envelope
 {
 public:
@@ -25,8 +31,41 @@ public:
         const double){};
     virtual bool is_outside(const std::array<Eigen::Vector3d, 3>& tris) { return false; };
     virtual bool is_outside(const Eigen::Vector3d& pts) { return false; };
+
+    /**
+     * @brief Queries many triangles at once, e.g. all the new surface faces of an operation.
+     * @return one bit per triangle, equal to is_outside(tris[i])
+     */
+    virtual std::vector<bool> is_outside_batch(
+        const std::vector<std::array<Eigen::Vector3d, 3>>& tris)
+    {
+        std::vector<bool> result(tris.size());
+        for (size_t i = 0; i < tris.size(); i++) result[i] = is_outside(tris[i]);
+        return result;
+    }
+    virtual std::vector<bool> is_outside_batch(const std::vector<Eigen::Vector3d>& pts)
+    {
+        std::vector<bool> result(pts.size());
+        for (size_t i = 0; i < pts.size(); i++) result[i] = is_outside(pts[i]);
+        return result;
+    }
+    /**
+     * @brief Whether any of the triangles is outside, e.g. to reject an operation. Stops at the
+     * first triangle found outside instead of checking them all.
+     */
+    virtual bool any_outside(const std::vector<std::array<Eigen::Vector3d, 3>>& tris)
+    {
+        for (const auto& tri : tris) {
+            if (is_outside(tri)) return true;
+        }
+        return false;
+    }
 };
 
+/**
+ * The queries of fastEnvelope::FastEnvelope are const and keep their scratch on the stack, they
+ * are only ever called through a const reference here so that this stays checked by the compiler.
+ */
 class ExactEnvelope : public Envelope, public fastEnvelope::FastEnvelope
 {
 public:
@@ -42,18 +81,28 @@ public:
     }
     bool is_outside(const std::array<Eigen::Vector3d, 3>& tris)
     {
-        return fastEnvelope::FastEnvelope::is_outside(tris);
-    }
-    bool is_outside(const Eigen::Vector3d& pts)
-    {
-        return fastEnvelope::FastEnvelope::is_outside(pts);
+        return exact().is_outside(tris);
     }
+    bool is_outside(const Eigen::Vector3d& pts) { return exact().is_outside(pts); }
+
+private:
+    const fastEnvelope::FastEnvelope& exact() const { return *this; }
 };
 } // namespace wmtk
 namespace sample_envelope {
 class SampleEnvelope : public wmtk::Envelope
 {
 public:
+    /**
+     * Scratch of the queries of one thread: the samples of the triangle being checked and the
+     * triangle of the BVH found by the previous query, which is tried first by the next one.
+     */
+    struct QueryContext
+    {
+        std::vector<Eigen::Vector3d> samples;
+        int hint = -1;
+    };
+
     SampleEnvelope(bool exact = false)
         : use_exact(exact){};
     double eps2 = 1e-6;
@@ -65,12 +114,26 @@ public:
         const double);
     bool is_outside(const std::array<Eigen::Vector3d, 3>& tris);
     bool is_outside(const Eigen::Vector3d& pts);
+    /**
+     * The triangles (or points) are visited along a Morton curve and the triangle found for the
+     * previous sample is tried first for the next one, also from one query to the next, so
+     * consecutive queries mostly stay in the same part of the tree.
+     */
+    std::vector<bool> is_outside_batch(const std::vector<std::array<Eigen::Vector3d, 3>>& tris);
+    std::vector<bool> is_outside_batch(const std::vector<Eigen::Vector3d>& pts);
+    /// Visits the triangles in the Morton order of is_outside_batch, returns at the first outside.
+    bool any_outside(const std::vector<std::array<Eigen::Vector3d, 3>>& tris);
+
+    /**
+     * Same queries with a context owned by the caller, e.g. one per task of a parallel loop.
+     * The overloads above use a context per thread.
+     */
+    bool is_outside(const std::array<Eigen::Vector3d, 3>& tris, QueryContext& context) const;
+    bool is_outside(const Eigen::Vector3d& pts, QueryContext& context) const;
 
 private:
-    std::shared_ptr<GEO::MeshFacetsAABBWithEps> geo_tree_ptr_;
-    std::shared_ptr<GEO::Mesh> geo_polyhedron_ptr_;
-    std::vector<int> geo_vertex_ind;
-    std::vector<int> geo_face_ind;
+    wmtk::TriangleBVH bvh;
+    mutable tbb::enumerable_thread_specific<QueryContext> m_contexts;
 
 private:
     fastEnvelope::FastEnvelope exact_envelope;
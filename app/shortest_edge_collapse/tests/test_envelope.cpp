@@ -0,0 +1,366 @@
+#include <sec/envelope/CachedEnvelope.hpp>
+#include <sec/envelope/SampleEnvelope.hpp>
+#include <sec/envelope/mesh_AABB.h>
+#include <wmtk/utils/TriangleBVH.hpp>
+
+#include <geogram/mesh/mesh.h>
+#include <igl/read_triangle_mesh.h>
+#include <tbb/blocked_range.h>
+#include <tbb/global_control.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+using namespace wmtk;
+
+namespace {
+// outside when any coordinate is negative, counts the queries it answers
+class CountingEnvelope : public Envelope
+{
+public:
+    bool is_outside(const std::array<Eigen::Vector3d, 3>& tris) override
+    {
+        tri_queries++;
+        for (const auto& p : tris)
+            if (p.minCoeff() < 0) return true;
+        return false;
+    }
+    bool is_outside(const Eigen::Vector3d& pts) override
+    {
+        point_queries++;
+        return pts.minCoeff() < 0;
+    }
+    std::atomic<size_t> tri_queries{0};
+    std::atomic<size_t> point_queries{0};
+};
+} // namespace
+
+TEST_CASE("cached_envelope", "[test_sec][envelope]")
+{
+    CountingEnvelope inner;
+    CachedEnvelope envelope(inner, 2);
+
+    const std::array<Eigen::Vector3d, 3> in = {
+        {Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(1, 0, 0), Eigen::Vector3d(0, 1, 0)}};
+    auto out = in;
+    out[2][2] = -1;
+
+    REQUIRE(!envelope.is_outside(in));
+    REQUIRE(!envelope.is_outside(in));
+    REQUIRE(envelope.is_outside(out));
+    REQUIRE(envelope.is_outside(out));
+    REQUIRE(inner.tri_queries == 2);
+    REQUIRE(envelope.stats().hits == 2);
+    REQUIRE(envelope.stats().misses == 2);
+
+    // points are cached separately
+    REQUIRE(!envelope.is_outside(in[1]));
+    REQUIRE(!envelope.is_outside(in[1]));
+    REQUIRE(inner.point_queries == 1);
+
+    // the least recently used triangle is evicted
+    auto third = in;
+    third[0][0] = 0.5;
+    REQUIRE(!envelope.is_outside(in));
+    REQUIRE(!envelope.is_outside(third));
+    REQUIRE(envelope.is_outside(out));
+    REQUIRE(inner.tri_queries == 4);
+    REQUIRE(!envelope.is_outside(in));
+    REQUIRE(inner.tri_queries == 5);
+
+    // keys are exact, -0 and 0 are different queries but give the same answer
+    auto negative_zero = in;
+    negative_zero[0][0] = -0.;
+    REQUIRE(!envelope.is_outside(negative_zero));
+    REQUIRE(inner.tri_queries == 6);
+
+    envelope.set_enabled(false);
+    envelope.reset_stats();
+    REQUIRE(!envelope.is_outside(in));
+    REQUIRE(inner.tri_queries == 7);
+    REQUIRE(envelope.stats().hits + envelope.stats().misses == 0);
+}
+
+TEST_CASE("cached_envelope_eviction", "[test_sec][envelope]")
+{
+    // random points against a reference LRU, enough of them to wrap around the table many times
+    const size_t capacity = 37;
+    CountingEnvelope inner;
+    CachedEnvelope envelope(inner, capacity);
+    std::vector<int> recent; // most recent first
+    size_t expected_queries = 0;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(-50, 50);
+    for (int i = 0; i < 20000; i++) {
+        const int x = dist(gen);
+        auto it = std::find(recent.begin(), recent.end(), x);
+        if (it == recent.end()) {
+            expected_queries++;
+            if (recent.size() == capacity) recent.pop_back();
+        } else {
+            recent.erase(it);
+        }
+        recent.insert(recent.begin(), x);
+        REQUIRE(envelope.is_outside(Eigen::Vector3d(x, 1, 1)) == (x < 0));
+        REQUIRE(inner.point_queries == expected_queries);
+        if (i == 10000) { // starts over, with the same capacity
+            envelope.clear();
+            recent.clear();
+        }
+    }
+}
+
+TEST_CASE("cached_envelope_parallel", "[test_sec][envelope]")
+{
+    CountingEnvelope inner;
+    CachedEnvelope envelope(inner, 64);
+
+    std::atomic<int> wrong{0};
+    tbb::parallel_for(0, 10000, [&](int i) {
+        const double x = (i % 32) - 16;
+        const std::array<Eigen::Vector3d, 3> tri = {
+            {Eigen::Vector3d(x, 0, 0), Eigen::Vector3d(1, 0, 0), Eigen::Vector3d(0, 1, 0)}};
+        if (envelope.is_outside(tri) != (x < 0)) wrong++;
+    });
+    REQUIRE(wrong == 0);
+    const auto stats = envelope.stats();
+    REQUIRE(stats.hits + stats.misses == 10000);
+    REQUIRE(stats.misses == inner.tri_queries);
+    REQUIRE(stats.hits > 0);
+}
+
+TEST_CASE("cached_envelope_batch", "[test_sec][envelope]")
+{
+    CountingEnvelope inner;
+    CachedEnvelope envelope(inner, 16);
+
+    std::vector<std::array<Eigen::Vector3d, 3>> tris;
+    for (int i = -2; i < 3; i++)
+        tris.push_back(
+            {{Eigen::Vector3d(i, 0, 0), Eigen::Vector3d(1, 0, 0), Eigen::Vector3d(0, 1, 0)}});
+    tris.push_back(tris[0]); // repeated in the same batch
+
+    auto is_out = envelope.is_outside_batch(tris);
+    REQUIRE(is_out == std::vector<bool>{true, true, false, false, false, true});
+    REQUIRE(inner.tri_queries == 6);
+
+    is_out = envelope.is_outside_batch(tris);
+    REQUIRE(is_out == std::vector<bool>{true, true, false, false, false, true});
+    REQUIRE(inner.tri_queries == 6);
+    REQUIRE(envelope.is_outside(tris[1]));
+    REQUIRE(inner.tri_queries == 6);
+
+    const std::vector<Eigen::Vector3d> pts = {Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(0, -1, 0)};
+    REQUIRE(envelope.is_outside_batch(pts) == std::vector<bool>{false, true});
+    REQUIRE(inner.point_queries == 2);
+
+    // any_outside returns at a cached triangle outside, and caches the misses found inside
+    REQUIRE(envelope.any_outside(tris));
+    REQUIRE(inner.tri_queries == 6);
+    std::vector<std::array<Eigen::Vector3d, 3>> inside;
+    for (int i = 3; i < 6; i++)
+        inside.push_back(
+            {{Eigen::Vector3d(i, 0, 0), Eigen::Vector3d(1, 0, 0), Eigen::Vector3d(0, 0, 1)}});
+    REQUIRE(!envelope.any_outside(inside));
+    REQUIRE(inner.tri_queries == 9);
+    REQUIRE(!envelope.any_outside(inside));
+    REQUIRE(inner.tri_queries == 9);
+    inside.push_back(tris[0]);
+    REQUIRE(envelope.any_outside(inside));
+    REQUIRE(inner.tri_queries == 9);
+}
+
+TEST_CASE("sample_envelope_batch", "[test_sec][envelope]")
+{
+    // a unit square made of two triangles
+    const std::vector<Eigen::Vector3d> V = {
+        Eigen::Vector3d(0, 0, 0),
+        Eigen::Vector3d(1, 0, 0),
+        Eigen::Vector3d(1, 1, 0),
+        Eigen::Vector3d(0, 1, 0)};
+    const std::vector<Eigen::Vector3i> F = {Eigen::Vector3i(0, 1, 2), Eigen::Vector3i(0, 2, 3)};
+    sample_envelope::SampleEnvelope envelope;
+    envelope.init(V, F, 0.05);
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> xy(0.1, 0.9), z(-0.08, 0.08);
+    std::vector<std::array<Eigen::Vector3d, 3>> tris(200);
+    std::vector<Eigen::Vector3d> pts;
+    for (auto& t : tris) {
+        for (auto& p : t) {
+            p = Eigen::Vector3d(xy(gen), xy(gen), z(gen));
+            pts.push_back(p);
+        }
+    }
+    const auto tri_out = envelope.is_outside_batch(tris);
+    int num_out = 0;
+    for (size_t i = 0; i < tris.size(); i++) {
+        REQUIRE(tri_out[i] == envelope.is_outside(tris[i]));
+        num_out += tri_out[i];
+    }
+    REQUIRE(num_out > 0);
+    REQUIRE(num_out < tris.size());
+    const auto pt_out = envelope.is_outside_batch(pts);
+    for (size_t i = 0; i < pts.size(); i++) REQUIRE(pt_out[i] == envelope.is_outside(pts[i]));
+
+    // the common case of accepted operations, every sample has to be checked
+    std::vector<std::array<Eigen::Vector3d, 3>> inside;
+    for (size_t i = 0; i < tris.size(); i++)
+        if (!tri_out[i]) inside.push_back(tris[i]);
+    REQUIRE(envelope.any_outside(tris));
+    REQUIRE(!envelope.any_outside(inside));
+
+    BENCHMARK("is_outside one by one")
+    {
+        int n = 0;
+        for (const auto& t : tris) n += envelope.is_outside(t);
+        return n;
+    };
+    BENCHMARK("is_outside_batch")
+    {
+        return envelope.is_outside_batch(tris);
+    };
+
+    BENCHMARK("is_outside one by one, inside")
+    {
+        int n = 0;
+        for (const auto& t : inside) n += envelope.is_outside(t);
+        return n;
+    };
+    BENCHMARK("is_outside_batch, inside")
+    {
+        return envelope.is_outside_batch(inside);
+    };
+}
+
+TEST_CASE("sample_envelope_concurrent", "[test_sec][envelope]")
+{
+    // a bumpy grid, so that the answers depend on where the query is
+    const int n = 30;
+    std::vector<Eigen::Vector3d> V;
+    std::vector<Eigen::Vector3i> F;
+    for (int i = 0; i <= n; i++)
+        for (int j = 0; j <= n; j++)
+            V.emplace_back(double(i) / n, double(j) / n, 0.05 * std::sin(6. * i / n + 4. * j / n));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            const int v = i * (n + 1) + j;
+            F.emplace_back(v, v + n + 1, v + 1);
+            F.emplace_back(v + 1, v + n + 1, v + n + 2);
+        }
+    }
+    sample_envelope::SampleEnvelope envelope;
+    envelope.init(V, F, 0.02);
+
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> xy(0, 1), z(-0.08, 0.08), offset(-0.05, 0.05);
+    std::vector<std::array<Eigen::Vector3d, 3>> tris(4000);
+    for (auto& t : tris) {
+        t[0] = Eigen::Vector3d(xy(gen), xy(gen), z(gen));
+        for (int j = 1; j < 3; j++)
+            t[j] = t[0] + Eigen::Vector3d(offset(gen), offset(gen), 0.2 * offset(gen));
+    }
+
+    // answers of a single thread with a fresh context
+    std::vector<bool> expected(tris.size()), expected_point(tris.size());
+    for (size_t i = 0; i < tris.size(); i++) {
+        sample_envelope::SampleEnvelope::QueryContext context;
+        expected[i] = envelope.is_outside(tris[i], context);
+        expected_point[i] = envelope.is_outside(tris[i][0], context);
+    }
+    const auto num_out = std::count(expected.begin(), expected.end(), true);
+    REQUIRE(num_out > 0);
+    REQUIRE(num_out < tris.size());
+
+    CachedEnvelope cached(envelope, 256);
+    std::atomic<int> wrong{0};
+    // every kind of query at once
+    auto queries = [&](const tbb::blocked_range<size_t>& r) {
+        sample_envelope::SampleEnvelope::QueryContext context;
+        std::vector<std::array<Eigen::Vector3d, 3>> batch;
+        for (size_t i = r.begin(); i < r.end(); i++) {
+            if (envelope.is_outside(tris[i]) != expected[i]) wrong++;
+            if (envelope.is_outside(tris[i][0]) != expected_point[i]) wrong++;
+            if (envelope.is_outside(tris[i], context) != expected[i]) wrong++;
+            if (cached.is_outside(tris[i]) != expected[i]) wrong++;
+            batch.push_back(tris[i]);
+        }
+        const auto is_out = envelope.is_outside_batch(batch);
+        for (size_t i = r.begin(); i < r.end(); i++)
+            if (is_out[i - r.begin()] != expected[i]) wrong++;
+    };
+    // more threads than cores, so that the queries interleave also on small machines
+    tbb::global_control threads(tbb::global_control::max_allowed_parallelism, 8);
+    tbb::task_arena arena(8);
+    for (int round = 0; round < 4; round++) {
+        arena.execute(
+            [&] { tbb::parallel_for(tbb::blocked_range<size_t>(0, tris.size(), 16), queries); });
+    }
+    REQUIRE(wrong == 0);
+}
+
+TEST_CASE("bvh_vs_geogram_tree", "[test_sec][envelope][.benchmark]")
+{
+    Eigen::MatrixXd inV;
+    Eigen::MatrixXi inF;
+    igl::read_triangle_mesh(WMT_DATA_DIR "/37322.stl", inV, inF);
+    std::vector<Eigen::Vector3d> V(inV.rows());
+    std::vector<Eigen::Vector3i> F(inF.rows());
+    for (int i = 0; i < inV.rows(); i++) V[i] = inV.row(i);
+    for (int i = 0; i < inF.rows(); i++) F[i] = inF.row(i);
+    const double diag = (inV.colwise().maxCoeff() - inV.colwise().minCoeff()).norm();
+    const double eps2 = std::pow(1e-3 * diag, 2);
+
+    GEO::initialize();
+    GEO::Mesh M;
+    M.vertices.create_vertices(V.size());
+    for (size_t i = 0; i < V.size(); i++)
+        for (int j = 0; j < 3; j++) M.vertices.point(i)[j] = V[i][j];
+    M.facets.create_triangles(F.size());
+    for (size_t i = 0; i < F.size(); i++)
+        for (int j = 0; j < 3; j++) M.facets.set_vertex(i, j, F[i][j]);
+    GEO::MeshFacetsAABBWithEps geo_tree(M, true);
+    TriangleBVH bvh(V, F);
+
+    // points around the surface, about half of them within eps
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> vertex(0, V.size() - 1);
+    std::normal_distribution<double> offset(0, 1.5e-3 * diag);
+    std::vector<Eigen::Vector3d> pts(100000);
+    for (auto& p : pts) p = V[vertex(gen)] + Eigen::Vector3d(offset(gen), offset(gen), offset(gen));
+
+    auto geo_within = [&](const Eigen::Vector3d& p) {
+        GEO::vec3 nearest;
+        double sq_dist;
+        geo_tree.facet_in_envelope(GEO::vec3(p[0], p[1], p[2]), eps2, nearest, sq_dist);
+        return sq_dist <= eps2;
+    };
+    for (size_t i = 0; i < 1000; i++) REQUIRE(bvh.is_within(pts[i], eps2) == geo_within(pts[i]));
+
+    BENCHMARK("geogram tree build")
+    {
+        GEO::Mesh copy;
+        copy.copy(M);
+        return GEO::MeshFacetsAABBWithEps(copy, true).squared_distance(GEO::vec3(0, 0, 0));
+    };
+    BENCHMARK("TriangleBVH build")
+    {
+        return TriangleBVH(V, F).num_nodes();
+    };
+    BENCHMARK("geogram tree facet_in_envelope")
+    {
+        int n = 0;
+        for (const auto& p : pts) n += geo_within(p);
+        return n;
+    };
+    BENCHMARK("TriangleBVH is_within")
+    {
+        int n = 0;
+        for (const auto& p : pts) n += bvh.is_within(p, eps2);
+        return n;
+    };
+}
@@ -25,10 +25,7 @@ TEST_CASE("tetwild_file_write", "[tetwild_operation]")
     vertices[3].m_posf = Vector3d(0, 0, 1);
     std::vector<std::array<size_t, 4>> tets = {{{0, 1, 2, 3}}};
     std::vector<TetAttributes> tet_attrs(1);
-    for (auto& v : vertices) {
-        v.m_is_rounded = true;
-        v.m_pos = tetwild::to_rational(v.m_posf);
-    }
+    for (auto& v : vertices) v.m_is_rounded = true;
 
     tetwild.init(vertices.size(), tets);
     tetwild.create_mesh_attributes(vertices, tet_attrs);
@@ -0,0 +1,124 @@
+#include <TetWild.h>
+#include <wmtk/TetMesh.h>
+
+#include <catch2/catch.hpp>
+#include "Parameters.h"
+
+#include <igl/read_triangle_mesh.h>
+#include <wmtk/utils/InsertTriangleUtils.hpp>
+
+#include <deque>
+#include <filesystem>
+
+using namespace wmtk;
+using namespace tetwild;
+
+namespace {
+struct Input
+{
+    std::vector<Vector3d> vertices;
+    std::vector<std::array<size_t, 3>> faces;
+};
+
+Input read_input()
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi F;
+    igl::read_triangle_mesh(WMT_DATA_DIR "/37322.stl", V, F);
+    Input input;
+    input.vertices.resize(V.rows());
+    input.faces.resize(F.rows());
+    for (int i = 0; i < V.rows(); i++) input.vertices[i] = V.row(i);
+    for (int i = 0; i < F.rows(); i++)
+        for (int j = 0; j < 3; j++) input.faces[i][j] = F(i, j);
+    return input;
+}
+
+std::string checkpoint_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// same connectivity, vertex positions and attributes
+void require_same_mesh(TetWild& a, TetWild& b)
+{
+    REQUIRE(a.vert_capacity() == b.vert_capacity());
+    REQUIRE(a.tet_capacity() == b.tet_capacity());
+    for (size_t v = 0; v < a.vert_capacity(); v++) {
+        REQUIRE(a.m_vertex_attribute[v].m_posf == b.m_vertex_attribute[v].m_posf);
+        REQUIRE(a.m_vertex_attribute[v].m_is_rounded == b.m_vertex_attribute[v].m_is_rounded);
+        REQUIRE(a.m_vertex_attribute[v].on_bbox_faces == b.m_vertex_attribute[v].on_bbox_faces);
+    }
+    const auto tets_a = a.get_tets();
+    const auto tets_b = b.get_tets();
+    REQUIRE(tets_a.size() == tets_b.size());
+    for (size_t t = 0; t < tets_a.size(); t++) {
+        const auto va = a.oriented_tet_vertices(tets_a[t]);
+        const auto vb = b.oriented_tet_vertices(tets_b[t]);
+        for (int j = 0; j < 4; j++) REQUIRE(va[j].vid(a) == vb[j].vid(b));
+        REQUIRE(
+            a.m_tet_attribute[tets_a[t].tid(a)].m_quality ==
+            b.m_tet_attribute[tets_b[t].tid(b)].m_quality);
+    }
+}
+
+void require_same_state(const TetWild::ImprovementState& a, const TetWild::ImprovementState& b)
+{
+    REQUIRE(a.it == b.it);
+    REQUIRE(a.m == b.m);
+    REQUIRE(a.pre_max_energy == b.pre_max_energy);
+    REQUIRE(a.pre_avg_energy == b.pre_avg_energy);
+    REQUIRE(a.is_hit_min_edge_length == b.is_hit_min_edge_length);
+}
+} // namespace
+
+TEST_CASE("checkpoint_resume", "[tetwild_operation]")
+{
+    // a single thread, so that the runs are deterministic
+    const int k = 1, max_its = 3;
+    auto input = read_input();
+    Parameters params;
+    params.lr = 1 / 10.;
+    params.checkpoint_interval = 0; // after every iteration
+    params.init(input.vertices, input.faces);
+    wmtk::Envelope envelope;
+    wmtk::remove_duplicates(input.vertices, input.faces, params.diag_l);
+    const std::vector<size_t> partition_id(input.vertices.size(), 0);
+    std::deque<Parameters> mesh_params; // a TetWild keeps a reference to its parameters
+    const auto make_mesh = [&](const std::string& checkpoint) {
+        auto& p = mesh_params.emplace_back(params);
+        p.checkpoint_path = checkpoint;
+        auto mesh = std::make_unique<TetWild>(p, envelope, 1);
+        mesh->init_from_input_surface(input.vertices, input.faces, partition_id);
+        return mesh;
+    };
+
+    // uninterrupted, its last checkpoint holds the state after max_its iterations
+    const auto full_path = checkpoint_path("wmtk_checkpoint_full.snapshot");
+    auto full = make_mesh(full_path);
+    full->mesh_improvement(max_its);
+
+    // stopped after k iterations, then resumed in a new mesh from the checkpoint
+    const auto resumed_path = checkpoint_path("wmtk_checkpoint_resumed.snapshot");
+    auto interrupted = make_mesh(resumed_path);
+    interrupted->mesh_improvement(k);
+    auto resumed = make_mesh("");
+    const auto state_k = resumed->load_checkpoint(resumed_path);
+    REQUIRE(state_k.it == k);
+    REQUIRE(resumed->check_attributes());
+    resumed->m_params.checkpoint_path = resumed_path;
+    resumed->mesh_improvement(max_its, state_k);
+    REQUIRE(resumed->check_attributes());
+    require_same_mesh(*full, *resumed);
+
+    // the checkpoints written at the end of both runs agree as well
+    auto full_last = make_mesh("");
+    auto resumed_last = make_mesh("");
+    const auto full_state = full_last->load_checkpoint(full_path);
+    const auto resumed_state = resumed_last->load_checkpoint(resumed_path);
+    require_same_state(full_state, resumed_state);
+    require_same_mesh(*full_last, *resumed_last);
+
+    std::filesystem::remove(full_path);
+    std::filesystem::remove(resumed_path);
+}
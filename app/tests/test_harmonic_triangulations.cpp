@@ -14,8 +14,11 @@
 
 #include <igl/Timer.h>
 #include <igl/upsample.h>
+#include <wmtk/utils/MeshSnapshot.hpp>
 #include <wmtk/utils/io.hpp>
 
+#include <filesystem>
+
 using namespace wmtk;
 
 
@@ -68,6 +71,45 @@ TEST_CASE("harmonic-tet-optim", "[harmtri]")
         E < 0.8); // Note: this may depend on the internal implementation detail of gradient descent
 }
 
+TEST_CASE("harmonic-tet-snapshot", "[harmtri]")
+{
+    auto vec_attrs = std::vector<Eigen::Vector3d>(4);
+    vec_attrs[0] = Eigen::Vector3d(0, 0, 0);
+    vec_attrs[1] = Eigen::Vector3d(1, 0, 0);
+    vec_attrs[2] = Eigen::Vector3d(0, 1, 0);
+    vec_attrs[3] = Eigen::Vector3d(0, 0, 1);
+    auto tets = std::vector<std::array<size_t, 4>>{{{0, 1, 2, 3}}};
+    auto har_tet = harmonic_tet::HarmonicTet(vec_attrs, tets);
+
+    const auto path = (std::filesystem::temp_directory_path() / "wmtk_harmonic.snap").string();
+    har_tet.output_snapshot(path);
+    {
+        auto loaded = harmonic_tet::HarmonicTet(wmtk::MeshSnapshot(path));
+        REQUIRE(loaded.vert_capacity() == 4);
+        for (auto i = 0; i < 4; i++) REQUIRE(loaded.vertex_attrs[i].pos == vec_attrs[i]);
+    }
+
+    // positions that are not one 3D point per vertex
+    auto write_position = [&](auto add_position) {
+        wmtk::MeshSnapshotWriter writer(har_tet);
+        add_position(writer);
+        writer.write(path);
+    };
+    write_position([&](auto& writer) {
+        writer.template add_attribute<double, 2>("position", 4, [&](size_t i) {
+            return vec_attrs[i];
+        });
+    });
+    REQUIRE_THROWS(harmonic_tet::HarmonicTet(wmtk::MeshSnapshot(path)));
+    write_position([&](auto& writer) {
+        writer.template add_attribute<double, 3>("position", 3, [&](size_t i) {
+            return vec_attrs[i];
+        });
+    });
+    REQUIRE_THROWS(harmonic_tet::HarmonicTet(wmtk::MeshSnapshot(path)));
+    std::filesystem::remove(path);
+}
+
 TEST_CASE("harmonic-tet-swaps", "[harmtri][.slow]")
 {
     auto vec_attrs = std::vector<Eigen::Vector3d>();
@@ -1,10 +1,14 @@
 #include <TetWild.h>
 #include <common.h>
 #include <wmtk/TetMesh.h>
+#include <wmtk/utils/AMIPS.h>
+#include <wmtk/utils/NewtonMethod.hpp>
 #include <catch2/catch.hpp>
 #include "spdlog/spdlog.h"
 
 #include <spdlog/fmt/ostr.h>
+#include <memory>
+#include <string>
 using namespace wmtk;
 
 TEST_CASE("smooth_in_single_tet", "[tetwild_operation]")
@@ -21,10 +25,7 @@ TEST_CASE("smooth_in_single_tet", "[tetwild_operation]")
     vertices[1].m_posf = Vector3d(1, 0, 0);
     vertices[2].m_posf = Vector3d(0, 1, 0);
     vertices[3].m_posf = Vector3d(0, 0, 1);
-    for (auto& v : vertices) {
-        v.m_is_rounded = true;
-        v.m_pos = tetwild::to_rational(v.m_posf);
-    }
+    for (auto& v : vertices) v.m_is_rounded = true;
     std::vector<std::array<size_t, 4>> tets = {{{0, 1, 2, 3}}};
     std::vector<TetAttributes> tet_attrs(1);
 
@@ -68,4 +69,57 @@ TEST_CASE("smooth_double_tet", "[tetwild_operation]")
     REQUIRE(quality == Approx(27.0));
     auto quality2 = tetwild.m_tet_attribute.m_attributes[tetwild.tet_capacity()-1].m_quality;
     REQUIRE(quality2 == Approx(27.0));
-}
\ No newline at end of file
+}
+TEST_CASE("smooth_early_exit", "[tetwild_operation]")
+{
+    // the free vertex of a single tet, Newton approaches the regular tet (AMIPS = 3) slowly
+    std::vector<std::array<double, 12>> stack = {{{0.1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1}}};
+    const auto solve = [&](double min_decrease, int& iterations) {
+        wmtk::SmoothingOptions options;
+        options.min_relative_decrease = min_decrease;
+        iterations = 0;
+        const Eigen::Vector3d pos = wmtk::newton_method<12, 3>(
+            stack,
+            wmtk::AMIPS_energy_batch,
+            wmtk::AMIPS_jacobian_batch,
+            [&](size_t n, const double* T, size_t stride, double* result) {
+                iterations++; // one Hessian per iteration
+                wmtk::AMIPS_hessian_batch(n, T, stride, result);
+            },
+            options);
+        auto T = stack[0];
+        for (int j = 0; j < 3; j++) T[j] = pos[j];
+        return wmtk::AMIPS_energy(T);
+    };
+    const double start = wmtk::AMIPS_energy(stack[0]);
+    int full_iterations, early_iterations;
+    const double full = solve(0., full_iterations);
+    const double early = solve(1e-3, early_iterations);
+    REQUIRE(early_iterations < full_iterations);
+    REQUIRE(early < start);
+    REQUIRE(early == Approx(full).epsilon(1e-3));
+
+    // on a mesh, smoothing with the early exit still never raises the max energy
+    using namespace tetwild;
+    Parameters params;
+    params.smooth_min_relative_decrease = 1e-3;
+    params.init(Vector3d(0, 0, 0), Vector3d(1, 1, 1));
+    wmtk::Envelope envelope;
+    TetWild tetwild(params, envelope);
+    std::vector<VertexAttributes> vertices(4);
+    vertices[0].m_posf = Vector3d(0.1, 0, 0);
+    vertices[1].m_posf = Vector3d(1, 0, 0);
+    vertices[2].m_posf = Vector3d(0, 1, 0);
+    vertices[3].m_posf = Vector3d(0, 0, 1);
+    for (auto& v : vertices) v.m_is_rounded = true;
+    std::vector<std::array<size_t, 4>> tets = {{{0, 1, 2, 3}}};
+    std::vector<TetAttributes> tet_attrs(1);
+    tetwild.init(vertices.size(), tets);
+    tetwild.create_mesh_attributes(vertices, tet_attrs);
+    tetwild.split_all_edges();
+
+    const double max_before = std::get<0>(tetwild.get_max_avg_energy());
+    tetwild.smooth_all_vertices();
+    REQUIRE(std::get<0>(tetwild.get_max_avg_energy()) <= max_before);
+    REQUIRE(tetwild.check_attributes());
+}
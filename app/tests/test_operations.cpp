@@ -118,7 +118,6 @@ TEST_CASE("edge_collapsing", "[tetwild_operation]")
     std::vector<TetAttributes> tet_attrs(1);
     for (auto& v : vertices) {
         v.m_is_rounded = true;
-        v.m_pos = to_rational(v.m_posf);
         // v.m_is_on_surface = true;
     }
     tetwild.m_collapse_check_link_condition = true;
@@ -160,11 +159,10 @@ TEST_CASE("inversion-check-rational-tetwild", "[tetwild_operation]")
     TetWild tetwild(params, envelope);
 
     std::vector<VertexAttributes> vertices(4);
-    vertices[0].m_pos = Vector3r(0, 0, 0);
-    vertices[1].m_pos = Vector3r(1, 0, 0);
-    vertices[2].m_pos = Vector3r(0, 1, 0);
-    vertices[3].m_pos = Vector3r(0, 0, 1);
-    for (auto& v : vertices) v.m_is_rounded = false;
+    tetwild.set_exact_pos(vertices[0], Vector3r(0, 0, 0));
+    tetwild.set_exact_pos(vertices[1], Vector3r(1, 0, 0));
+    tetwild.set_exact_pos(vertices[2], Vector3r(0, 1, 0));
+    tetwild.set_exact_pos(vertices[3], Vector3r(0, 0, 1));
     std::vector<std::array<size_t, 4>> tets = {{{0, 1, 2, 3}}};
     std::vector<TetAttributes> tet_attrs(1);
 
@@ -173,6 +171,63 @@ TEST_CASE("inversion-check-rational-tetwild", "[tetwild_operation]")
     REQUIRE_FALSE(tetwild.is_inverted(tetwild.tuple_from_tet(0)));
 }
 
+TEST_CASE("exact_positions_side_table", "[tetwild_operation]")
+{
+    Parameters params;
+    params.lr = 1 / 10.;
+    params.init(Vector3d(0, 0, 0), Vector3d(1, 1, 1));
+
+    wmtk::Envelope envelope;
+    TetWild tetwild(params, envelope);
+
+    std::vector<VertexAttributes> vertices(4);
+    vertices[0].m_posf = Vector3d(0, 0, 0);
+    vertices[1].m_posf = Vector3d(1, 0, 0);
+    vertices[2].m_posf = Vector3d(0, 1, 0);
+    vertices[3].m_posf = Vector3d(0, 0, 1);
+    for (auto& v : vertices) v.m_is_rounded = true;
+    std::vector<std::array<size_t, 4>> tets = {{{0, 1, 2, 3}}};
+    std::vector<TetAttributes> tet_attrs(1);
+    tetwild.init(vertices.size(), tets);
+    tetwild.create_mesh_attributes(vertices, tet_attrs);
+
+    const auto third = Rational(1) / 3;
+    const Vector3r p3(third, third, Rational(1));
+    tetwild.set_exact_pos(3, p3);
+    REQUIRE(tetwild.m_exact_positions.size() == 1);
+    tetwild.recycle_exact_positions(); // still used by vertex 3
+
+    // a rounding that is rolled back keeps its slot
+    auto& attrs = tetwild.m_vertex_attribute;
+    attrs.begin_protect();
+    REQUIRE(tetwild.round(tetwild.tuple_from_vertex(3)));
+    attrs.rollback();
+    REQUIRE_FALSE(attrs.at(3).m_is_rounded);
+    tetwild.recycle_exact_positions();
+    tetwild.set_exact_pos(2, Vector3r(Rational(0), Rational(2) / 3, Rational(0)));
+    REQUIRE(tetwild.m_exact_positions.size() == 2);
+    REQUIRE(attrs.at(2).m_exact_id == 1);
+    REQUIRE((tetwild.get_exact_pos(3) == p3));
+
+    // once rounded, the slot of vertex 3 is handed out again after the pass
+    REQUIRE(tetwild.round(tetwild.tuple_from_vertex(3)));
+    tetwild.recycle_exact_positions();
+    const Vector3r p1(Rational(2) / 3, Rational(0), Rational(0));
+    tetwild.set_exact_pos(1, p1);
+    REQUIRE(tetwild.m_exact_positions.size() == 2);
+    REQUIRE(attrs.at(1).m_exact_id == 0);
+    REQUIRE((tetwild.get_exact_pos(1) == p1));
+    REQUIRE((tetwild.get_exact_pos(3) == to_rational(attrs.at(3).m_posf)));
+
+    // consolidation drops the slots of the rounded vertices
+    REQUIRE(tetwild.round(tetwild.tuple_from_vertex(2)));
+    tetwild.consolidate_mesh();
+    tetwild.compact_exact_positions();
+    REQUIRE(tetwild.m_exact_positions.size() == 1);
+    REQUIRE((tetwild.get_exact_pos(1) == p1));
+    REQUIRE_FALSE(tetwild.is_inverted(tetwild.tuple_from_tet(0)));
+}
+
 TEST_CASE("optimize-bunny-tw", "[tetwild_operation][.slow]")
 {
     MshData msh;
@@ -0,0 +1,363 @@
+#include "TetWild.h"
+
+#include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/MeshSnapshot.hpp>
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <algorithm>
+#include <filesystem>
+
+namespace tetwild {
+namespace {
+
+// the numeric fields of Parameters, in the order of the "parameters" column
+std::vector<double*> parameter_fields(Parameters& p)
+{
+    return {
+        &p.epsr,
+        &p.eps,
+        &p.lr,
+        &p.l,
+        &p.l_min,
+        &p.diag_l,
+        &p.min[0],
+        &p.min[1],
+        &p.min[2],
+        &p.max[0],
+        &p.max[1],
+        &p.max[2],
+        &p.box_min[0],
+        &p.box_min[1],
+        &p.box_min[2],
+        &p.box_max[0],
+        &p.box_max[1],
+        &p.box_max[2],
+        &p.splitting_l2,
+        &p.collapsing_l2,
+        &p.stop_energy,
+        &p.smooth_min_relative_decrease,
+        &p.smooth_min_step,
+        &p.winding_number_accuracy};
+}
+
+
+/**
+ * Copy of everything a checkpoint holds, taken between two iterations so that the mesh can be
+ * modified again while it is written.
+ */
+struct CheckpointData
+{
+    std::vector<std::array<size_t, 4>> tets;
+    std::vector<VertexAttributes> vertices;
+    std::vector<FaceAttributes> faces;
+    std::vector<TetAttributes> tet_attributes;
+    std::vector<Vector3r> exact_positions;
+    std::vector<std::pair<wmtk::FaceTagMap::Key, std::vector<int>>> face_tags;
+    std::vector<double> parameters;
+    TetWild::ImprovementState state;
+};
+
+// bytes held by the copy, the memory a checkpoint adds while it is written
+size_t data_size(const CheckpointData& data)
+{
+    const size_t bytes = data.tets.size() * sizeof(data.tets[0]) +
+                   data.vertices.size() * sizeof(VertexAttributes) +
+                   data.faces.size() * sizeof(FaceAttributes) +
+                   data.tet_attributes.size() * sizeof(TetAttributes) +
+                   data.face_tags.size() * sizeof(data.face_tags[0]);
+    // not counting the digits of the exact positions, they are few after rounding
+    return bytes + data.exact_positions.size() * sizeof(Vector3r);
+}
+
+void write_checkpoint(const CheckpointData& data, const std::string& path)
+{
+    // the stars are rebuilt here, in the background, so that loading does not have to
+    wmtk::TetMesh mesh;
+    mesh.init(data.vertices.size(), data.tets);
+    wmtk::MeshSnapshotWriter writer(mesh);
+
+    const auto& V = data.vertices;
+    writer.add_attribute<double, 3>("posf", V.size(), [&](size_t i) { return V[i].m_posf; });
+    writer.add_attribute<uint8_t>("is_rounded", V.size(), [&](size_t i) {
+        return uint8_t(V[i].m_is_rounded);
+    });
+    writer.add_attribute<int32_t>("exact_id", V.size(), [&](size_t i) {
+        return int32_t(V[i].m_exact_id);
+    });
+    writer.add_attribute<uint8_t>("is_on_surface", V.size(), [&](size_t i) {
+        return uint8_t(V[i].m_is_on_surface);
+    });
+    writer.add_attribute<uint8_t>("on_bbox_faces", V.size(), [&](size_t i) {
+        return V[i].on_bbox_faces;
+    });
+    writer.add_attribute<uint8_t>("vertex_is_outside", V.size(), [&](size_t i) {
+        return uint8_t(V[i].m_is_outside);
+    });
+    writer.add_attribute<double>("sizing_scalar", V.size(), [&](size_t i) {
+        return V[i].m_sizing_scalar;
+    });
+    writer.add_attribute<double>("vertex_scalar", V.size(), [&](size_t i) {
+        return V[i].m_scalar;
+    });
+    writer.add_attribute<uint8_t>("is_freezed", V.size(), [&](size_t i) {
+        return uint8_t(V[i].m_is_freezed);
+    });
+
+    const auto& F = data.faces;
+    writer.add_attribute<double>("face_tag", F.size(), [&](size_t i) { return F[i].tag; });
+    writer.add_attribute<uint8_t>("is_surface_fs", F.size(), [&](size_t i) {
+        return uint8_t(F[i].m_is_surface_fs);
+    });
+    writer.add_attribute<int32_t>("is_bbox_fs", F.size(), [&](size_t i) {
+        return int32_t(F[i].m_is_bbox_fs);
+    });
+    writer.add_attribute<int32_t>("surface_tags", F.size(), [&](size_t i) {
+        return int32_t(F[i].m_surface_tags);
+    });
+
+    const auto& T = data.tet_attributes;
+    writer.add_attribute<double>("quality", T.size(), [&](size_t i) { return T[i].m_quality; });
+    writer.add_attribute<double>("tet_scalar", T.size(), [&](size_t i) { return T[i].m_scalar; });
+    writer.add_attribute<uint8_t>("tet_is_outside", T.size(), [&](size_t i) {
+        return uint8_t(T[i].m_is_outside);
+    });
+
+    // exact coordinates as text, one string per coordinate, delimited by offsets
+    const auto& E = data.exact_positions;
+    std::vector<std::string> exact(3 * E.size());
+    tbb::parallel_for(size_t(0), exact.size(), [&](size_t i) {
+        exact[i] = E[i / 3][i % 3].to_string();
+    });
+    std::vector<uint64_t> exact_offsets(exact.size() + 1, 0);
+    for (size_t i = 0; i < exact.size(); i++)
+        exact_offsets[i + 1] = exact_offsets[i] + exact[i].size();
+    std::string exact_digits;
+    exact_digits.reserve(exact_offsets.back());
+    for (const auto& str : exact) exact_digits += str;
+    writer.add_attribute<uint64_t>("exact_offsets", exact_offsets.size(), [&](size_t i) {
+        return exact_offsets[i];
+    });
+    writer.add_attribute<uint8_t>("exact_digits", exact_digits.size(), [&](size_t i) {
+        return uint8_t(exact_digits[i]);
+    });
+
+    const auto& tags = data.face_tags;
+    std::vector<uint64_t> tag_offsets(tags.size() + 1, 0);
+    for (size_t i = 0; i < tags.size(); i++)
+        tag_offsets[i + 1] = tag_offsets[i] + tags[i].second.size();
+    std::vector<int32_t> tag_values;
+    tag_values.reserve(tag_offsets.back());
+    for (const auto& [f, t] : tags) tag_values.insert(tag_values.end(), t.begin(), t.end());
+    writer.add_attribute<uint64_t, 3>("face_tag_keys", tags.size(), [&](size_t i) {
+        return tags[i].first;
+    });
+    writer.add_attribute<uint64_t>("face_tag_offsets", tag_offsets.size(), [&](size_t i) {
+        return tag_offsets[i];
+    });
+    writer.add_attribute<int32_t>("face_tag_values", tag_values.size(), [&](size_t i) {
+        return tag_values[i];
+    });
+
+    writer.add_attribute<double>("parameters", data.parameters.size(), [&](size_t i) {
+        return data.parameters[i];
+    });
+    const auto& S = data.state;
+    const std::array<double, 5> state = {
+        {double(S.it),
+         double(S.m),
+         S.pre_max_energy,
+         S.pre_avg_energy,
+         double(S.is_hit_min_edge_length)}};
+    writer.add_attribute<double>("state", state.size(), [&](size_t i) { return state[i]; });
+
+    // a run killed while writing keeps the previous checkpoint
+    const std::string tmp = path + ".tmp";
+    writer.write(tmp);
+    std::filesystem::rename(tmp, path);
+}
+
+} // namespace
+
+void TetWild::save_checkpoint(const std::string& path, const ImprovementState& state)
+{
+    igl::Timer timer;
+    timer.start();
+    if (vertex_size() != vert_capacity() || tet_size() != tet_capacity()) {
+        throw std::runtime_error("Checkpoints are only written for consolidated meshes");
+    }
+
+    // a single write in flight, the previous one is done long before in practice. Waiting
+    // before copying keeps at most one copy of the mesh alive besides the mesh itself
+    wait_for_checkpoint();
+
+    auto data = std::make_shared<CheckpointData>();
+    const size_t n_vertices = vert_capacity(), n_tets = tet_capacity();
+    data->tets.resize(n_tets);
+    data->vertices.resize(n_vertices);
+    data->faces.resize(4 * n_tets);
+    data->tet_attributes.resize(n_tets);
+    const int num_threads = std::max(NUM_THREADS, 1);
+    tbb::task_arena arena(num_threads);
+    arena.execute([&] {
+        tbb::parallel_for(size_t(0), n_tets, [&](size_t i) {
+            data->tets[i] = m_tet_connectivity[i].m_indices;
+            data->tet_attributes[i] = m_tet_attribute.at(i);
+            for (int j = 0; j < 4; j++) data->faces[4 * i + j] = m_face_attribute.at(4 * i + j);
+        });
+        tbb::parallel_for(size_t(0), n_vertices, [&](size_t i) {
+            data->vertices[i] = m_vertex_attribute.at(i);
+        });
+        data->exact_positions.assign(m_exact_positions.begin(), m_exact_positions.end());
+
+        tbb::concurrent_vector<std::pair<wmtk::FaceTagMap::Key, std::vector<int>>> tags;
+        tet_face_tags.parallel_for_each([&](const auto& f, const auto& t) {
+            if (!t.empty()) tags.emplace_back(f, t.to_vector());
+        });
+        data->face_tags.assign(tags.begin(), tags.end());
+        tbb::parallel_sort(data->face_tags.begin(), data->face_tags.end());
+    });
+
+    for (const double* field : parameter_fields(m_params)) data->parameters.push_back(*field);
+    data->state = state;
+
+    m_checkpoint_writing = std::async(std::launch::async, [data, path, num_threads] {
+        igl::Timer write_timer;
+        write_timer.start();
+        try {
+            // the writer's parallel loops as well, on the threads of the run
+            tbb::task_arena write_arena(num_threads);
+            write_arena.execute([&] { write_checkpoint(*data, path); });
+            wmtk::logger().info(
+                "checkpoint of it {} written to {} in {}s",
+                data->state.it - 1,
+                path,
+                write_timer.getElapsedTime());
+        } catch (const std::exception& e) {
+            wmtk::logger().error("checkpoint {} failed: {}", path, e.what());
+        }
+    });
+    wmtk::logger().info(
+        "checkpoint copied in {}s, {} MB",
+        timer.getElapsedTime(),
+        data_size(*data) / (1024. * 1024.));
+}
+
+void TetWild::wait_for_checkpoint()
+{
+    if (m_checkpoint_writing.valid()) m_checkpoint_writing.get();
+}
+
+TetWild::ImprovementState TetWild::load_checkpoint(const std::string& path)
+{
+    wait_for_checkpoint();
+    ImprovementState res;
+    tbb::task_arena arena(std::max(NUM_THREADS, 1));
+    arena.execute([&] { res = read_checkpoint(path); });
+    return res;
+}
+
+TetWild::ImprovementState TetWild::read_checkpoint(const std::string& path)
+{
+    wmtk::MeshSnapshot snapshot(path);
+    init(snapshot);
+    const size_t n_vertices = vert_capacity(), n_tets = tet_capacity();
+
+    const auto posf = snapshot.attribute<double>("posf");
+    const auto is_rounded = snapshot.attribute<uint8_t>("is_rounded");
+    const auto exact_id = snapshot.attribute<int32_t>("exact_id");
+    const auto is_on_surface = snapshot.attribute<uint8_t>("is_on_surface");
+    const auto on_bbox_faces = snapshot.attribute<uint8_t>("on_bbox_faces");
+    const auto vertex_is_outside = snapshot.attribute<uint8_t>("vertex_is_outside");
+    const auto sizing_scalar = snapshot.attribute<double>("sizing_scalar");
+    const auto vertex_scalar = snapshot.attribute<double>("vertex_scalar");
+    const auto is_freezed = snapshot.attribute<uint8_t>("is_freezed");
+    tbb::parallel_for(size_t(0), n_vertices, [&](size_t i) {
+        auto& v = m_vertex_attribute[i];
+        v = VertexAttributes();
+        v.m_posf = Vector3d(posf[i][0], posf[i][1], posf[i][2]);
+        v.m_is_rounded = is_rounded[i][0];
+        v.m_exact_id = exact_id[i][0];
+        v.m_is_on_surface = is_on_surface[i][0];
+        v.on_bbox_faces = on_bbox_faces[i][0];
+        v.m_is_outside = vertex_is_outside[i][0];
+        v.m_sizing_scalar = sizing_scalar[i][0];
+        v.m_scalar = vertex_scalar[i][0];
+        v.m_is_freezed = is_freezed[i][0];
+    });
+
+    const auto face_tag = snapshot.attribute<double>("face_tag");
+    const auto is_surface_fs = snapshot.attribute<uint8_t>("is_surface_fs");
+    const auto is_bbox_fs = snapshot.attribute<int32_t>("is_bbox_fs");
+    const auto surface_tags = snapshot.attribute<int32_t>("surface_tags");
+    const auto quality = snapshot.attribute<double>("quality");
+    const auto tet_scalar = snapshot.attribute<double>("tet_scalar");
+    const auto tet_is_outside = snapshot.attribute<uint8_t>("tet_is_outside");
+    tbb::parallel_for(size_t(0), n_tets, [&](size_t i) {
+        for (size_t f = 4 * i; f < 4 * i + 4; f++) {
+            auto& face = m_face_attribute[f];
+            face.tag = face_tag[f][0];
+            face.m_is_surface_fs = is_surface_fs[f][0];
+            face.m_is_bbox_fs = is_bbox_fs[f][0];
+            face.m_surface_tags = surface_tags[f][0];
+        }
+        auto& tet = m_tet_attribute[i];
+        tet.m_quality = quality[i][0];
+        tet.m_scalar = tet_scalar[i][0];
+        tet.m_is_outside = tet_is_outside[i][0];
+    });
+
+    const auto exact_offsets = snapshot.attribute<uint64_t>("exact_offsets");
+    const auto exact_digits = snapshot.attribute<uint8_t>("exact_digits");
+    const auto digits = reinterpret_cast<const char*>(exact_digits.data);
+    m_released_exact_ids.clear();
+    m_free_exact_ids.clear();
+    m_exact_positions.clear();
+    m_exact_positions.grow_to_at_least((exact_offsets.size - 1) / 3);
+    tbb::parallel_for(size_t(0), exact_offsets.size - 1, [&](size_t i) {
+        const size_t begin = exact_offsets[i][0], end = exact_offsets[i + 1][0];
+        m_exact_positions[i / 3][i % 3] =
+            wmtk::Rational::from_string(std::string(digits + begin, digits + end));
+    });
+
+    const auto tag_keys = snapshot.attribute<uint64_t>("face_tag_keys");
+    const auto tag_offsets = snapshot.attribute<uint64_t>("face_tag_offsets");
+    const auto tag_values = snapshot.attribute<int32_t>("face_tag_values");
+    tet_face_tags.clear();
+    tbb::parallel_for(size_t(0), tag_keys.size, [&](size_t i) {
+        wmtk::FaceTags tags;
+        for (auto t = tag_offsets[i][0]; t < tag_offsets[i + 1][0]; t++)
+            tags.push_back(tag_values[t][0]);
+        tet_face_tags.assign({{tag_keys[i][0], tag_keys[i][1], tag_keys[i][2]}}, tags);
+    });
+
+    const auto parameters = snapshot.attribute<double>("parameters");
+    const auto fields = parameter_fields(m_params);
+    if (parameters.size != fields.size()) {
+        throw std::runtime_error("Checkpoint " + path + " holds other parameters");
+    }
+    for (size_t i = 0; i < fields.size(); i++) *fields[i] = parameters[i][0];
+
+    const auto state = snapshot.attribute<double>("state");
+    ImprovementState res;
+    res.it = int(state[0][0]);
+    res.m = int(state[1][0]);
+    res.pre_max_energy = state[2][0];
+    res.pre_avg_energy = state[3][0];
+    res.is_hit_min_edge_length = state[4][0] != 0;
+    wmtk::logger().info(
+        "loaded checkpoint {}: v {} t {}, resuming at it {}",
+        path,
+        n_vertices,
+        n_tets,
+        res.it);
+    return res;
+}
+
+} // namespace tetwild
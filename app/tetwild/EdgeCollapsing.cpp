@@ -84,6 +84,7 @@ void tetwild::TetWild::collapse_all_edges(bool is_limit_length)
         time = timer.getElapsedTime();
         wmtk::logger().info("edge collapse operation time serial: {}s", time);
     }
+    recycle_exact_positions();
 }
 
 bool tetwild::TetWild::collapse_edge_before(const Tuple& loc) // input is an edge
@@ -107,15 +108,8 @@ bool tetwild::TetWild::collapse_edge_before(const Tuple& loc) // input is an edg
 
     ///check if on bbox/surface/boundary
     // bbox
-    if (!VA[v1_id].on_bbox_faces.empty()) {
-        if (VA[v2_id].on_bbox_faces.size() < VA[v1_id].on_bbox_faces.size()) return false;
-        for (int on_bbox : VA[v1_id].on_bbox_faces)
-            if (std::find(
-                    VA[v2_id].on_bbox_faces.begin(),
-                    VA[v2_id].on_bbox_faces.end(),
-                    on_bbox) == VA[v2_id].on_bbox_faces.end())
-                return false;
-    }
+    // v2 has to be on all the bbox faces of v1
+    if ((VA[v1_id].on_bbox_faces & ~VA[v2_id].on_bbox_faces) != 0) return false;
 
     // surface
     if (cache.edge_length > 0 && VA[v1_id].m_is_on_surface) {
@@ -220,10 +214,13 @@ bool tetwild::TetWild::collapse_edge_after(const Tuple& loc)
     size_t v2_id = cache.v2_id;
 
     // check quality
+    std::vector<Tuple> tets;
+    tets.reserve(cache.changed_tids.size());
+    for (size_t tid : cache.changed_tids) tets.push_back(tuple_from_tet(tid));
+    if (is_any_inverted(tets)) return false;
+
     std::vector<double> qs;
-    for (size_t tid : cache.changed_tids) {
-        auto tet = tuple_from_tet(tid);
-        if (is_inverted(tet)) return false;
+    for (auto& tet : tets) {
         double q = get_quality(tet);
         if (q > cache.max_energy) {
             return false;
@@ -234,12 +231,12 @@ bool tetwild::TetWild::collapse_edge_after(const Tuple& loc)
     // surface
 
     if (cache.edge_length > 0) {
-        for (auto& vids : cache.surface_faces) {
-            bool is_out = m_envelope.is_outside(
-                {{VA[vids[0]].m_posf, VA[vids[1]].m_posf, VA[vids[2]].m_posf}});
-            if (is_out) {
-                return false;
-            }
+        std::vector<std::array<Vector3d, 3>> surface_tris;
+        surface_tris.reserve(cache.surface_faces.size());
+        for (auto& vids : cache.surface_faces)
+            surface_tris.push_back({{VA[vids[0]].m_posf, VA[vids[1]].m_posf, VA[vids[2]].m_posf}});
+        if (m_envelope.any_outside(surface_tris)) {
+            return false;
         }
     }
 
@@ -250,6 +247,7 @@ bool tetwild::TetWild::collapse_edge_after(const Tuple& loc)
     }
     // vertex attr
     round(loc);
+    release_exact_pos(cache.v1_id); // removed
     VA[v2_id].m_is_on_surface = VA[v1_id].m_is_on_surface || VA[v2_id].m_is_on_surface;
     // no need to update on_bbox_faces
     // face attr
@@ -51,6 +51,7 @@ void tetwild::TetWild::split_all_edges()
         time = timer.getElapsedTime();
         wmtk::logger().info("edge split operation time serial: {}s", time);
     }
+    recycle_exact_positions();
 }
 
 bool tetwild::TetWild::split_edge_before(const Tuple& loc0)
@@ -120,11 +121,8 @@ bool tetwild::TetWild::split_edge_after(const Tuple& loc)
         }
     }
     if (!m_vertex_attribute[v_id].m_is_rounded) {
-        m_vertex_attribute[v_id].m_pos =
-            (m_vertex_attribute[v1_id].m_pos + m_vertex_attribute[v2_id].m_pos) / 2;
-        m_vertex_attribute[v_id].m_posf = to_double(m_vertex_attribute[v_id].m_pos);
-    } else
-        m_vertex_attribute[v_id].m_pos = to_rational(m_vertex_attribute[v_id].m_posf);
+        set_exact_pos(v_id, (get_exact_pos(v1_id) + get_exact_pos(v2_id)) / 2);
+    }
 
     /// update quality
     for (auto& loc : locs) {
@@ -133,9 +131,8 @@ bool tetwild::TetWild::split_edge_after(const Tuple& loc)
 
     /// update vertex attribute
     // bbox
-    m_vertex_attribute[v_id].on_bbox_faces = wmtk::set_intersection(
-        m_vertex_attribute[v1_id].on_bbox_faces,
-        m_vertex_attribute[v2_id].on_bbox_faces);
+    m_vertex_attribute[v_id].on_bbox_faces =
+        m_vertex_attribute[v1_id].on_bbox_faces & m_vertex_attribute[v2_id].on_bbox_faces;
     // surface
     m_vertex_attribute[v_id].m_is_on_surface = split_cache.local().is_edge_on_surface;
 
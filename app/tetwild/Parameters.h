@@ -20,6 +20,14 @@ struct Parameters
         std::numeric_limits<double>::max(); // the upper bound length (squared) for edge collapse
 
     double stop_energy = 10;
+    double smooth_min_relative_decrease = 0.; // early exit of the Newton smoothing, off by default
+    double smooth_min_step = 1e-9; // the Newton smoothing stops on a shorter step
+    // Barnes-Hut opening ratio of the winding numbers of filter_outside, 0 for exact
+    double winding_number_accuracy = 2.;
+
+    // file of the checkpoints of mesh_improvement, empty to disable them
+    std::string checkpoint_path;
+    double checkpoint_interval = 0; // minimum seconds between two checkpoints
 
     void init(const Vector3d& min_, const Vector3d& max_)
     {
@@ -5,8 +5,10 @@
 #include <Eigen/src/Core/util/Constants.h>
 #include <igl/Timer.h>
 #include <wmtk/utils/AMIPS.h>
+#include <algorithm>
 #include <array>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/NewtonMethod.hpp>
 #include <wmtk/utils/TetraQualityUtils.hpp>
 
 
@@ -14,7 +16,7 @@
 #include <optional>
 bool tetwild::TetWild::smooth_before(const Tuple& t)
 {
-    if (!m_vertex_attribute[t.vid(*this)].on_bbox_faces.empty()) return false;
+    if (m_vertex_attribute[t.vid(*this)].on_bbox_faces != 0) return false;
     if (m_vertex_attribute[t.vid(*this)].m_is_rounded) return true;
     // try to round.
     // Note: no need to roll back.
@@ -60,12 +62,15 @@ bool tetwild::TetWild::smooth_after(const Tuple& t)
     }
 
     auto old_pos = m_vertex_attribute[vid].m_posf;
-    auto old_asssembles = assembles;
-    m_vertex_attribute[vid].m_posf = wmtk::newton_method_from_stack(
+    wmtk::SmoothingOptions options;
+    options.min_step = m_params.smooth_min_step;
+    options.min_relative_decrease = m_params.smooth_min_relative_decrease;
+    m_vertex_attribute[vid].m_posf = wmtk::newton_method<12, 3>(
         assembles,
-        wmtk::AMIPS_energy,
-        wmtk::AMIPS_jacobian,
-        wmtk::AMIPS_hessian);
+        wmtk::AMIPS_energy_batch,
+        wmtk::AMIPS_jacobian_batch,
+        wmtk::AMIPS_hessian_batch,
+        options);
     wmtk::logger().trace(
         "old pos {} -> new pos {}",
         old_pos.transpose(),
@@ -102,30 +107,26 @@ bool tetwild::TetWild::smooth_after(const Tuple& t)
         for (auto& n : neighbor_assemble) {
             for (auto kk = 0; kk < 3; kk++) n[kk] = m_vertex_attribute[vid].m_posf[kk];
         }
-        for (auto& n : neighbor_assemble) {
-            auto tris = std::array<Eigen::Vector3d, 3>();
+        std::vector<std::array<Eigen::Vector3d, 3>> surface_tris(neighbor_assemble.size());
+        for (auto i = 0; i < neighbor_assemble.size(); i++) {
             for (auto k = 0; k < 3; k++) {
-                for (auto kk = 0; kk < 3; kk++) tris[k][kk] = n[k * 3 + kk];
+                for (auto kk = 0; kk < 3; kk++)
+                    surface_tris[i][k][kk] = neighbor_assemble[i][k * 3 + kk];
             }
-            bool is_out = m_envelope.is_outside(tris);
-            if (is_out) return false;
         }
+        if (m_envelope.any_outside(surface_tris)) return false;
     }
 
     // quality
+    if (is_any_inverted(locs)) return false;
     auto max_after_quality = 0.;
     for (auto& loc : locs) {
-        if (is_inverted(loc)) return false;
         auto t_id = loc.tid(*this);
         m_tet_attribute[t_id].m_quality = get_quality(loc);
         max_after_quality = std::max(max_after_quality, m_tet_attribute[t_id].m_quality);
     }
     if (max_after_quality > max_quality) return false;
 
-
-    m_vertex_attribute[vid].m_pos = tetwild::to_rational(m_vertex_attribute[vid].m_posf);
-
-
     return true;
 }
 
@@ -158,4 +159,5 @@ void tetwild::TetWild::smooth_all_vertices()
         time = timer.getElapsedTime();
         wmtk::logger().info("vertex smoothing operation time serial: {}s", time);
     }
+    recycle_exact_positions();
 }
@@ -5,9 +5,12 @@
 #include "wmtk/utils/Rational.hpp"
 
 #include <wmtk/utils/AMIPS.h>
+#include <wmtk/utils/FastWindingNumber.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/MshStreamWriter.hpp>
+#include <wmtk/utils/Predicates.hpp>
+#include <wmtk/utils/RunReport.hpp>
 #include <wmtk/utils/TetraQualityUtils.hpp>
-#include <wmtk/utils/io.hpp>
 
 // clang-format off
 #include <wmtk/utils/DisableWarnings.hpp>
@@ -16,7 +19,6 @@
 #include <spdlog/fmt/bundled/format.h>
 #include <Tracy.hpp>
 #include <igl/predicates/predicates.h>
-#include <igl/winding_number.h>
 #include <igl/write_triangle_mesh.h>
 #include <igl/Timer.h>
 #include <igl/orientable_patches.h>
@@ -24,15 +26,71 @@
 // clang-format on
 
 #include <geogram/points/kd_tree.h>
+#include <algorithm>
 #include <limits>
 
-tetwild::VertexAttributes::VertexAttributes(const Vector3r& p)
+tetwild::Vector3r tetwild::TetWild::get_exact_pos(size_t vid) const
 {
-    m_pos = p;
-    m_posf = to_double(p);
+    const auto& v = m_vertex_attribute[vid];
+    if (v.m_is_rounded) return to_rational(v.m_posf);
+    assert(v.m_exact_id >= 0 && v.m_exact_id < m_exact_positions.size());
+    return m_exact_positions[v.m_exact_id];
 }
 
-void tetwild::TetWild::mesh_improvement(int max_its)
+void tetwild::TetWild::set_exact_pos(VertexAttributes& v, const Vector3r& p)
+{
+    int id;
+    if (m_free_exact_ids.try_pop(id))
+        m_exact_positions[id] = p;
+    else
+        id = m_exact_positions.push_back(p) - m_exact_positions.begin();
+    v.m_exact_id = id;
+    v.m_posf = to_double(p);
+    v.m_is_rounded = false;
+}
+
+void tetwild::TetWild::set_exact_pos(size_t vid, const Vector3r& p)
+{
+    set_exact_pos(m_vertex_attribute[vid], p);
+    // freed after the pass if the operation creating the vertex is rolled back
+    m_released_exact_ids.emplace_back(vid, m_vertex_attribute.at(vid).m_exact_id);
+}
+
+void tetwild::TetWild::release_exact_pos(size_t vid)
+{
+    const auto& v = m_vertex_attribute.at(vid);
+    if (!v.m_is_rounded && v.m_exact_id >= 0) m_released_exact_ids.emplace_back(vid, v.m_exact_id);
+}
+
+void tetwild::TetWild::recycle_exact_positions()
+{
+    std::vector<int> free_ids;
+    for (const auto& [vid, id] : m_released_exact_ids) {
+        const auto& v = m_vertex_attribute.at(vid);
+        const bool removed = !tuple_from_vertex(vid).is_valid(*this);
+        if (removed || v.m_is_rounded || v.m_exact_id != id) free_ids.push_back(id);
+    }
+    m_released_exact_ids.clear();
+    // a slot can be released more than once, e.g. when a rounding is rolled back and retried
+    wmtk::vector_unique(free_ids);
+    for (int id : free_ids) m_free_exact_ids.push(id);
+}
+
+void tetwild::TetWild::compact_exact_positions()
+{
+    m_released_exact_ids.clear();
+    m_free_exact_ids.clear();
+    tbb::concurrent_vector<Vector3r> compacted;
+    for (auto& loc : get_vertices()) {
+        auto& v = m_vertex_attribute.m_attributes[loc.vid(*this)];
+        if (v.m_is_rounded) continue;
+        compacted.push_back(m_exact_positions[v.m_exact_id]);
+        v.m_exact_id = compacted.size() - 1;
+    }
+    m_exact_positions.swap(compacted);
+}
+
+void tetwild::TetWild::mesh_improvement(int max_its, std::optional<ImprovementState> resume)
 {
     ////preprocessing
     // TODO: refactor to eliminate repeated partition.
@@ -41,15 +99,24 @@ void tetwild::TetWild::mesh_improvement(int max_its)
 
     compute_vertex_partition_morton();
 
-    wmtk::logger().info("========it pre========");
-    local_operations({{0, 1, 0, 0}}, false);
+    ImprovementState state;
+    if (resume) {
+        state = *resume;
+        wmtk::logger().info("========resume at it {}========", state.it);
+    } else {
+        wmtk::logger().info("========it pre========");
+        local_operations({{0, 1, 0, 0}}, false);
+    }
 
     ////operation loops
-    bool is_hit_min_edge_length = false;
+    auto& is_hit_min_edge_length = state.is_hit_min_edge_length;
     const int M = 2;
-    int m = 0;
-    double pre_max_energy = 0., pre_avg_energy = 0.;
-    for (int it = 0; it < max_its; it++) {
+    auto& m = state.m;
+    auto& pre_max_energy = state.pre_max_energy;
+    auto& pre_avg_energy = state.pre_avg_energy;
+    igl::Timer checkpoint_timer;
+    checkpoint_timer.start();
+    for (int it = state.it; it < max_its; it++) {
         ///ops
         wmtk::logger().info("\n========it {}========", it);
         auto [max_energy, avg_energy] = local_operations({{1, 1, 1, 1}});
@@ -58,6 +125,7 @@ void tetwild::TetWild::mesh_improvement(int max_its)
         wmtk::logger().info("max energy {} stop {}", max_energy, m_params.stop_energy);
         if (max_energy < m_params.stop_energy) break;
         consolidate_mesh();
+        compact_exact_positions();
         wmtk::logger().info("v {} t {}", vert_capacity(), tet_capacity());
 
         auto cnt_round = 0, cnt_verts = 0;
@@ -88,10 +156,19 @@ void tetwild::TetWild::mesh_improvement(int max_its)
         }
         pre_max_energy = max_energy;
         pre_avg_energy = avg_energy;
+
+        ///checkpoint, the mesh is still consolidated
+        state.it = it + 1;
+        if (!m_params.checkpoint_path.empty() &&
+            checkpoint_timer.getElapsedTime() >= m_params.checkpoint_interval) {
+            save_checkpoint(m_params.checkpoint_path, state);
+            checkpoint_timer.start();
+        }
     }
 
     wmtk::logger().info("========it post========");
     local_operations({{0, 1, 0, 0}});
+    wait_for_checkpoint();
 }
 
 std::tuple<double, double> tetwild::TetWild::local_operations(
@@ -105,27 +182,35 @@ std::tuple<double, double> tetwild::TetWild::local_operations(
     for (int i = 0; i < ops.size(); i++) {
         timer.start();
         if (i == 0) {
+            wmtk::ScopedPhase phase("split");
             for (int n = 0; n < ops[i]; n++) {
                 wmtk::logger().info("==splitting {}==", n);
                 split_all_edges();
             }
+            memory_report().log("after split");
         } else if (i == 1) {
+            wmtk::ScopedPhase phase("collapse");
             for (int n = 0; n < ops[i]; n++) {
                 wmtk::logger().info("==collapsing {}==", n);
                 collapse_all_edges();
             }
+            memory_report().log("after collapse");
         } else if (i == 2) {
+            wmtk::ScopedPhase phase("swap");
             for (int n = 0; n < ops[i]; n++) {
                 wmtk::logger().info("==swapping {}==", n);
                 swap_all_edges_44();
                 swap_all_edges();
                 swap_all_faces();
             }
+            memory_report().log("after swap");
         } else if (i == 3) {
+            wmtk::ScopedPhase phase("smooth");
             for (int n = 0; n < ops[i]; n++) {
                 wmtk::logger().info("==smoothing {}==", n);
                 smooth_all_vertices();
             }
+            memory_report().log("after smooth");
         }
         // output_faces(fmt::format("out-op{}.obj", i), [](auto& f) { return f.m_is_surface_fs; });
     }
@@ -154,7 +239,7 @@ bool tetwild::TetWild::adjust_sizing_field(double max_energy)
     tbb::concurrent_vector<Scalar> scale_multipliers(vert_capacity(), recover_scalar);
 
     tbb::concurrent_vector<Vector3d> pts;
-    tbb::concurrent_queue<size_t> v_queue;
+    tbb::concurrent_vector<size_t> seeds;
     TetMesh::for_each_tetra([&](auto& t) {
         auto tid = t.tid(*this);
         if (std::cbrt(m_tet_attribute[tid].m_quality) < filter_energy) return;
@@ -162,7 +247,7 @@ bool tetwild::TetWild::adjust_sizing_field(double max_energy)
         Vector3d c(0, 0, 0);
         for (int j = 0; j < 4; j++) {
             c += (m_vertex_attribute[vs[j]].m_posf);
-            v_queue.emplace(vs[j]);
+            seeds.push_back(vs[j]);
         }
         pts.emplace_back(c / 4);
     });
@@ -171,44 +256,60 @@ bool tetwild::TetWild::adjust_sizing_field(double max_energy)
 
     const double R = m_params.l * 1.8;
 
-    int sum = 0;
-    int adjcnt = 0;
-
-    std::vector<bool> visited(vert_capacity(), false);
-
     GEO::NearestNeighborSearch_var nnsearch = GEO::NearestNeighborSearch::create(3, "BNN");
-    nnsearch->set_points(pts.size(), pts[0].data());
-
-    std::vector<size_t> cache_one_ring;
-    size_t vid;
-    while (v_queue.try_pop(vid)) {
-        sum++;
-        // size_t vid = v_queue.front();
-        // v_queue.pop();
-        if (visited[vid]) continue;
-        visited[vid] = true;
-        adjcnt++;
-
-        auto& pos_v = m_vertex_attribute[vid].m_posf;
-        auto sq_dist = 0.;
-        GEO::index_t _1;
-        nnsearch->get_nearest_neighbors(1, pos_v.data(), &_1, &sq_dist);
-        auto dist = std::sqrt(std::max(sq_dist, 0.)); // compute dist(pts, pos_v);
-
-        if (dist > R) { // outside R-ball, unmark.
-            continue;
-        }
+    if (!pts.empty()) nnsearch->set_points(pts.size(), pts[0].data());
+
+    // Breadth first search from the low quality tets, one parallel round per ring. The first
+    // thread to reach a vertex claims it, so every vertex is visited once and only written by the
+    // thread that claimed it, and the visited set is the same as with a serial search.
+    std::vector<std::atomic<bool>> visited(vert_capacity());
+    for (auto& v : visited) v.store(false, std::memory_order_relaxed);
+    tbb::enumerable_thread_specific<std::vector<size_t>> cache_one_ring;
+    tbb::enumerable_thread_specific<std::vector<size_t>> next_frontier;
+    std::vector<size_t> frontier(seeds.begin(), seeds.end());
+    std::atomic<size_t> num_visited = 0;
+    int num_rounds = 0;
+
+    tbb::task_arena arena(std::max(NUM_THREADS, 1));
+    arena.execute([&] {
+        while (!frontier.empty()) {
+            num_rounds++;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, frontier.size()), [&](auto r) {
+                auto& cache = cache_one_ring.local();
+                auto& next = next_frontier.local();
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const size_t vid = frontier[i];
+                    if (visited[vid].exchange(true)) continue;
+                    num_visited++;
+
+                    auto& pos_v = m_vertex_attribute[vid].m_posf;
+                    auto sq_dist = 0.;
+                    GEO::index_t _1;
+                    nnsearch->get_nearest_neighbors(1, pos_v.data(), &_1, &sq_dist);
+                    auto dist = std::sqrt(std::max(sq_dist, 0.)); // compute dist(pts, pos_v);
+
+                    if (dist > R) { // outside R-ball, unmark.
+                        continue;
+                    }
 
-        scale_multipliers[vid] = std::min(
-            scale_multipliers[vid],
-            dist / R * (1 - refine_scalar) + refine_scalar); // linear interpolate
+                    scale_multipliers[vid] = std::min(
+                        scale_multipliers[vid],
+                        dist / R * (1 - refine_scalar) + refine_scalar); // linear interpolate
 
-        auto vids = get_one_ring_vids_for_vertex_adj(vid, cache_one_ring);
-        for (size_t n_vid : vids) {
-            if (visited[n_vid]) continue;
-            v_queue.push(n_vid);
+                    for (size_t n_vid : get_one_ring_vids_for_vertex_adj(vid, cache)) {
+                        if (visited[n_vid].load(std::memory_order_relaxed)) continue;
+                        next.push_back(n_vid);
+                    }
+                }
+            });
+            frontier.clear();
+            for (auto& next : next_frontier) {
+                frontier.insert(frontier.end(), next.begin(), next.end());
+                next.clear();
+            }
         }
-    }
+    });
+    wmtk::logger().info("sizing field: {} vertices visited in {} rounds", num_visited, num_rounds);
 
     std::atomic_bool is_hit_min_edge_length = false;
     for_each_vertex([&](auto& v) {
@@ -338,24 +439,25 @@ void tetwild::TetWild::filter_outside(
 
     const auto& tets = get_tets();
     Eigen::MatrixXd C = Eigen::MatrixXd::Zero(tets.size(), 3);
-    for (size_t i = 0; i < tets.size(); i++) {
-        auto vs = oriented_tet_vertices(tets[i]);
-        for (auto& v : vs) C.row(i) += m_vertex_attribute[v.vid(*this)].m_posf;
-        C.row(i) /= 4;
-    }
-
     Eigen::VectorXd W;
-    igl::winding_number(V, F, C, W);
+    // the tree build and the queries are parallel, keep them to the threads of the run
+    tbb::task_arena arena(std::max(NUM_THREADS, 1));
+    arena.execute([&] {
+        tbb::parallel_for(size_t(0), tets.size(), [&](size_t i) {
+            auto vs = oriented_tet_vertices(tets[i]);
+            for (auto& v : vs) C.row(i) += m_vertex_attribute[v.vid(*this)].m_posf;
+            C.row(i) /= 4;
+        });
+
+        wmtk::FastWindingNumber winding_number(V, F);
+        W = winding_number.winding_numbers(C, m_params.winding_number_accuracy);
+    });
 
     if (W.maxCoeff() <= 0.5) {
         // all removed, let's invert.
         wmtk::logger().info("Correcting");
-        for (auto i = 0; i < F.rows(); i++) {
-            auto temp = F(i, 0);
-            F(i, 0) = F(i, 1);
-            F(i, 1) = temp;
-        }
-        igl::winding_number(V, F, C, W);
+        // flipping every triangle negates the winding numbers
+        W = -W;
     }
 
     if (W.maxCoeff() <= 0.5) {
@@ -397,36 +499,16 @@ void tetwild::TetWild::output_faces(
 
 void tetwild::TetWild::output_mesh(std::string file)
 {
-    consolidate_mesh();
-
-    wmtk::MshData msh;
-
-    const auto& vtx = get_vertices();
-    msh.add_tet_vertices(vtx.size(), [&](size_t k) {
-        auto i = vtx[k].vid(*this);
-        return m_vertex_attribute[i].m_posf;
-    });
-
-    const auto& tets = get_tets();
-    msh.add_tets(tets.size(), [&](size_t k) {
-        auto i = tets[k].tid(*this);
-        auto vs = oriented_tet_vertices(tets[k]);
-        std::array<size_t, 4> data;
-        for (int j = 0; j < 4; j++) {
-            data[j] = vs[j].vid(*this);
-            assert(data[j] < vtx.size());
-        }
-        return data;
-    });
-
-    msh.add_tet_vertex_attribute<1>("tv index", [&](size_t i) {
-        return m_vertex_attribute[i].m_sizing_scalar;
+    // streams the live tets, no need to consolidate first
+    wmtk::MshStreamWriter msh(*this);
+    msh.set_positions([&](size_t i) { return m_vertex_attribute.at(i).m_posf; });
+    msh.add_vertex_attribute<1>("tv index", [&](size_t i) {
+        return m_vertex_attribute.at(i).m_sizing_scalar;
     });
     msh.add_tet_attribute<1>("t energy", [&](size_t i) {
-        return std::cbrt(m_tet_attribute[i].m_quality);
+        return std::cbrt(m_tet_attribute.at(i).m_quality);
     });
-
-    msh.save(file, true);
+    msh.write(file);
 }
 
 
@@ -466,38 +548,25 @@ bool tetwild::TetWild::is_inverted(const Tuple& loc) const
     // that pa, pb, and pc appear in counterclockwise order when
     // viewed from above the plane.
 
-    auto vs = oriented_tet_vertices(loc);
+    auto vs = oriented_tet_vids(loc);
 
     //
-    if (m_vertex_attribute[vs[0].vid(*this)].m_is_rounded &&
-        m_vertex_attribute[vs[1].vid(*this)].m_is_rounded &&
-        m_vertex_attribute[vs[2].vid(*this)].m_is_rounded &&
-        m_vertex_attribute[vs[3].vid(*this)].m_is_rounded) {
-        igl::predicates::exactinit();
-        auto res = igl::predicates::orient3d(
-            m_vertex_attribute[vs[0].vid(*this)].m_posf,
-            m_vertex_attribute[vs[1].vid(*this)].m_posf,
-            m_vertex_attribute[vs[2].vid(*this)].m_posf,
-            m_vertex_attribute[vs[3].vid(*this)].m_posf);
-        int result;
-        if (res == igl::predicates::Orientation::POSITIVE)
-            result = 1;
-        else if (res == igl::predicates::Orientation::NEGATIVE)
-            result = -1;
-        else
-            result = 0;
+    if (m_vertex_attribute[vs[0]].m_is_rounded && m_vertex_attribute[vs[1]].m_is_rounded &&
+        m_vertex_attribute[vs[2]].m_is_rounded && m_vertex_attribute[vs[3]].m_is_rounded) {
+        int result = wmtk::predicates::orient3d(
+            m_vertex_attribute[vs[0]].m_posf,
+            m_vertex_attribute[vs[1]].m_posf,
+            m_vertex_attribute[vs[2]].m_posf,
+            m_vertex_attribute[vs[3]].m_posf);
 
         if (result < 0) // neg result == pos tet (tet origin from geogram delaunay)
             return false;
         return true;
     } else {
-        Vector3r n = ((m_vertex_attribute[vs[1].vid(*this)].m_pos) -
-                      m_vertex_attribute[vs[0].vid(*this)].m_pos)
-                         .cross(
-                             (m_vertex_attribute[vs[2].vid(*this)].m_pos) -
-                             m_vertex_attribute[vs[0].vid(*this)].m_pos);
-        Vector3r d = (m_vertex_attribute[vs[3].vid(*this)].m_pos) -
-                     m_vertex_attribute[vs[0].vid(*this)].m_pos;
+        std::array<Vector3r, 4> ps;
+        for (int k = 0; k < 4; k++) ps[k] = get_exact_pos(vs[k]);
+        Vector3r n = (ps[1] - ps[0]).cross(ps[2] - ps[0]);
+        Vector3r d = ps[3] - ps[0];
         auto res = n.dot(d);
         if (res > 0) // predicates returns pos value: non-inverted
             return false;
@@ -506,23 +575,47 @@ bool tetwild::TetWild::is_inverted(const Tuple& loc) const
     }
 }
 
+bool tetwild::TetWild::is_any_inverted(const std::vector<Tuple>& locs) const
+{
+    // tets with only rounded vertices are checked with one batched orient3d
+    std::vector<std::array<Vector3d, 4>> rounded;
+    rounded.reserve(locs.size());
+    for (auto& loc : locs) {
+        auto vs = oriented_tet_vids(loc);
+        bool all_rounded = true;
+        for (auto v : vs) all_rounded = all_rounded && m_vertex_attribute[v].m_is_rounded;
+        if (!all_rounded) {
+            if (is_inverted(loc)) return true;
+            continue;
+        }
+        rounded.push_back(
+            {{m_vertex_attribute[vs[0]].m_posf,
+              m_vertex_attribute[vs[1]].m_posf,
+              m_vertex_attribute[vs[2]].m_posf,
+              m_vertex_attribute[vs[3]].m_posf}});
+    }
+
+    std::vector<int> results(rounded.size());
+    wmtk::predicates::orient3d_batch(rounded.size(), rounded.data(), results.data());
+    // neg result == pos tet, as in is_inverted
+    return std::any_of(results.begin(), results.end(), [](int r) { return r >= 0; });
+}
+
 bool tetwild::TetWild::round(const Tuple& v)
 {
     size_t i = v.vid(*this);
     if (m_vertex_attribute[i].m_is_rounded) return true;
 
-    auto old_pos = m_vertex_attribute[i].m_pos;
-    m_vertex_attribute[i].m_pos << m_vertex_attribute[i].m_posf[0], m_vertex_attribute[i].m_posf[1],
-        m_vertex_attribute[i].m_posf[2];
+    // a rounded vertex is at m_posf, the exact position is kept in case rounding fails
     auto conn_tets = get_one_ring_tets_for_vertex(v);
     m_vertex_attribute[i].m_is_rounded = true;
-    for (auto& tet : conn_tets) {
-        if (is_inverted(tet)) {
-            m_vertex_attribute[i].m_is_rounded = false;
-            m_vertex_attribute[i].m_pos = old_pos;
-            return false;
-        }
+    if (is_any_inverted(conn_tets)) {
+        m_vertex_attribute[i].m_is_rounded = false;
+        return false;
     }
+    if (m_vertex_attribute[i].m_exact_id >= 0)
+        m_released_exact_ids.emplace_back(i, m_vertex_attribute[i].m_exact_id);
+    m_vertex_attribute[i].m_exact_id = -1;
 
     return true;
 }
@@ -548,8 +641,10 @@ double tetwild::TetWild::get_quality(const Tuple& loc) const
         energy = wmtk::AMIPS_energy_stable_p3<wmtk::Rational>(T);
     } else {
         std::array<wmtk::Rational, 12> T;
-        for (auto k = 0; k < 4; k++)
-            for (auto j = 0; j < 3; j++) T[k * 3 + j] = m_vertex_attribute[its[k]].m_pos[j];
+        for (auto k = 0; k < 4; k++) {
+            auto p = get_exact_pos(its[k]);
+            for (auto j = 0; j < 3; j++) T[k * 3 + j] = std::move(p[j]);
+        }
         energy = wmtk::AMIPS_energy_rational_p3<wmtk::Rational>(T);
     }
     if (std::isinf(energy) || std::isnan(energy) || energy < 27 - 1e-3) return MAX_ENERGY;
@@ -611,8 +706,8 @@ bool tetwild::TetWild::is_edge_on_bbox(const Tuple& loc)
     size_t v1_id = loc.vid(*this);
     auto loc1 = loc.switch_vertex(*this);
     size_t v2_id = loc1.vid(*this);
-    if (m_vertex_attribute[v1_id].on_bbox_faces.empty() ||
-        m_vertex_attribute[v2_id].on_bbox_faces.empty())
+    if (m_vertex_attribute[v1_id].on_bbox_faces == 0 ||
+        m_vertex_attribute[v2_id].on_bbox_faces == 0)
         return false;
 
     auto tets = get_incident_tets_for_edge(loc);
@@ -636,6 +731,9 @@ bool tetwild::TetWild::is_edge_on_bbox(const Tuple& loc)
 
 bool tetwild::TetWild::check_attributes()
 {
+    // the envelope is queried once for all surface faces and once for all surface vertices
+    std::vector<std::array<Vector3d, 3>> surface_tris;
+    std::vector<std::array<size_t, 3>> surface_vids;
     for (auto& f : get_faces()) {
         auto fid = f.fid(*this);
         auto vs = get_face_vertices(f);
@@ -647,50 +745,55 @@ bool tetwild::TetWild::check_attributes()
                 wmtk::logger().critical("surface track wrong");
                 return false;
             }
-            bool is_out = m_envelope.is_outside(
+            surface_vids.push_back({{vs[0].vid(*this), vs[1].vid(*this), vs[2].vid(*this)}});
+            surface_tris.push_back(
                 {{m_vertex_attribute[vs[0].vid(*this)].m_posf,
                   m_vertex_attribute[vs[1].vid(*this)].m_posf,
                   m_vertex_attribute[vs[2].vid(*this)].m_posf}});
-            if (is_out) {
-                wmtk::logger().critical(
-                    "is_out f {} {} {}",
-                    vs[0].vid(*this),
-                    vs[1].vid(*this),
-                    vs[2].vid(*this));
-                return false;
-            }
         }
         if (m_face_attribute[fid].m_is_bbox_fs >= 0) {
-            if (!(!m_vertex_attribute[vs[0].vid(*this)].on_bbox_faces.empty() &&
-                  !m_vertex_attribute[vs[1].vid(*this)].on_bbox_faces.empty() &&
-                  !m_vertex_attribute[vs[2].vid(*this)].on_bbox_faces.empty())) {
+            if (!(m_vertex_attribute[vs[0].vid(*this)].on_bbox_faces != 0 &&
+                  m_vertex_attribute[vs[1].vid(*this)].on_bbox_faces != 0 &&
+                  m_vertex_attribute[vs[2].vid(*this)].on_bbox_faces != 0)) {
                 wmtk::logger().critical("bbox track wrong {}", fid);
                 return false;
             }
         }
     }
 
+    const auto is_out_f = m_envelope.is_outside_batch(surface_tris);
+    for (size_t k = 0; k < is_out_f.size(); k++) {
+        if (is_out_f[k]) {
+            const auto& vids = surface_vids[k];
+            wmtk::logger().critical("is_out f {} {} {}", vids[0], vids[1], vids[2]);
+            return false;
+        }
+    }
+
     const auto& vs = get_vertices();
+    std::vector<Vector3d> surface_points;
+    for (const auto& v : vs) {
+        size_t i = v.vid(*this);
+        if (m_vertex_attribute[i].m_is_on_surface)
+            surface_points.push_back(m_vertex_attribute[i].m_posf);
+    }
+    const auto is_out_v = m_envelope.is_outside_batch(surface_points);
+    if (std::find(is_out_v.begin(), is_out_v.end(), true) != is_out_v.end()) {
+        wmtk::logger().critical("is_out v");
+        return false;
+    }
+
     for (const auto& v : vs) {
         size_t i = v.vid(*this);
-        if (m_vertex_attribute[i].m_is_on_surface) {
-            bool is_out = m_envelope.is_outside(m_vertex_attribute[i].m_posf);
-            if (is_out) {
-                wmtk::logger().critical("is_out v");
-                return false;
-            }
-        }
 
         // check rounding
-        if (m_vertex_attribute[i].m_is_rounded) {
-            if (m_vertex_attribute[i].m_pos[0] != m_vertex_attribute[i].m_posf[0] ||
-                m_vertex_attribute[i].m_pos[1] != m_vertex_attribute[i].m_posf[1] ||
-                m_vertex_attribute[i].m_pos[2] != m_vertex_attribute[i].m_posf[2]) {
-                wmtk::logger().critical("rounding error {} rounded", i);
+        if (!m_vertex_attribute[i].m_is_rounded) {
+            const int exact_id = m_vertex_attribute[i].m_exact_id;
+            if (exact_id < 0 || exact_id >= m_exact_positions.size()) {
+                wmtk::logger().critical("missing exact position {} unrounded", i);
                 return false;
             }
-        } else {
-            Vector3d p = to_double(m_vertex_attribute[i].m_pos);
+            Vector3d p = to_double(m_exact_positions[exact_id]);
             if (p != m_vertex_attribute[i].m_posf) {
                 wmtk::logger().critical("rounding error {} unrounded", i);
                 return false;
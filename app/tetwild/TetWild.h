@@ -2,6 +2,7 @@
 
 #include <igl/Timer.h>
 #include <wmtk/TetMesh.h>
+#include <wmtk/utils/FaceTagMap.hpp>
 #include <wmtk/utils/Morton.h>
 #include <wmtk/utils/PartitionMesh.h>
 #include "Parameters.h"
@@ -14,7 +15,6 @@
 #include <tbb/concurrent_queue.h>
 #include <tbb/concurrent_priority_queue.h>
 #include <tbb/concurrent_vector.h>
-#include <tbb/concurrent_map.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
@@ -24,7 +24,10 @@
 // clang-format on
 
 #include <igl/remove_unreferenced.h>
+#include <future>
 #include <memory>
+#include <optional>
+#include <type_traits>
 
 namespace tetwild {
 
@@ -32,12 +35,14 @@ namespace tetwild {
 class VertexAttributes
 {
 public:
-    Vector3r m_pos;
     Vector3d m_posf;
     bool m_is_rounded = false;
+    // index of the exact position in TetWild::m_exact_positions, only valid if !m_is_rounded
+    int m_exact_id = -1;
 
     bool m_is_on_surface = false;
-    std::vector<int> on_bbox_faces;
+    // bit f is set if the vertex is on face f of the bbox, f = 2 * axis + (0 for min, 1 for max)
+    uint8_t on_bbox_faces = 0;
     bool m_is_outside = false;
 
     Scalar m_sizing_scalar = 1;
@@ -47,8 +52,9 @@ public:
     size_t partition_id = 0;
 
     VertexAttributes(){};
-    VertexAttributes(const Vector3r& p);
 };
+// no member owns heap memory, so copies (rollback, consolidation, checkpoints) are plain copies
+static_assert(std::is_trivially_destructible<VertexAttributes>::value, "");
 
 // TODO: missing comments on what these attributes are
 class FaceAttributes
@@ -114,6 +120,31 @@ public:
     FaceAttCol m_face_attribute;
     TetAttCol m_tet_attribute;
 
+    // exact positions, only stored for the vertices that are not rounded. A slot is written when
+    // it is handed out, and handed out again only once recycle_exact_positions() has checked that
+    // no vertex refers to it, so the copies of VertexAttributes kept for rollback stay valid.
+    tbb::concurrent_vector<Vector3r> m_exact_positions;
+    // exact position of a vertex, taken from m_posf if the vertex is rounded
+    Vector3r get_exact_pos(size_t vid) const;
+    // mark the vertex as unrounded at the exact position p, m_posf is updated accordingly
+    void set_exact_pos(VertexAttributes& v, const Vector3r& p);
+    void set_exact_pos(size_t vid, const Vector3r& p);
+    // the vertex stops using its exact position (rounded or removed), the slot is recycled after
+    // the pass unless the operation is rolled back
+    void release_exact_pos(size_t vid);
+    // makes the released slots that no vertex refers to available again. Not thread safe, call
+    // it between passes.
+    void recycle_exact_positions();
+    // drop the entries of rounded and removed vertices. Not thread safe.
+    void compact_exact_positions();
+
+private:
+    // (vertex, slot) pairs to check in recycle_exact_positions
+    tbb::concurrent_vector<std::pair<size_t, int>> m_released_exact_ids;
+    tbb::concurrent_queue<int> m_free_exact_ids;
+
+public:
+
     // only used with unit tests
     void create_mesh_attributes(
         const std::vector<VertexAttributes>& _vertex_attribute,
@@ -286,6 +317,8 @@ public:
     bool swap_face_after(const Tuple& t) override;
 
     bool is_inverted(const Tuple& loc) const;
+    /// true if any of the tets is inverted, same as is_inverted on each but batched
+    bool is_any_inverted(const std::vector<Tuple>& locs) const;
     double get_quality(const Tuple& loc) const;
     bool round(const Tuple& loc);
     //
@@ -293,7 +326,38 @@ public:
     bool is_edge_on_bbox(const Tuple& loc);
     //
     bool adjust_sizing_field(double max_energy);
-    void mesh_improvement(int max_its = 80);
+
+    // iteration state of mesh_improvement, stored in the checkpoints
+    struct ImprovementState
+    {
+        int it = 0; // next iteration
+        int m = 0; // iterations without enough improvement
+        double pre_max_energy = 0., pre_avg_energy = 0.;
+        bool is_hit_min_edge_length = false;
+    };
+    /**
+     * @param resume state of a checkpoint loaded with load_checkpoint, the loop continues from
+     * there instead of starting with the pre pass. A checkpoint is written to
+     * m_params.checkpoint_path after the iterations, at most every m_params.checkpoint_interval.
+     */
+    void mesh_improvement(int max_its = 80, std::optional<ImprovementState> resume = {});
+    /**
+     * Saves the connectivity, the vertex (with the exact positions), face and tet attributes,
+     * tet_face_tags, m_params and state. The mesh must be consolidated. The data is copied before
+     * returning, the file is written by a background thread and replaces path once complete.
+     *
+     * The copy roughly doubles the memory of the mesh while the file is written (the size is
+     * logged). The previous write is waited for before copying, so there is never more than one
+     * copy. Leave m_params.checkpoint_path empty where that does not fit in memory.
+     */
+    void save_checkpoint(const std::string& path, const ImprovementState& state);
+    // waits for the write started by the last save_checkpoint, if any
+    void wait_for_checkpoint();
+    /**
+     * Replaces the mesh, its attributes, tet_face_tags and m_params by those of a checkpoint.
+     * @return the state to pass to mesh_improvement
+     */
+    ImprovementState load_checkpoint(const std::string& path);
     std::tuple<double, double> local_operations(
         const std::array<int, 4>& ops,
         bool collapse_limit_length = true);
@@ -315,9 +379,13 @@ public:
     std::atomic<int> cnt_split = 0, cnt_collapse = 0, cnt_swap = 0;
 
 private:
+    std::future<void> m_checkpoint_writing;
+    // load_checkpoint without the wait and the arena
+    ImprovementState read_checkpoint(const std::string& path);
+
     // tags: correspondence map from new tet-face node indices to in-triangle ids.
     // built up while triangles are inserted.
-    tbb::concurrent_map<std::array<size_t, 3>, std::vector<int>> tet_face_tags;
+    wmtk::FaceTagMap tet_face_tags;
 
     struct TriangleInsertionLocalInfoCache
     {
@@ -327,6 +395,18 @@ private:
     };
     tbb::enumerable_thread_specific<TriangleInsertionLocalInfoCache> triangle_insertion_local_cache;
 
+    // (random priority, number of failed attempts, face id)
+    using InsertionQueue = tbb::concurrent_priority_queue<std::tuple<double, int, size_t>>;
+    /**
+     * @brief inserts the faces of each queue in its own task, with the queue index as lock owner.
+     * A face that still fails after 5 attempts is pushed to expired.
+     */
+    void insert_triangles_in_parallel(
+        const std::vector<Vector3d>& vertices,
+        const std::vector<std::array<size_t, 3>>& faces,
+        std::vector<InsertionQueue>& queues,
+        InsertionQueue& expired);
+
     ////// Operations
 
     struct SplitInfoCache
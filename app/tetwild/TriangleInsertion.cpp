@@ -34,32 +34,51 @@ void tetwild::TetWild::init_from_delaunay_box_mesh(const std::vector<Eigen::Vect
     int Nx = std::max(2, int((box_max[0] - box_min[0]) / delta));
     int Ny = std::max(2, int((box_max[1] - box_min[1]) / delta));
     int Nz = std::max(2, int((box_max[2] - box_min[2]) / delta));
-    for (double i = 0; i <= Nx; i++) {
-        for (double j = 0; j <= Ny; j++) {
-            for (double k = 0; k <= Nz; k++) {
-                Vector3d p(
-                    box_min[0] * (1 - i / Nx) + box_max[0] * i / Nx,
-                    box_min[1] * (1 - j / Ny) + box_max[1] * j / Ny,
-                    box_min[2] * (1 - k / Nz) + box_max[2] * k / Nz);
-
-                if (i == 0) p[0] = box_min[0];
-                if (i == Nx) p[0] = box_max[0];
-                if (j == 0) p[1] = box_min[1];
-                if (j == Ny) p[1] = box_max[1];
-                if (k == 0) p[2] = box_min[2];
-                if (k == Nz) // note: have to do, otherwise the value would be slightly different
-                    p[2] = box_max[2];
-
-                if (!m_envelope.is_outside(p)) continue;
-                points.push_back({{p[0], p[1], p[2]}});
-            }
-        }
-    }
+    const auto grid_point = [&](double i, double j, double k) {
+        Vector3d p(
+            box_min[0] * (1 - i / Nx) + box_max[0] * i / Nx,
+            box_min[1] * (1 - j / Ny) + box_max[1] * j / Ny,
+            box_min[2] * (1 - k / Nz) + box_max[2] * k / Nz);
+
+        if (i == 0) p[0] = box_min[0];
+        if (i == Nx) p[0] = box_max[0];
+        if (j == 0) p[1] = box_min[1];
+        if (j == Ny) p[1] = box_max[1];
+        if (k == 0) p[2] = box_min[2];
+        if (k == Nz) // note: have to do, otherwise the value would be slightly different
+            p[2] = box_max[2];
+        return p;
+    };
+    // one batch of envelope queries per grid row, the points outside are appended in
+    // the order of the serial loop so that the mesh does not depend on the number of threads
+    std::vector<std::vector<Vector3d>> rows((Nx + 1) * (Ny + 1));
+    tbb::task_arena arena(std::max(NUM_THREADS, 1));
+    arena.execute([&] {
+        tbb::parallel_for(0, int(rows.size()), [&](int r) {
+            const int i = r / (Ny + 1), j = r % (Ny + 1);
+            std::vector<Vector3d> row(Nz + 1);
+            for (int k = 0; k <= Nz; k++) row[k] = grid_point(i, j, k);
+            const auto outside = m_envelope.is_outside_batch(row);
+            for (int k = 0; k <= Nz; k++)
+                if (outside[k]) rows[r].push_back(row[k]);
+        });
+    });
+    for (const auto& row : rows)
+        for (const auto& p : row) points.push_back({{p[0], p[1], p[2]}});
     m_params.box_min = box_min;
     m_params.box_max = box_max;
 
     ///delaunay
-    auto [unused_points,tets] = wmtk::delaunay3D(points);
+    // single threaded runs keep the input order and thus the same background mesh as before,
+    // parallel ones use as many geogram threads as the arena has
+    std::vector<wmtk::Tetrahedron> tets;
+    arena.execute([&] {
+        tets = wmtk::delaunay3D(
+                   points,
+                   NUM_THREADS > 1 ? wmtk::DelaunayInsertion::Parallel
+                                   : wmtk::DelaunayInsertion::Input)
+                   .second;
+    });
     wmtk::logger().info(
         "after delauney tets.size() {}  points.size() {}",
         tets.size(),
@@ -72,8 +91,8 @@ void tetwild::TetWild::init_from_delaunay_box_mesh(const std::vector<Eigen::Vect
     m_tet_attribute.m_attributes.resize(tets.size());
     m_face_attribute.m_attributes.resize(tets.size() * 4);
     for (int i = 0; i < vert_capacity(); i++) {
-        m_vertex_attribute[i].m_pos = Vector3r(points[i][0], points[i][1], points[i][2]);
         m_vertex_attribute[i].m_posf = Vector3d(points[i][0], points[i][1], points[i][2]);
+        m_vertex_attribute[i].m_is_rounded = true;
     }
 }
 
@@ -105,14 +124,9 @@ bool tetwild::TetWild::triangle_insertion_after(const std::vector<std::vector<Tu
         if (new_faces[i].empty()) continue;
 
         // note: erase old tag and then add new -- old and new can be the same face
-        std::vector<int> tags;
+        wmtk::FaceTags tags;
         if (i < cache.old_face_vids.size()) {
-            auto& old_f = cache.old_face_vids[i];
-            auto iter = tet_face_tags.find(old_f);
-            if (iter != tet_face_tags.end() && !iter->second.empty()) {
-                tags = iter->second;
-                iter->second.clear();
-            }
+            tags = tet_face_tags.take(cache.old_face_vids[i]);
             if (tags.empty()) continue; // nothing to inherit to new
         } else
             tags.push_back(cache.face_id);
@@ -122,7 +136,7 @@ bool tetwild::TetWild::triangle_insertion_after(const std::vector<std::vector<Tu
             auto vs = get_face_vertices(loc);
             std::array<size_t, 3> f = {{vs[0].vid(*this), vs[1].vid(*this), vs[2].vid(*this)}};
             std::sort(f.begin(), f.end());
-            tet_face_tags[f] = tags;
+            tet_face_tags.assign(f, tags);
         }
     }
 
@@ -131,8 +145,7 @@ bool tetwild::TetWild::triangle_insertion_after(const std::vector<std::vector<Tu
 
 
 auto internal_insert_single_triangle(
-    wmtk::TetMesh& m,
-    tetwild::TetWild::VertAttCol& m_vertex_attribute,
+    tetwild::TetWild& m,
     const std::vector<Eigen::Vector3d>& vertices,
     const std::array<size_t, 3>& face,
     std::vector<std::array<size_t, 3>>& marked_tet_faces,
@@ -140,8 +153,17 @@ auto internal_insert_single_triangle(
     const std::function<bool(const std::vector<wmtk::TetMesh::Tuple>&)>& try_acquire_edge,
     const std::function<bool(const std::vector<wmtk::TetMesh::Tuple>&)>& try_acquire_tetra)
 {
-    auto vertex_pos_r = [&m_vertex_attribute](size_t i) -> tetwild::Vector3r {
-        return m_vertex_attribute[i].m_pos;
+    auto& m_vertex_attribute = m.m_vertex_attribute;
+    auto vertex_pos_r = [&m](size_t i) -> tetwild::Vector3r { return m.get_exact_pos(i); };
+    // m_posf is exact for rounded vertices, otherwise it is the exact position truncated
+    // to a double
+    auto vertex_pos_interval = [&m_vertex_attribute](size_t i) -> wmtk::Interval3 {
+        const auto& v = m_vertex_attribute[i];
+        if (v.m_is_rounded) return {{v.m_posf[0], v.m_posf[1], v.m_posf[2]}};
+        return {
+            {wmtk::Interval::around(v.m_posf[0]),
+             wmtk::Interval::around(v.m_posf[1]),
+             wmtk::Interval::around(v.m_posf[2])}};
     };
 
     const auto& [flag, intersected_tets, intersected_edges, intersected_pos] =
@@ -151,7 +173,8 @@ auto internal_insert_single_triangle(
             marked_tet_faces, // output
             try_acquire_triangle,
             try_acquire_tetra,
-            vertex_pos_r);
+            vertex_pos_r,
+            vertex_pos_interval);
 
     if (!flag) {
         return false;
@@ -179,48 +202,30 @@ auto internal_insert_single_triangle(
     for (auto i = 0; i < new_center_vids.size(); i++) {
         auto vid = new_center_vids[i];
         auto& vs = center_split_tets[i];
-        m_vertex_attribute[vid] = tetwild::VertexAttributes(
-            (m_vertex_attribute[vs[0]].m_pos + m_vertex_attribute[vs[1]].m_pos +
-             m_vertex_attribute[vs[2]].m_pos + m_vertex_attribute[vs[3]].m_pos) /
-            4);
+        m_vertex_attribute[vid] = tetwild::VertexAttributes();
+        m.set_exact_pos(
+            vid,
+            (m.get_exact_pos(vs[0]) + m.get_exact_pos(vs[1]) + m.get_exact_pos(vs[2]) +
+             m.get_exact_pos(vs[3])) /
+                4);
     }
     assert(new_edge_vids.size() == intersected_pos.size());
 
     for (auto i = 0; i < intersected_pos.size(); i++) {
-        m_vertex_attribute[new_edge_vids[i]] = tetwild::VertexAttributes(intersected_pos[i]);
+        m_vertex_attribute[new_edge_vids[i]] = tetwild::VertexAttributes();
+        m.set_exact_pos(new_edge_vids[i], intersected_pos[i]);
     }
 
     return true;
 }
 
-void tetwild::TetWild::init_from_input_surface(
+void tetwild::TetWild::insert_triangles_in_parallel(
     const std::vector<Vector3d>& vertices,
     const std::vector<std::array<size_t, 3>>& faces,
-    const std::vector<size_t>& partition_id)
+    std::vector<InsertionQueue>& insertion_queues,
+    InsertionQueue& expired_queue)
 {
-    init_from_delaunay_box_mesh(vertices);
-
-    // match faces preserved in delaunay
-    tbb::concurrent_vector<bool> is_matched;
-    wmtk::match_tet_faces_to_triangles(*this, faces, is_matched, tet_face_tags);
-    wmtk::logger().info("is_matched: {}", std::count(is_matched.begin(), is_matched.end(), true));
-
-    std::vector<tbb::concurrent_priority_queue<std::tuple<double, int, size_t>>> insertion_queues(
-        std::max(NUM_THREADS, 1));
-    tbb::concurrent_priority_queue<std::tuple<double, int, size_t>> expired_queue;
-    std::default_random_engine generator;
-    std::uniform_real_distribution<double> distribution(0.0, 100.0);
-    for (size_t face_id = 0; face_id < faces.size(); face_id++) {
-        if (is_matched[face_id]) continue;
-        double rand = distribution(generator);
-        insertion_queues[partition_id[faces[face_id][0]]].emplace(rand, 0, face_id);
-    }
-
-    for (int i = 0; i < NUM_THREADS; i++) {
-        wmtk::logger().info("insertion queue {}: {}", i, insertion_queues[i].size());
-    }
-
-    tbb::task_arena arena(insertion_queues.size());
+    tbb::task_arena arena(std::max(NUM_THREADS, 1));
     tbb::task_group tg;
 
     arena.execute([&, &m = *this, &tet_face_tags = this->tet_face_tags]() {
@@ -283,11 +288,10 @@ void tetwild::TetWild::init_from_input_surface(
                         const auto& [_, retry_time, face_id] = eiq;
 
                         face_id_cache = face_id;
-                        if (func(face_id) == false) {
-                            retry_processing(face_id, retry_time);
-                            continue;
-                        };
+                        const bool success = func(face_id);
+                        // also after a failure, the triangle may have been locked before it
                         m.release_vertex_mutex_in_stack();
+                        if (!success) retry_processing(face_id, retry_time);
                     }
                 };
 
@@ -295,7 +299,6 @@ void tetwild::TetWild::init_from_input_surface(
                     std::vector<std::array<size_t, 3>> marked_tet_faces;
                     auto success = internal_insert_single_triangle(
                         m,
-                        m.m_vertex_attribute,
                         vertices,
                         faces[face_id],
                         marked_tet_faces,
@@ -303,15 +306,94 @@ void tetwild::TetWild::init_from_input_surface(
                         try_acquire_edge,
                         try_acquire_tetra);
                     if (!success) return false;
-                    for (auto& f : marked_tet_faces) tet_face_tags[f].push_back(face_id);
+                    for (auto& f : marked_tet_faces) tet_face_tags.add(f, face_id);
                     return true;
                 });
             }); // tg.run
         } // parallel for loop
         tg.wait();
     });
+}
+
+void tetwild::TetWild::init_from_input_surface(
+    const std::vector<Vector3d>& vertices,
+    const std::vector<std::array<size_t, 3>>& faces,
+    const std::vector<size_t>& partition_id)
+{
+    init_from_delaunay_box_mesh(vertices);
+
+    // match faces preserved in delaunay
+    tbb::concurrent_vector<bool> is_matched;
+    wmtk::match_tet_faces_to_triangles(*this, faces, is_matched, tet_face_tags);
+    wmtk::logger().info("is_matched: {}", std::count(is_matched.begin(), is_matched.end(), true));
+
+    std::vector<InsertionQueue> insertion_queues(std::max(NUM_THREADS, 1));
+    InsertionQueue expired_queue;
+    std::default_random_engine generator;
+    std::uniform_real_distribution<double> distribution(0.0, 100.0);
+    for (size_t face_id = 0; face_id < faces.size(); face_id++) {
+        if (is_matched[face_id]) continue;
+        double rand = distribution(generator);
+        insertion_queues[partition_id[faces[face_id][0]]].emplace(rand, 0, face_id);
+    }
+
+    for (int i = 0; i < NUM_THREADS; i++) {
+        wmtk::logger().info("insertion queue {}: {}", i, insertion_queues[i].size());
+    }
+
+    igl::Timer timer;
+    timer.start();
+    insert_triangles_in_parallel(vertices, faces, insertion_queues, expired_queue);
+    wmtk::logger().info(
+        "insertion round 0: {} expired, {}s",
+        expired_queue.size(),
+        timer.getElapsedTime());
+
+    // Faces expire waiting for locks, mostly along the borders of the partitions. They are split
+    // again along a Morton curve into 4 times more parts each round, so that most of them end up
+    // inside a part, and inserted in parallel as long as a round makes progress.
+    const int max_rounds = 4;
+    for (int round = 1; round <= max_rounds && NUM_THREADS > 1 && !expired_queue.empty();
+         round++) {
+        timer.start();
+        std::vector<std::pair<Resorting::MortonCode64, size_t>> expired;
+        std::tuple<double, int, size_t> eiq;
+        while (expired_queue.try_pop(eiq)) {
+            const auto face_id = std::get<2>(eiq);
+            const auto& f = faces[face_id];
+            const Vector3d c = (vertices[f[0]] + vertices[f[1]] + vertices[f[2]]) / 3;
+            const Vector3d q =
+                ((c - m_params.min) / m_params.diag_l * ((1 << 20) - 1)).cwiseMax(0.);
+            expired.emplace_back(
+                Resorting::MortonCode64(uint32_t(q[0]), uint32_t(q[1]), uint32_t(q[2])),
+                face_id);
+        }
+        tbb::parallel_sort(expired.begin(), expired.end());
+
+        const size_t num_parts = std::min(expired.size(), size_t(NUM_THREADS) << (2 * round));
+        std::vector<InsertionQueue> round_queues(num_parts);
+        for (size_t i = 0; i < expired.size(); i++) {
+            round_queues[i * num_parts / expired.size()].emplace(
+                distribution(generator),
+                0,
+                expired[i].second);
+        }
+        insert_triangles_in_parallel(vertices, faces, round_queues, expired_queue);
+
+        const size_t num_inserted = expired.size() - expired_queue.size();
+        wmtk::logger().info(
+            "insertion round {}: {} faces in {} parts, {} inserted, {} expired, {}s",
+            round,
+            expired.size(),
+            num_parts,
+            num_inserted,
+            expired_queue.size(),
+            timer.getElapsedTime());
+        if (num_inserted == 0) break;
+    }
 
-    wmtk::logger().info("retry insert 5 times expired size: {}", expired_queue.size());
+    wmtk::logger().info("serial insertion of the {} faces left", expired_queue.size());
+    timer.start();
 
     auto check_acquire = [](const auto&) { return true; };
 
@@ -333,7 +415,6 @@ void tetwild::TetWild::init_from_input_surface(
         std::vector<std::array<size_t, 3>> marked_tet_faces;
         auto success = internal_insert_single_triangle(
             *this,
-            m_vertex_attribute,
             vertices,
             faces[face_id],
             marked_tet_faces,
@@ -341,9 +422,10 @@ void tetwild::TetWild::init_from_input_surface(
             check_acquire,
             check_acquire);
         if (!success) return false;
-        for (auto& f : marked_tet_faces) tet_face_tags[f].push_back(face_id);
+        for (auto& f : marked_tet_faces) tet_face_tags.add(f, face_id);
         return true;
     });
+    wmtk::logger().info("serial insertion {}s", timer.getElapsedTime());
 
     //// track surface, bbox, rounding
     wmtk::logger().info("finished insertion");
@@ -359,41 +441,36 @@ void tetwild::TetWild::finalize_triangle_insertion(
     tbb::task_arena arena(std::max(NUM_THREADS,1));
 
     arena.execute([&faces, this] {
-        tbb::parallel_for(this->tet_face_tags.range(), [&faces, this](auto& r) {
-            auto projected_point_in_triangle = [](auto& c, auto& tri) {
-                std::array<Vector2r, 3> tri2d;
-                int squeeze_to_2d_dir = wmtk::project_triangle_to_2d(tri, tri2d);
-                auto c2d = wmtk::project_point_to_2d(c, squeeze_to_2d_dir);
-                //// should exclude the points on the edges of tri2d -- NO
-                return wmtk::is_point_inside_triangle(c2d, tri2d);
-            };
-            for (auto i = r.begin(); i != r.end(); i++) {
-                auto& vids = i->first;
-                auto fids = i->second;
-                if (fids.empty()) continue;
-
-                Vector3r c =
-                    (m_vertex_attribute[vids[0]].m_pos + m_vertex_attribute[vids[1]].m_pos +
-                     m_vertex_attribute[vids[2]].m_pos) /
-                    3;
-
-                wmtk::vector_unique(fids);
-
-                for (int input_fid : fids) {
-                    std::array<Vector3r, 3> tri = {
-                        m_vertex_attribute[faces[input_fid][0]].m_pos,
-                        m_vertex_attribute[faces[input_fid][1]].m_pos,
-                        m_vertex_attribute[faces[input_fid][2]].m_pos};
-                    if (projected_point_in_triangle(c, tri)) {
-                        auto [_, global_tet_fid] = tuple_from_face(vids);
-                        m_face_attribute[global_tet_fid].m_is_surface_fs = 1;
-                        //
-                        for (auto vid : vids) {
-                            m_vertex_attribute[vid].m_is_on_surface = true;
-                        }
-                        //
-                        break;
+        auto projected_point_in_triangle = [](auto& c, auto& tri) {
+            std::array<Vector2r, 3> tri2d;
+            int squeeze_to_2d_dir = wmtk::project_triangle_to_2d(tri, tri2d);
+            auto c2d = wmtk::project_point_to_2d(c, squeeze_to_2d_dir);
+            //// should exclude the points on the edges of tri2d -- NO
+            return wmtk::is_point_inside_triangle(c2d, tri2d);
+        };
+        this->tet_face_tags.parallel_for_each([&](const auto& vids, const auto& tags) {
+            if (tags.empty()) return;
+            auto fids = tags.to_vector();
+
+            Vector3r c =
+                (get_exact_pos(vids[0]) + get_exact_pos(vids[1]) + get_exact_pos(vids[2])) / 3;
+
+            wmtk::vector_unique(fids);
+
+            for (int input_fid : fids) {
+                std::array<Vector3r, 3> tri = {
+                    get_exact_pos(faces[input_fid][0]),
+                    get_exact_pos(faces[input_fid][1]),
+                    get_exact_pos(faces[input_fid][2])};
+                if (projected_point_in_triangle(c, tri)) {
+                    auto [_, global_tet_fid] = tuple_from_face(vids);
+                    m_face_attribute[global_tet_fid].m_is_surface_fs = 1;
+                    //
+                    for (auto vid : vids) {
+                        m_vertex_attribute[vid].m_is_on_surface = true;
                     }
+                    //
+                    break;
                 }
             }
         });
@@ -404,17 +481,17 @@ void tetwild::TetWild::finalize_triangle_insertion(
         for (int i = 0; i < faces.size(); i++) {
             auto vs = get_face_vertices(faces[i]);
             std::array<size_t, 3> vids = {{vs[0].vid(*this), vs[1].vid(*this), vs[2].vid(*this)}};
+            std::array<Vector3r, 3> ps = {
+                {get_exact_pos(vids[0]), get_exact_pos(vids[1]), get_exact_pos(vids[2])}};
             int on_bbox = -1;
             for (int k = 0; k < 3; k++) {
-                if (m_vertex_attribute[vids[0]].m_pos[k] == m_params.box_min[k] &&
-                    m_vertex_attribute[vids[1]].m_pos[k] == m_params.box_min[k] &&
-                    m_vertex_attribute[vids[2]].m_pos[k] == m_params.box_min[k]) {
+                if (ps[0][k] == m_params.box_min[k] && ps[1][k] == m_params.box_min[k] &&
+                    ps[2][k] == m_params.box_min[k]) {
                     on_bbox = k * 2;
                     break;
                 }
-                if (m_vertex_attribute[vids[0]].m_pos[k] == m_params.box_max[k] &&
-                    m_vertex_attribute[vids[1]].m_pos[k] == m_params.box_max[k] &&
-                    m_vertex_attribute[vids[2]].m_pos[k] == m_params.box_max[k]) {
+                if (ps[0][k] == m_params.box_max[k] && ps[1][k] == m_params.box_max[k] &&
+                    ps[2][k] == m_params.box_max[k]) {
                     on_bbox = k * 2 + 1;
                     break;
                 }
@@ -424,13 +501,10 @@ void tetwild::TetWild::finalize_triangle_insertion(
             m_face_attribute[fid].m_is_bbox_fs = on_bbox;
             //
             for (size_t vid : vids) {
-                m_vertex_attribute[vid].on_bbox_faces.push_back(on_bbox);
+                m_vertex_attribute[vid].on_bbox_faces |= uint8_t(1 << on_bbox);
             }
         }
 
-        for_each_vertex(
-            [&](auto& v) { wmtk::vector_unique(m_vertex_attribute[v.vid(*this)].on_bbox_faces); });
-
         //// rounding
         std::atomic_int cnt_round(0);
 
@@ -441,6 +515,7 @@ void tetwild::TetWild::finalize_triangle_insertion(
 
 
         wmtk::logger().info("cnt_round {}/{}", cnt_round, vert_capacity());
+        recycle_exact_positions();
 
         //// init qualities
         auto& m = *this;
@@ -3,13 +3,17 @@
 #include "Parameters.h"
 #include "TetWild.h"
 #include "common.h"
+#include "sec/envelope/CachedEnvelope.hpp"
 #include "sec/envelope/SampleEnvelope.hpp"
 
 #include <wmtk/TetMesh.h>
 #include <wmtk/utils/Partitioning.h>
+#include <wmtk/utils/Predicates.hpp>
 #include <wmtk/utils/Reader.hpp>
+#include <wmtk/utils/RunReport.hpp>
 
 #include <memory>
+#include <optional>
 #include <vector>
 #include <wmtk/utils/ManifoldUtils.hpp>
 #include <wmtk/utils/partition_utils.hpp>
@@ -39,6 +43,9 @@ int main(int argc, char** argv)
     int NUM_THREADS = 0;
     int max_its = 10;
     bool filter_with_input = false;
+    size_t envelope_cache = 4096;
+    bool resume = false;
+    std::string report_path;
 
     app.add_option("-i,--input", input_path, "Input mesh.");
     app.add_option("-o,--output", output_path, "Output mesh.");
@@ -56,20 +63,50 @@ int main(int argc, char** argv)
         "--sample-envelope",
         use_sample_envelope,
         "use_sample_envelope for both simp and optim");
+    app.add_option(
+        "--envelope-cache",
+        envelope_cache,
+        "envelope queries remembered per thread, 0 disables the cache");
+    app.add_option(
+        "--winding-number-accuracy",
+        params.winding_number_accuracy,
+        "accuracy of the winding numbers filtering the outside, larger is slower, 0 is exact");
+    app.add_option(
+        "--checkpoint",
+        params.checkpoint_path,
+        "file of the checkpoints written during the mesh improvement, writing one needs about "
+        "twice the memory of the mesh");
+    app.add_option(
+        "--checkpoint-interval",
+        params.checkpoint_interval,
+        "minimum seconds between two checkpoints, 0 writes one every iteration");
+    app.add_flag(
+        "--resume",
+        resume,
+        "resume the mesh improvement from --checkpoint, with the same input and envelope");
+    app.add_option("--report", report_path, "file of the phase times and results of the run");
     CLI11_PARSE(app, argc, argv);
+    if (resume && params.checkpoint_path.empty()) {
+        wmtk::logger().error("--resume needs a --checkpoint file");
+        return 1;
+    }
 
     std::vector<Eigen::Vector3d> verts;
     std::vector<std::array<size_t, 3>> tris;
     std::pair<Eigen::Vector3d, Eigen::Vector3d> box_minmax;
     double remove_duplicate_esp = params.epsr;
     std::vector<size_t> modified_nonmanifold_v;
-    wmtk::stl_to_manifold_wmtk_input(
-        input_path,
-        remove_duplicate_esp,
-        box_minmax,
-        verts,
-        tris,
-        modified_nonmanifold_v);
+    {
+        wmtk::ScopedPhase phase("input");
+        wmtk::stl_to_manifold_wmtk_input(
+            input_path,
+            remove_duplicate_esp,
+            box_minmax,
+            verts,
+            tris,
+            modified_nonmanifold_v);
+    }
+    wmtk::RunReport::global().start_total();
 
     double diag = (box_minmax.first - box_minmax.second).norm();
     const double envelope_size = params.epsr * diag;
@@ -79,6 +116,7 @@ int main(int argc, char** argv)
 
 
     if (skip_simplify == false) {
+        wmtk::ScopedPhase phase("simplification");
         wmtk::logger().info("input {} simplification", input_path);
         surf_mesh.collapse_shortest(0);
         surf_mesh.consolidate_mesh();
@@ -123,31 +161,51 @@ int main(int argc, char** argv)
     } else {
         ptr_env = &(exact_envelope);
     }
-    tetwild::TetWild mesh(params, *ptr_env, NUM_THREADS);
+    wmtk::CachedEnvelope cached_envelope(*ptr_env, envelope_cache);
+    tetwild::TetWild mesh(params, cached_envelope, NUM_THREADS);
 
     /////////////////////////////////////////////////////
 
     igl::Timer timer;
     timer.start();
-    std::vector<size_t> partition_id(vsimp.size());
-    wmtk::partition_vertex_morton(
-        vsimp.size(),
-        [&vsimp](auto i) { return vsimp[i]; },
-        std::max(NUM_THREADS, 1),
-        partition_id);
-    /////////triangle insertion with the simplified mesh
-    mesh.init_from_input_surface(vsimp, fsimp, partition_id);
+    std::optional<tetwild::TetWild::ImprovementState> resume_state;
+    if (resume) {
+        // the envelope is rebuilt from the input above, the mesh comes from the checkpoint
+        resume_state = mesh.load_checkpoint(params.checkpoint_path);
+    } else {
+        std::vector<size_t> partition_id(vsimp.size());
+        wmtk::partition_vertex_morton(
+            vsimp.size(),
+            [&vsimp](auto i) { return vsimp[i]; },
+            std::max(NUM_THREADS, 1),
+            partition_id);
+        /////////triangle insertion with the simplified mesh
+        wmtk::ScopedPhase phase("insertion");
+        mesh.init_from_input_surface(vsimp, fsimp, partition_id);
+    }
 
     /////////mesh improvement
-    mesh.mesh_improvement(max_its);
+    mesh.mesh_improvement(max_its, resume_state);
     ////winding number
-    if (filter_with_input)
-        mesh.filter_outside(verts, tris, true);
-    else
-        mesh.filter_outside({}, {}, true);
-    mesh.consolidate_mesh();
+    {
+        wmtk::ScopedPhase phase("filter");
+        if (filter_with_input)
+            mesh.filter_outside(verts, tris, true);
+        else
+            mesh.filter_outside({}, {}, true);
+        mesh.consolidate_mesh();
+    }
     double time = timer.getElapsedTime();
+    wmtk::RunReport::global().stop_total();
     wmtk::logger().info("total time {}s", time);
+    if (cached_envelope.enabled()) {
+        const auto stats = cached_envelope.stats();
+        wmtk::logger().info(
+            "envelope cache hits {} misses {} ({:.1f}%)",
+            stats.hits,
+            stats.misses,
+            100 * stats.hit_rate());
+    }
     if (mesh.tet_size() == 0) {
         wmtk::logger().critical("Empty Output after Filter!");
         return 1;
@@ -166,9 +224,13 @@ int main(int argc, char** argv)
     fout.close();
 
     wmtk::logger().info("final max energy = {} avg = {}", max_energy, avg_energy);
-    mesh.output_mesh(output_path + "_final.msh");
+    {
+        wmtk::ScopedPhase phase("output");
+        mesh.output_mesh(output_path + "_final.msh");
+    }
 
     {
+        wmtk::ScopedPhase phase("output");
         auto outface = std::vector<std::array<size_t, 3>>();
         for (auto f : mesh.get_faces()) {
             auto res = mesh.switch_tetrahedron(f);
@@ -179,12 +241,12 @@ int main(int argc, char** argv)
                 auto vs = mesh.oriented_tet_vertices(f);
                 for (int j = 0; j < 4; j++) {
                     if (std::find(vids.begin(), vids.end(), vs[j].vid(mesh)) == vids.end()) {
-                        auto res = igl::predicates::orient3d(
+                        auto res = wmtk::predicates::orient3d(
                             mesh.m_vertex_attribute[vids[0]].m_posf,
                             mesh.m_vertex_attribute[vids[1]].m_posf,
                             mesh.m_vertex_attribute[vids[2]].m_posf,
                             mesh.m_vertex_attribute[vs[j].vid(mesh)].m_posf);
-                        if (res == igl::predicates::Orientation::NEGATIVE)
+                        if (res < 0)
                             std::swap(vids[1], vids[2]);
                         break;
                     }
@@ -206,5 +268,14 @@ int main(int argc, char** argv)
         wmtk::logger().info("======= finish =========");
     }
 
+    if (!report_path.empty()) {
+        auto& report = wmtk::RunReport::global();
+        report.set("tets", mesh.tet_size());
+        report.set("vertices", mesh.vertex_size());
+        report.set("max_energy", max_energy);
+        report.set("avg_energy", avg_energy);
+        report.write(report_path);
+    }
+
     return 0;
 }
\ No newline at end of file
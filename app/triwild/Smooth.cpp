@@ -74,9 +74,9 @@ bool triwild::TriWild::smooth_after(const Tuple& t)
     // Minimize distortion using newton's method
     vertex_attrs[vid].pos = wmtk::newton_method_from_stack_2d(
         assembles,
-        wmtk::AMIPS2D_energy,
-        wmtk::AMIPS2D_jacobian,
-        wmtk::AMIPS2D_hessian);
+        wmtk::AMIPS2D_energy_batch,
+        wmtk::AMIPS2D_jacobian_batch,
+        wmtk::AMIPS2D_hessian_batch);
 
     // Logging
     wmtk::logger().info(
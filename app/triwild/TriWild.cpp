@@ -2,6 +2,7 @@
 #include <Eigen/Core>
 #include <igl/write_triangle_mesh.h>
 #include <wmtk/utils/AMIPS2D.h>
+#include <wmtk/utils/Predicates.hpp>
 #include <igl/predicates/predicates.h>
 #include <tbb/concurrent_vector.h>
 
@@ -106,7 +107,7 @@ bool TriWild::is_inverted(const Tuple& loc) const
     // Get the vertices ids
     auto vs = oriented_tri_vertices(loc);
 
-    igl::predicates::exactinit();
+    wmtk::predicates::init();
 
     // Use igl for checking orientation
     auto res = igl::predicates::orient2d(
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace wmtk::benchmarks {
+
+struct TetGrid
+{
+    std::vector<Eigen::Vector3d> V;
+    std::vector<std::array<size_t, 4>> T;
+};
+
+/**
+ * @brief Grid of n^3 cubes filling [0, 1]^3, each one split in 6 positively oriented tets around
+ * its main diagonal, so that every size is a conforming mesh with the same local structure.
+ * The interior vertices are moved by a reproducible jitter of up to jitter / n, which keeps the
+ * tets valid for jitter < 0.25 and gives the energies something to optimize.
+ */
+inline TetGrid tet_grid(size_t n, double jitter = 0.)
+{
+    TetGrid grid;
+    const auto vid = [n](size_t i, size_t j, size_t k) { return (i * (n + 1) + j) * (n + 1) + k; };
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-jitter, jitter);
+    grid.V.resize((n + 1) * (n + 1) * (n + 1));
+    for (size_t i = 0; i <= n; i++) {
+        for (size_t j = 0; j <= n; j++) {
+            for (size_t k = 0; k <= n; k++) {
+                Eigen::Vector3d p(i, j, k);
+                const bool interior = i > 0 && j > 0 && k > 0 && i < n && j < n && k < n;
+                if (interior) p += Eigen::Vector3d(dist(gen), dist(gen), dist(gen));
+                grid.V[vid(i, j, k)] = p / double(n);
+            }
+        }
+    }
+
+    // each tet walks from the corner (0, 0, 0) of the cube to (1, 1, 1) one axis at a time
+    const std::array<std::array<int, 3>, 6> axis_orders = {
+        {{{0, 1, 2}}, {{0, 2, 1}}, {{1, 0, 2}}, {{1, 2, 0}}, {{2, 0, 1}}, {{2, 1, 0}}}};
+    grid.T.reserve(6 * n * n * n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            for (size_t k = 0; k < n; k++) {
+                for (const auto& axes : axis_orders) {
+                    std::array<size_t, 3> corner = {i, j, k};
+                    std::array<size_t, 4> tet;
+                    tet[0] = vid(i, j, k);
+                    for (int s = 0; s < 3; s++) {
+                        corner[axes[s]]++;
+                        tet[s + 1] = vid(corner[0], corner[1], corner[2]);
+                    }
+                    const auto& p = grid.V;
+                    const double det = (p[tet[1]] - p[tet[0]])
+                                           .cross(p[tet[2]] - p[tet[0]])
+                                           .dot(p[tet[3]] - p[tet[0]]);
+                    if (det < 0) std::swap(tet[2], tet[3]);
+                    grid.T.push_back(tet);
+                }
+            }
+        }
+    }
+    return grid;
+}
+
+/// Coordinates of a tet in the layout of AMIPS_energy, 4 points of 3 coordinates.
+inline std::array<double, 12> tet_coordinates(
+    const TetGrid& grid,
+    const std::array<size_t, 4>& tet)
+{
+    std::array<double, 12> T;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 3; j++) T[i * 3 + j] = grid.V[tet[i]][j];
+    }
+    return T;
+}
+
+/// Benchmark name with the grid resolution, so that the results of each size can be told apart.
+inline std::string name(const std::string& benchmark, size_t n)
+{
+    return benchmark + " n=" + std::to_string(n);
+}
+
+} // namespace wmtk::benchmarks
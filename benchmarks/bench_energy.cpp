@@ -0,0 +1,115 @@
+#include "SyntheticMesh.hpp"
+
+#include <wmtk/utils/AMIPS.h>
+#include <wmtk/utils/NewtonMethod.hpp>
+#include <wmtk/utils/Rational.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace wmtk;
+using namespace wmtk::benchmarks;
+
+namespace {
+/// the one-ring of every interior vertex, each tet reordered to put the vertex first
+std::vector<std::vector<std::array<double, 12>>> interior_stacks(const TetGrid& grid, size_t n)
+{
+    std::vector<std::vector<std::array<double, 12>>> stacks(grid.V.size());
+    for (const auto& tet : grid.T) {
+        // even permutations moving local vertex k in front
+        static const std::array<std::array<int, 4>, 4> rotations = {
+            {{{0, 1, 2, 3}}, {{1, 0, 3, 2}}, {{2, 3, 0, 1}}, {{3, 2, 1, 0}}}};
+        for (const auto& r : rotations) {
+            stacks[tet[r[0]]].push_back(
+                tet_coordinates(grid, {{tet[r[0]], tet[r[1]], tet[r[2]], tet[r[3]]}}));
+        }
+    }
+    // boundary vertices are not smoothed, they are the ones on the faces of the cube
+    std::vector<std::vector<std::array<double, 12>>> interior;
+    for (size_t v = 0; v < stacks.size(); v++) {
+        const size_t i = v / ((n + 1) * (n + 1)), j = v / (n + 1) % (n + 1), k = v % (n + 1);
+        if (i > 0 && j > 0 && k > 0 && i < n && j < n && k < n) interior.push_back(stacks[v]);
+    }
+    return interior;
+}
+
+Rational orient3d(const std::array<double, 12>& T)
+{
+    std::array<Rational, 9> d;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) d[i * 3 + j] = Rational(T[i * 3 + 3 + j]) - Rational(T[j]);
+    }
+    return d[0] * (d[4] * d[8] - d[5] * d[7]) - d[1] * (d[3] * d[8] - d[5] * d[6]) +
+           d[2] * (d[3] * d[7] - d[4] * d[6]);
+}
+} // namespace
+
+TEST_CASE("amips", "[energy]")
+{
+    const size_t n = GENERATE(as<size_t>(), 4, 8, 16);
+    const auto grid = tet_grid(n, 0.2);
+    std::vector<std::array<double, 12>> tets;
+    for (const auto& tet : grid.T) tets.push_back(tet_coordinates(grid, tet));
+
+    BENCHMARK(name("AMIPS_energy", n))
+    {
+        double sum = 0;
+        for (const auto& T : tets) sum += AMIPS_energy(T);
+        return sum;
+    };
+    BENCHMARK(name("AMIPS_hessian", n))
+    {
+        Eigen::Matrix3d H, sum = Eigen::Matrix3d::Zero();
+        for (const auto& T : tets) {
+            AMIPS_hessian(T, H);
+            sum += H;
+        }
+        return sum;
+    };
+
+    const auto stacks = interior_stacks(grid, n);
+    BENCHMARK(name("newton_method", n))
+    {
+        Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+        for (const auto& stack : stacks) {
+            sum += newton_method<12, 3>(
+                stack,
+                AMIPS_energy_batch,
+                AMIPS_jacobian_batch,
+                AMIPS_hessian_batch);
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("rational", "[energy]")
+{
+    const size_t n = GENERATE(as<size_t>(), 4, 8, 16);
+    const auto grid = tet_grid(n, 0.2);
+    std::vector<std::array<double, 12>> tets;
+    for (const auto& tet : grid.T) tets.push_back(tet_coordinates(grid, tet));
+
+    BENCHMARK(name("Rational orient3d", n))
+    {
+        int sum = 0;
+        for (const auto& T : tets) sum += orient3d(T).get_sign();
+        return sum;
+    };
+    BENCHMARK(name("AMIPS_energy_rational_p3", n))
+    {
+        double sum = 0;
+        for (const auto& T : tets) sum += AMIPS_energy_rational_p3<Rational, double>(T);
+        return sum;
+    };
+
+    // non-dyadic coordinates, as for the vertices that are not rounded, take the GMP path
+    std::vector<std::array<Rational, 12>> rational_tets(tets.size());
+    for (size_t t = 0; t < tets.size(); t++) {
+        for (int i = 0; i < 12; i++) rational_tets[t][i] = Rational(tets[t][i]) / 3;
+    }
+    BENCHMARK(name("AMIPS_energy_rational_p3 rational input", n))
+    {
+        double sum = 0;
+        for (const auto& T : rational_tets) sum += AMIPS_energy_rational_p3<Rational, Rational>(T);
+        return sum;
+    };
+}
@@ -0,0 +1,113 @@
+#include "SyntheticMesh.hpp"
+
+#include <wmtk/TetMesh.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+using namespace wmtk;
+using namespace wmtk::benchmarks;
+
+namespace {
+using Tuple = TetMesh::Tuple;
+
+/**
+ * Measures one pass of an operation over the given elements of fresh copies of the grid. The
+ * meshes are built, and prepared, outside of the measurement since each run modifies its own.
+ */
+template <typename GetElements, typename Prepare, typename Operation>
+void measure_pass(
+    Catch::Benchmark::Chronometer meter,
+    const TetGrid& grid,
+    GetElements&& get_elements,
+    Prepare&& prepare,
+    Operation&& operation)
+{
+    std::vector<std::unique_ptr<TetMesh>> meshes(meter.runs());
+    std::vector<std::vector<Tuple>> elements(meter.runs());
+    for (int i = 0; i < meter.runs(); i++) {
+        meshes[i] = std::make_unique<TetMesh>();
+        meshes[i]->init(grid.V.size(), grid.T);
+        prepare(*meshes[i]);
+        elements[i] = get_elements(*meshes[i]);
+    }
+    meter.measure([&](int i) {
+        auto& m = *meshes[i];
+        std::vector<Tuple> new_tets;
+        size_t success = 0;
+        for (const auto& t : elements[i]) {
+            if (t.is_valid(m) && operation(m, t, new_tets)) success++;
+        }
+        return success;
+    });
+}
+
+const auto edges = [](const TetMesh& m) { return m.get_edges(); };
+const auto faces = [](const TetMesh& m) { return m.get_faces(); };
+const auto nothing = [](TetMesh&) {};
+
+// 2-3 swaps of all the faces, which leaves edges with 3 tets for the 3-2 swaps
+void swap_faces(TetMesh& m)
+{
+    std::vector<Tuple> new_tets;
+    for (const auto& f : m.get_faces()) {
+        if (f.is_valid(m)) m.swap_face(f, new_tets);
+    }
+}
+} // namespace
+
+TEST_CASE("operations", "[operation]")
+{
+    const size_t n = GENERATE(as<size_t>(), 4, 8, 16);
+    const auto grid = tet_grid(n);
+
+    BENCHMARK_ADVANCED(name("split_edge", n))(Catch::Benchmark::Chronometer meter)
+    {
+        measure_pass(meter, grid, edges, nothing, [](TetMesh& m, auto& t, auto& new_tets) {
+            return m.split_edge(t, new_tets);
+        });
+    };
+    BENCHMARK_ADVANCED(name("collapse_edge", n))(Catch::Benchmark::Chronometer meter)
+    {
+        measure_pass(meter, grid, edges, nothing, [](TetMesh& m, auto& t, auto& new_tets) {
+            return m.collapse_edge(t, new_tets);
+        });
+    };
+    BENCHMARK_ADVANCED(name("swap_face", n))(Catch::Benchmark::Chronometer meter)
+    {
+        measure_pass(meter, grid, faces, nothing, [](TetMesh& m, auto& t, auto& new_tets) {
+            return m.swap_face(t, new_tets);
+        });
+    };
+    BENCHMARK_ADVANCED(name("swap_edge", n))(Catch::Benchmark::Chronometer meter)
+    {
+        measure_pass(meter, grid, edges, swap_faces, [](TetMesh& m, auto& t, auto& new_tets) {
+            return m.swap_edge(t, new_tets);
+        });
+    };
+}
+
+TEST_CASE("consolidate_mesh", "[operation]")
+{
+    const size_t n = GENERATE(as<size_t>(), 4, 8, 16);
+    const auto grid = tet_grid(n);
+
+    // collapses leave removed vertices and tets all over the mesh
+    BENCHMARK_ADVANCED(name("consolidate_mesh", n))(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::unique_ptr<TetMesh>> meshes(meter.runs());
+        for (auto& m : meshes) {
+            m = std::make_unique<TetMesh>();
+            m->init(grid.V.size(), grid.T);
+            std::vector<Tuple> new_tets;
+            for (const auto& e : m->get_edges()) {
+                if (e.is_valid(*m)) m->collapse_edge(e, new_tets);
+            }
+        }
+        meter.measure([&](int i) {
+            meshes[i]->consolidate_mesh();
+            return meshes[i]->tet_capacity();
+        });
+    };
+}
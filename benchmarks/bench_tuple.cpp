@@ -0,0 +1,90 @@
+#include "SyntheticMesh.hpp"
+
+#include <wmtk/TetMesh.h>
+
+#include <catch2/catch.hpp>
+
+using namespace wmtk;
+using namespace wmtk::benchmarks;
+
+TEST_CASE("tuple_navigation", "[tuple]")
+{
+    const size_t n = GENERATE(as<size_t>(), 4, 8, 16);
+    const auto grid = tet_grid(n);
+    TetMesh m;
+    m.init(grid.V.size(), grid.T);
+
+    // one tuple for each local edge of each tet
+    std::vector<TetMesh::Tuple> tuples;
+    for (size_t t = 0; t < grid.T.size(); t++) {
+        for (int j = 0; j < 6; j++) tuples.push_back(m.tuple_from_edge(t, j));
+    }
+
+    BENCHMARK(name("switch_vertex", n))
+    {
+        size_t sum = 0;
+        for (const auto& t : tuples) sum += t.switch_vertex(m).vid(m);
+        return sum;
+    };
+    BENCHMARK(name("switch_edge", n))
+    {
+        size_t sum = 0;
+        for (const auto& t : tuples) sum += t.switch_edge(m).vid(m);
+        return sum;
+    };
+    BENCHMARK(name("switch_face", n))
+    {
+        size_t sum = 0;
+        for (const auto& t : tuples) sum += t.switch_face(m).vid(m);
+        return sum;
+    };
+    BENCHMARK(name("switch_tetrahedron", n))
+    {
+        size_t sum = 0;
+        for (const auto& t : tuples) sum += t.switch_tetrahedron(m).has_value();
+        return sum;
+    };
+    BENCHMARK(name("eid", n))
+    {
+        size_t sum = 0;
+        for (const auto& t : tuples) sum += t.eid(m);
+        return sum;
+    };
+    BENCHMARK(name("fid", n))
+    {
+        size_t sum = 0;
+        for (const auto& t : tuples) sum += t.fid(m);
+        return sum;
+    };
+}
+
+TEST_CASE("one_ring_queries", "[tuple]")
+{
+    const size_t n = GENERATE(as<size_t>(), 4, 8, 16);
+    const auto grid = tet_grid(n);
+    TetMesh m;
+    m.init(grid.V.size(), grid.T);
+    const auto vertices = m.get_vertices();
+    const auto edges = m.get_edges();
+
+    BENCHMARK(name("get_edges", n)) { return m.get_edges().size(); };
+    BENCHMARK(name("get_one_ring_vids_for_vertex", n))
+    {
+        size_t sum = 0;
+        for (size_t v = 0; v < m.vert_capacity(); v++)
+            sum += m.get_one_ring_vids_for_vertex(v).size();
+        return sum;
+    };
+    BENCHMARK(name("get_one_ring_tets_for_vertex", n))
+    {
+        size_t sum = 0;
+        for (const auto& v : vertices) sum += m.get_one_ring_tets_for_vertex(v).size();
+        return sum;
+    };
+    BENCHMARK(name("get_one_ring_tets_for_edge", n))
+    {
+        size_t sum = 0;
+        for (const auto& e : edges) sum += m.get_one_ring_tets_for_edge(e).size();
+        return sum;
+    };
+}
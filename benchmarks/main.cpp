@@ -0,0 +1,6 @@
+////////////////////////////////////////////////////////////////////////////////
+// Keep this file empty, and implement benchmarks in separate compilation units!
+////////////////////////////////////////////////////////////////////////////////
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
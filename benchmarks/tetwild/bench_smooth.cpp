@@ -0,0 +1,61 @@
+#include "../SyntheticMesh.hpp"
+
+#include <TetWild.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+using namespace wmtk::benchmarks;
+
+namespace {
+/// a TetWild on the rounded vertices of the grid, smoothed sequentially
+std::unique_ptr<tetwild::TetWild>
+make_tetwild(tetwild::Parameters& params, wmtk::Envelope& envelope, const TetGrid& grid)
+{
+    auto tetwild = std::make_unique<tetwild::TetWild>(params, envelope, 0);
+    std::vector<tetwild::VertexAttributes> vertices(grid.V.size());
+    for (size_t i = 0; i < grid.V.size(); i++) {
+        vertices[i].m_posf = grid.V[i];
+        vertices[i].m_is_rounded = true;
+    }
+    std::vector<tetwild::TetAttributes> tets(grid.T.size());
+    tetwild->init(vertices.size(), grid.T);
+    tetwild->create_mesh_attributes(vertices, tets);
+    return tetwild;
+}
+
+/// one smooth_all_vertices pass over fresh copies of the grid, built outside of the measurement
+void measure_smooth(
+    Catch::Benchmark::Chronometer meter,
+    const TetGrid& grid,
+    double min_relative_decrease,
+    double min_step)
+{
+    tetwild::Parameters params;
+    params.smooth_min_relative_decrease = min_relative_decrease;
+    params.smooth_min_step = min_step;
+    params.init(tetwild::Vector3d(0, 0, 0), tetwild::Vector3d(1, 1, 1));
+    wmtk::Envelope envelope;
+    std::vector<std::unique_ptr<tetwild::TetWild>> meshes(meter.runs());
+    for (auto& m : meshes) m = make_tetwild(params, envelope, grid);
+    meter.measure([&](int i) { meshes[i]->smooth_all_vertices(); });
+}
+} // namespace
+
+TEST_CASE("tetwild_smooth", "[smooth][tetwild]")
+{
+    const size_t n = GENERATE(as<size_t>(), 4, 8, 16);
+    const auto grid = tet_grid(n, 0.2);
+
+    // without the early exits Newton only stops at its iteration cap or on a step of exactly 0
+    BENCHMARK_ADVANCED(name("smooth_all_vertices_full", n))(Catch::Benchmark::Chronometer meter)
+    {
+        measure_smooth(meter, grid, 0., 0.);
+    };
+    BENCHMARK_ADVANCED(name("smooth_all_vertices_early_exit", n))
+    (Catch::Benchmark::Chronometer meter)
+    {
+        measure_smooth(meter, grid, 1e-3, 1e-9);
+    };
+}
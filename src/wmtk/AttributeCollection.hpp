@@ -2,6 +2,7 @@
 
 #include <wmtk/utils/VectorUtils.h>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/MemoryReport.hpp>
 
 #include <tbb/concurrent_vector.h>
 #include <tbb/enumerable_thread_specific.h>
@@ -27,6 +28,10 @@ public:
     virtual void rollback(){};
     virtual void begin_protect(){};
     virtual void end_protect(){};
+    /// the attributes, not counting the heap memory they own
+    virtual MemoryUsage memory_usage() const { return {}; }
+    /// the rollback buffers of all the threads
+    virtual MemoryUsage rollback_memory_usage() const { return {}; }
 };
 
 
@@ -97,6 +102,12 @@ struct AttributeCollection : public AbstractAttributeContainer
 
     const T& at(size_t i) const { return m_attributes[i]; }
 
+    MemoryUsage memory_usage() const override { return wmtk::memory_usage(m_attributes); }
+    MemoryUsage rollback_memory_usage() const override
+    {
+        return wmtk::memory_usage(m_rollback_list);
+    }
+
     size_t size() const { return m_attributes.size(); }
     tbb::enumerable_thread_specific<std::map<size_t, T>> m_rollback_list;
     // experimenting with tbb, could be templated as well.
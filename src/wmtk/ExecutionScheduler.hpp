@@ -3,6 +3,7 @@
 #include "wmtk/TetMesh.h"
 #include "wmtk/TriMesh.h"
 #include "wmtk/utils/Logger.hpp"
+#include "wmtk/utils/Profiler.hpp"
 
 // clang-format off
 #include <functional>
@@ -239,6 +240,7 @@ public:
      */
     bool operator()(AppMesh& m, const std::vector<std::pair<Op, Tuple>>& operation_tuples)
     {
+        WMTK_PROFILE_SCOPE("ExecutePass");
         auto cnt_update = std::atomic<int>(0);
         m_cnt_success = 0;
         m_cnt_fail = 0;
@@ -246,6 +248,22 @@ public:
         m_parallel_queues = std::vector<tbb::concurrent_priority_queue<Elem>>(num_threads);
         m_serial_queue = tbb::concurrent_priority_queue<Elem>();
 
+        // zone names of the operations, interned once per pass, Tracy names its zones either way
+        std::map<Op, const char*> op_zones;
+#ifdef TRACY_ENABLE
+        constexpr bool name_zones = true;
+#else
+        const bool name_zones = Profiler::enabled();
+#endif
+        if (name_zones) {
+            for (const auto& [op, f] : edit_operation_maps)
+                op_zones[op] = Profiler::instance().intern("ExecutePass::" + op);
+        }
+        auto op_zone = [&op_zones](const Op& op) {
+            auto it = op_zones.find(op);
+            return it == op_zones.end() ? "ExecutePass::operation" : it->second;
+        };
+
         auto run_single_queue = [&](auto& Q, int task_id) {
             auto ele_in_queue = Elem();
             while ([&]() { return Q.try_pop(ele_in_queue); }()) {
@@ -255,7 +273,10 @@ public:
                 std::vector<Elem> renewed_elements;
                 {
                     // Note that returning `Tuples` would be invalid.
-                    auto locked_vid = lock_vertices(m, tup, task_id);
+                    auto locked_vid = [&]() {
+                        WMTK_PROFILE_SCOPE("ExecutePass::lock");
+                        return lock_vertices(m, tup, task_id);
+                    }();
                     if (!locked_vid) {
                         retry++;
                         if (retry < max_retry_limit) {
@@ -276,6 +297,7 @@ public:
                             operation_cleanup(m);
                             continue;
                         } // this can encode, in qslim, recompute(energy) == weight.
+                        WMTK_PROFILE_SCOPE_DYNAMIC(op_zone(op));
                         auto newtup = edit_operation_maps[op](m, tup);
                         std::vector<std::pair<Op, Tuple>> renewed_tuples;
                         if (newtup) {
@@ -310,15 +332,29 @@ public:
         };
 
         if constexpr (policy == ExecutionPolicy::kSeq) {
-            for (auto& [op, e] : operation_tuples) {
-                if (!e.is_valid(m)) continue;
-                m_serial_queue.emplace(priority(m, op, e), op, e, 0);
+            {
+                WMTK_PROFILE_SCOPE("ExecutePass::queue");
+                for (auto& [op, e] : operation_tuples) {
+                    if (!e.is_valid(m)) continue;
+                    m_serial_queue.emplace(priority(m, op, e), op, e, 0);
+                }
+                m_initial_queue_size = m_serial_queue.size();
             }
+            WMTK_PROFILE_SCOPE("ExecutePass::serial");
             run_single_queue(m_serial_queue, 0);
         } else {
-            for (auto& [op, e] : operation_tuples) {
-                if (!e.is_valid(m)) continue;
-                m_parallel_queues[get_partition_id(m, e)].emplace(priority(m, op, e), op, e, 0);
+            {
+                WMTK_PROFILE_SCOPE("ExecutePass::queue");
+                for (auto& [op, e] : operation_tuples) {
+                    if (!e.is_valid(m)) continue;
+                    m_parallel_queues[get_partition_id(m, e)].emplace(
+                        priority(m, op, e),
+                        op,
+                        e,
+                        0);
+                }
+                m_initial_queue_size = 0;
+                for (const auto& Q : m_parallel_queues) m_initial_queue_size += Q.size();
             }
             // Comment out parallel: work on serial first.
             tbb::task_arena arena(num_threads);
@@ -326,16 +362,19 @@ public:
             arena.execute([this, &run_single_queue, &tg]() {
                 for (int task_id = 0; task_id < this->m_parallel_queues.size(); task_id++) {
                     tg.run([&run_single_queue, this, task_id] {
+                        WMTK_PROFILE_SCOPE("ExecutePass::parallel");
                         run_single_queue(this->m_parallel_queues[task_id], task_id);
                     });
                 }
                 tg.wait();
             });
             logger().debug("Parallel Complete, remains element {}", m_serial_queue.size());
+            WMTK_PROFILE_SCOPE("ExecutePass::serial");
             run_single_queue(m_serial_queue, 0);
         }
 
         logger().info("cnt_success {} cnt_fail {}", cnt_success(), cnt_fail());
+        logger().debug("memory of the queues\n{}", memory_report().to_string());
         return true;
     }
 
@@ -352,8 +391,29 @@ public:
         return m_parallel_queues;
     }
 
+    /**
+     * @brief The elements of the queues when the last pass started, and those left, e.g. by a
+     * stopping criterion. The queues do not expose their capacity, and the names longer than the
+     * small string buffer are not counted.
+     */
+    MemoryReport memory_report() const
+    {
+        MemoryReport report;
+        const size_t initial = m_initial_queue_size * sizeof(Elem);
+        report.add("initial_queues", {initial, initial});
+        MemoryUsage parallel;
+        for (const auto& Q : m_parallel_queues) parallel.used += Q.size() * sizeof(Elem);
+        parallel.used += m_parallel_queues.size() * sizeof(tbb::concurrent_priority_queue<Elem>);
+        parallel.reserved = parallel.used;
+        report.add("parallel_queues", parallel);
+        const size_t serial = m_serial_queue.size() * sizeof(Elem);
+        report.add("serial_queue", {serial, serial});
+        return report;
+    }
+
     std::atomic<int> m_cnt_success = std::atomic<int>(0);
     std::atomic<int> m_cnt_fail = std::atomic<int>(0);
+    size_t m_initial_queue_size = 0;
 
 protected:
     tbb::concurrent_priority_queue<Elem> m_serial_queue;
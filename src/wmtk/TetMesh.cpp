@@ -1,10 +1,13 @@
 #include <wmtk/TetMesh.h>
 
 #include <wmtk/AttributeCollection.hpp>
+#include <wmtk/utils/MeshSnapshot.hpp>
 #include <wmtk/utils/TupleUtils.hpp>
 #include <wmtk/utils/EnableWarnings.hpp>
 
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 
 #include <Tracy.hpp>
 
@@ -90,6 +93,40 @@ void wmtk::TetMesh::init(size_t n_vertices, const std::vector<std::array<size_t,
     p_edge_attrs->resize(6 * tets.size());
 }
 
+void wmtk::TetMesh::init(const MeshSnapshot& snapshot)
+{
+    if (snapshot.dimension() != 3) throw std::runtime_error("Not a snapshot of a TetMesh");
+    snapshot.check_connectivity();
+    const size_t n_vertices = snapshot.num_vertices();
+    const size_t n_tets = snapshot.num_cells();
+    m_vertex_connectivity.resize(n_vertices);
+    m_tet_connectivity.resize(n_tets);
+    current_vert_size = n_vertices;
+    current_tet_size = n_tets;
+    tbb::parallel_for(size_t(0), n_tets, [&](size_t i) {
+        auto& tet = m_tet_connectivity[i];
+        std::copy_n(snapshot.cells() + 4 * i, 4, tet.m_indices.begin());
+        tet.m_is_removed = snapshot.cell_removed()[i];
+    });
+    tbb::parallel_for(size_t(0), n_vertices, [&](size_t i) {
+        auto& v = m_vertex_connectivity[i];
+        const uint64_t* star = snapshot.stars();
+        v.m_conn_tets.assign(
+            star + snapshot.star_offsets()[i],
+            star + snapshot.star_offsets()[i + 1]);
+        v.m_is_removed = snapshot.vertex_removed()[i];
+    });
+
+    // concurrent
+    m_vertex_mutex.grow_to_at_least(n_vertices);
+
+    // resize attributes
+    p_vertex_attrs->resize(n_vertices);
+    p_tet_attrs->resize(n_tets);
+    p_face_attrs->resize(4 * n_tets);
+    p_edge_attrs->resize(6 * n_tets);
+}
+
 
 std::vector<wmtk::TetMesh::Tuple> wmtk::TetMesh::get_edges() const
 {
@@ -262,6 +299,7 @@ std::vector<wmtk::TetMesh::Tuple> wmtk::TetMesh::get_vertices() const
 
 bool wmtk::TetMesh::smooth_vertex(const Tuple& loc0)
 {
+    WMTK_PROFILE_SCOPE("TetMesh::smooth_vertex");
     if (!smooth_before(loc0)) return false;
     start_protect_attributes();
     if (!smooth_after(loc0) || !invariants(get_one_ring_tets_for_vertex(loc0))) {
@@ -564,8 +602,45 @@ std::vector<wmtk::TetMesh::Tuple> wmtk::TetMesh::get_one_ring_tets_for_edge(cons
 }
 
 
+wmtk::MemoryReport wmtk::TetMesh::memory_report() const
+{
+    MemoryReport report;
+    report.add("tet_connectivity", memory_usage(m_tet_connectivity));
+    report.add("vertex_connectivity", memory_usage(m_vertex_connectivity));
+    report.add(
+        "vertex_stars",
+        tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(0, m_vertex_connectivity.size()),
+            MemoryUsage(),
+            [&](const tbb::blocked_range<size_t>& r, MemoryUsage usage) {
+                for (size_t i = r.begin(); i < r.end(); i++)
+                    usage += memory_usage(m_vertex_connectivity[i].m_conn_tets);
+                return usage;
+            },
+            [](MemoryUsage a, const MemoryUsage& b) { return a += b; }));
+
+    const std::pair<const char*, const AbstractAttributeContainer*> attrs[] = {
+        {"vertex_attrs", p_vertex_attrs},
+        {"edge_attrs", p_edge_attrs},
+        {"face_attrs", p_face_attrs},
+        {"tet_attrs", p_tet_attrs}};
+    MemoryUsage rollback;
+    for (const auto& [name, a] : attrs) {
+        report.add(name, a ? a->memory_usage() : MemoryUsage());
+        if (a) rollback += a->rollback_memory_usage();
+    }
+    report.add("attribute_rollback", rollback);
+
+    report.add("vertex_mutex", memory_usage(m_vertex_mutex));
+    MemoryUsage caches = memory_usage(mutex_release_stack);
+    caches += memory_usage(get_one_ring_cache);
+    report.add("thread_caches", caches);
+    return report;
+}
+
 void wmtk::TetMesh::consolidate_mesh()
 {
+    WMTK_PROFILE_SCOPE("TetMesh::consolidate_mesh");
     auto v_cnt = 0;
     std::vector<size_t> map_v_ids(vert_capacity(), -1);
     for (auto i = 0; i < vert_capacity(); i++) {
@@ -4,6 +4,8 @@
 #include <type_traits>
 #include <wmtk/AttributeCollection.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/MemoryReport.hpp>
+#include <wmtk/utils/Profiler.hpp>
 
 #include <tbb/concurrent_vector.h>
 #include <tbb/enumerable_thread_specific.h>
@@ -20,8 +22,15 @@
 #include <vector>
 
 namespace wmtk {
+class MeshSnapshot;
+class MeshSnapshotWriter;
+class MshStreamWriter;
+
 class TetMesh
 {
+    friend class MeshSnapshotWriter;
+    friend class MshStreamWriter;
+
 private:
     /**
      * @brief local edges within a tet
@@ -351,6 +360,13 @@ public:
      * not exceed `n_vertices`
      */
     void init(size_t n_vertices, const std::vector<std::array<size_t, 4>>& tets);
+    /**
+     * Initialize TetMesh data structure from a snapshot written by MeshSnapshotWriter
+     *
+     * @note The vertex stars and removed flags are copied from the snapshot in parallel, nothing is
+     * rebuilt. Attributes are resized, their values are read by the caller from the snapshot.
+     */
+    void init(const MeshSnapshot& snapshot);
 
     /**
      * Split an edge
@@ -436,6 +452,11 @@ public:
      *
      */
     void consolidate_mesh();
+    /**
+     * @brief the heap memory of the connectivity, the vertex stars, the attributes and their
+     * rollback buffers, the vertex mutexes and the per-thread caches, see MemoryReport
+     */
+    MemoryReport memory_report() const;
 
     /**
      * Get all unique undirected edges in the mesh.
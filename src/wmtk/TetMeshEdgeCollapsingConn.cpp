@@ -12,6 +12,7 @@
 
 bool wmtk::TetMesh::collapse_edge(const Tuple& loc0, std::vector<Tuple>& new_edges)
 {
+    WMTK_PROFILE_SCOPE("TetMesh::collapse_edge");
     if (!collapse_edge_before(loc0)) return false;
 
     auto link_condition = [&VC = this->m_vertex_connectivity,
@@ -5,6 +5,7 @@
 
 bool wmtk::TetMesh::split_edge(const Tuple& loc0, std::vector<Tuple>& new_edges)
 {
+    WMTK_PROFILE_SCOPE("TetMesh::split_edge");
     if (!split_edge_before(loc0)) return false;
 
     // backup of everything
@@ -131,6 +131,7 @@ wmtk::TetMesh::operation_update_connectivity_impl(
 
 bool wmtk::TetMesh::swap_edge(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
 {
+    WMTK_PROFILE_SCOPE("TetMesh::swap_edge");
     // 3-2 edge to face.
     // only swap internal edges, not on boundary.
     // if (t.is_boundary_edge(*this)) return false;
@@ -301,6 +302,7 @@ auto swap_4_4(
 
 bool wmtk::TetMesh::swap_edge_44(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
 {
+    WMTK_PROFILE_SCOPE("TetMesh::swap_edge_44");
     // 4-4 edge to face.
     // only swap internal edges, not on boundary.
     // if (t.is_boundary_edge(*this)) return false;
@@ -408,6 +410,7 @@ bool wmtk::TetMesh::swap_edge_44(const Tuple& t, std::vector<Tuple>& new_tet_tup
 
 bool wmtk::TetMesh::swap_face(const Tuple& t, std::vector<Tuple>& new_tet_tuples)
 {
+    WMTK_PROFILE_SCOPE("TetMesh::swap_face");
     {
         if (t.is_boundary_face(*this)) return false;
         if (!swap_face_before(t)) return false;
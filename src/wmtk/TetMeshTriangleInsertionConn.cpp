@@ -13,6 +13,7 @@ void wmtk::TetMesh::triangle_insertion(
     std::vector<size_t>& new_center_vids,
     std::vector<std::array<size_t, 4>>& center_split_tets)
 {
+    WMTK_PROFILE_SCOPE("TetMesh::triangle_insertion");
     std::vector<size_t> new_tids;
 
     /// get all tets
@@ -394,7 +395,7 @@ void wmtk::TetMesh::subdivide_a_tet(
 
 bool wmtk::TetMesh::insert_point(const Tuple& t, std::vector<Tuple>& new_tets)
 {
-    ZoneScoped;
+    WMTK_PROFILE_SCOPE("TetMesh::insert_point");
     if (!insert_point_before(t)) return false;
     start_protect_attributes();
     if (!insert_point_after(new_tets) || !invariants(new_tets)) {
@@ -3,12 +3,15 @@
 #include <wmtk/TriMesh.h>
 #include <wmtk/AttributeCollection.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/MeshSnapshot.hpp>
 #include <wmtk/utils/TupleUtils.hpp>
 #include "wmtk/utils/VectorUtils.h"
 
 // clang-format off
 #include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 #include <wmtk/utils/EnableWarnings.hpp>
 // clang-format on
 
@@ -233,6 +236,7 @@ bool wmtk::TriMesh::check_edge_manifold() const
 
 bool TriMesh::split_edge(const Tuple& t, std::vector<Tuple>& new_tris)
 {
+    WMTK_PROFILE_SCOPE("TriMesh::split_edge");
     if (!split_edge_before(t)) return false;
     if (!t.is_valid(*this)) return false;
     // get local eid for return tuple construction
@@ -377,6 +381,7 @@ bool TriMesh::split_edge(const Tuple& t, std::vector<Tuple>& new_tris)
 
 bool TriMesh::collapse_edge(const Tuple& loc0, std::vector<Tuple>& new_tris)
 {
+    WMTK_PROFILE_SCOPE("TriMesh::collapse_edge");
     if (!collapse_edge_before(loc0)) {
         return false;
     }
@@ -541,6 +546,7 @@ bool TriMesh::collapse_edge(const Tuple& loc0, std::vector<Tuple>& new_tris)
 
 bool TriMesh::swap_edge(const Tuple& t, std::vector<Tuple>& new_tris)
 {
+    WMTK_PROFILE_SCOPE("TriMesh::swap_edge");
     if (!swap_edge_before(t)) {
         return false;
     }
@@ -621,7 +627,7 @@ bool TriMesh::swap_edge(const Tuple& t, std::vector<Tuple>& new_tris)
 
 bool TriMesh::smooth_vertex(const Tuple& loc0)
 {
-    ZoneScoped;
+    WMTK_PROFILE_SCOPE("TriMesh::smooth_vertex");
     if (!smooth_before(loc0)) return false;
     start_protect_attributes();
     if (!smooth_after(loc0) || !invariants(get_one_ring_tris_for_vertex(loc0))) {
@@ -632,8 +638,43 @@ bool TriMesh::smooth_vertex(const Tuple& loc0)
     return true;
 }
 
+MemoryReport TriMesh::memory_report() const
+{
+    MemoryReport report;
+    report.add("tri_connectivity", memory_usage(m_tri_connectivity));
+    report.add("vertex_connectivity", memory_usage(m_vertex_connectivity));
+    report.add(
+        "vertex_stars",
+        tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(0, m_vertex_connectivity.size()),
+            MemoryUsage(),
+            [&](const tbb::blocked_range<size_t>& r, MemoryUsage usage) {
+                for (size_t i = r.begin(); i < r.end(); i++)
+                    usage += memory_usage(m_vertex_connectivity[i].m_conn_tris);
+                return usage;
+            },
+            [](MemoryUsage a, const MemoryUsage& b) { return a += b; }));
+
+    const std::pair<const char*, const AbstractAttributeContainer*> attrs[] = {
+        {"vertex_attrs", p_vertex_attrs},
+        {"edge_attrs", p_edge_attrs},
+        {"face_attrs", p_face_attrs},};
+    MemoryUsage rollback;
+    for (const auto& [name, a] : attrs) {
+        report.add(name, a ? a->memory_usage() : MemoryUsage());
+        if (a) rollback += a->rollback_memory_usage();
+    }
+    report.add("attribute_rollback", rollback);
+
+    report.add("vertex_mutex", memory_usage(m_vertex_mutex));
+    MemoryUsage caches = memory_usage(mutex_release_stack);
+    report.add("thread_caches", caches);
+    return report;
+}
+
 void TriMesh::consolidate_mesh()
 {
+    WMTK_PROFILE_SCOPE("TriMesh::consolidate_mesh");
     auto v_cnt = 0;
     std::vector<size_t> map_v_ids(vert_capacity(), -1);
     for (auto i = 0; i < vert_capacity(); i++) {
@@ -810,6 +851,39 @@ void TriMesh::create_mesh(size_t n_vertices, const std::vector<std::array<size_t
     if (p_face_attrs) p_face_attrs->resize(tri_capacity());
 }
 
+void TriMesh::create_mesh(const MeshSnapshot& snapshot)
+{
+    if (snapshot.dimension() != 2) throw std::runtime_error("Not a snapshot of a TriMesh");
+    snapshot.check_connectivity();
+    const size_t n_vertices = snapshot.num_vertices();
+    const size_t n_tris = snapshot.num_cells();
+    m_vertex_connectivity.resize(n_vertices);
+    m_tri_connectivity.resize(n_tris);
+    tbb::parallel_for(size_t(0), n_tris, [&](size_t i) {
+        auto& tri = m_tri_connectivity[i];
+        std::copy_n(snapshot.cells() + 3 * i, 3, tri.m_indices.begin());
+        tri.m_is_removed = snapshot.cell_removed()[i];
+        tri.hash = 0;
+    });
+    tbb::parallel_for(size_t(0), n_vertices, [&](size_t i) {
+        auto& v = m_vertex_connectivity[i];
+        const uint64_t* star = snapshot.stars();
+        v.m_conn_tris.assign(
+            star + snapshot.star_offsets()[i],
+            star + snapshot.star_offsets()[i + 1]);
+        v.m_is_removed = snapshot.vertex_removed()[i];
+    });
+    current_vert_size = n_vertices;
+    current_tri_size = n_tris;
+
+    m_vertex_mutex.grow_to_at_least(n_vertices);
+
+    // Resize user class attributes
+    if (p_vertex_attrs) p_vertex_attrs->resize(vert_capacity());
+    if (p_edge_attrs) p_edge_attrs->resize(tri_capacity() * 3);
+    if (p_face_attrs) p_face_attrs->resize(tri_capacity());
+}
+
 std::vector<TriMesh::Tuple> TriMesh::get_vertices() const
 {
     const size_t n_vertices = vert_capacity();
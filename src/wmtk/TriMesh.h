@@ -3,6 +3,8 @@
 #include <wmtk/utils/VectorUtils.h>
 #include <wmtk/AttributeCollection.hpp>
 #include <wmtk/utils/Logger.hpp>
+#include <wmtk/utils/MemoryReport.hpp>
+#include <wmtk/utils/Profiler.hpp>
 
 // clang-format off
 #include <wmtk/utils/DisableWarnings.hpp>
@@ -21,9 +23,13 @@
 #include <vector>
 
 namespace wmtk {
+class MeshSnapshot;
+class MeshSnapshotWriter;
 
 class TriMesh
 {
+    friend class MeshSnapshotWriter;
+
 public:
     // Cell Tuple Navigator
     class Tuple
@@ -232,6 +238,12 @@ public:
      * @param tris triangle connectivity
      */
     void create_mesh(size_t n_vertices, const std::vector<std::array<size_t, 3>>& tris);
+    /**
+     * Generate the connectivity of the mesh from a snapshot written by MeshSnapshotWriter, the
+     * vertex stars are copied from it instead of being rebuilt
+     * @param snapshot of a TriMesh
+     */
+    void create_mesh(const MeshSnapshot& snapshot);
 
     /**
      * Generate a vector of Tuples from global vertex index and __local__ edge index
@@ -390,6 +402,11 @@ public:
      * @param bnd_output when turn on will write the boundary vertices to "bdn_table.dmat"
      */
     void consolidate_mesh();
+    /**
+     * @brief the heap memory of the connectivity, the vertex stars, the attributes and their
+     * rollback buffers, the vertex mutexes and the per-thread caches, see MemoryReport
+     */
+    MemoryReport memory_report() const;
     /**
      * @brief a duplicate of Tuple::switch_vertex funciton
      */
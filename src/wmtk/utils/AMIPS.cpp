@@ -1,24 +1,27 @@
 #include "AMIPS.h"
+#include "EnergyBatch.hpp"
 
 namespace wmtk {
+namespace {
+// Generated expressions, templated on the math (libm or vectorizable) and reading coordinate k
+// at T[k * s] so the same code serves the scalar and the batched (SoA) entry points.
 
-
-
-double AMIPS_energy(const std::array<double, 12>& T)
+template <typename Math>
+WMTK_ALWAYS_INLINE double amips_energy(const double* T, size_t s)
 {
     double helper_0[12];
-    helper_0[0] = T[0];
-    helper_0[1] = T[1];
-    helper_0[2] = T[2];
-    helper_0[3] = T[3];
-    helper_0[4] = T[4];
-    helper_0[5] = T[5];
-    helper_0[6] = T[6];
-    helper_0[7] = T[7];
-    helper_0[8] = T[8];
-    helper_0[9] = T[9];
-    helper_0[10] = T[10];
-    helper_0[11] = T[11];
+    helper_0[0] = T[0 * s];
+    helper_0[1] = T[1 * s];
+    helper_0[2] = T[2 * s];
+    helper_0[3] = T[3 * s];
+    helper_0[4] = T[4 * s];
+    helper_0[5] = T[5 * s];
+    helper_0[6] = T[6 * s];
+    helper_0[7] = T[7 * s];
+    helper_0[8] = T[8 * s];
+    helper_0[9] = T[9 * s];
+    helper_0[10] = T[10 * s];
+    helper_0[11] = T[11 * s];
     double helper_1 = helper_0[2];
     double helper_2 = helper_0[11];
     double helper_3 = helper_0[0];
@@ -62,7 +65,7 @@ double AMIPS_energy(const std::array<double, 12>& T)
           helper_7 * (0.5 * helper_10 + helper_20 - 1.5 * helper_7) +
           helper_8 * (0.5 * helper_10 + 0.5 * helper_7 - 1.5 * helper_8 + 0.5 * helper_9) +
           helper_9 * (0.5 * helper_10 + 0.5 * helper_7 + 0.5 * helper_8 - 1.5 * helper_9)) /
-        std::cbrt(helper_22 * helper_22);
+        Math::cbrt(helper_22 * helper_22);
     //                 * pow(pow((helper_1 - helper_2) * (helper_11 * helper_6 - helper_12 *
     //                 helper_14) -
     //                         (-helper_10 + helper_7) * (-helper_14 * helper_18 + helper_17 *
@@ -72,21 +75,22 @@ double AMIPS_energy(const std::array<double, 12>& T)
     return res;
 }
 
-void AMIPS_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result_0)
+template <typename Math>
+WMTK_ALWAYS_INLINE void amips_jacobian(const double* T, size_t s, double* result_0, size_t rs)
 {
     double helper_0[12];
-    helper_0[0] = T[0];
-    helper_0[1] = T[1];
-    helper_0[2] = T[2];
-    helper_0[3] = T[3];
-    helper_0[4] = T[4];
-    helper_0[5] = T[5];
-    helper_0[6] = T[6];
-    helper_0[7] = T[7];
-    helper_0[8] = T[8];
-    helper_0[9] = T[9];
-    helper_0[10] = T[10];
-    helper_0[11] = T[11];
+    helper_0[0] = T[0 * s];
+    helper_0[1] = T[1 * s];
+    helper_0[2] = T[2 * s];
+    helper_0[3] = T[3 * s];
+    helper_0[4] = T[4 * s];
+    helper_0[5] = T[5 * s];
+    helper_0[6] = T[6 * s];
+    helper_0[7] = T[7 * s];
+    helper_0[8] = T[8 * s];
+    helper_0[9] = T[9 * s];
+    helper_0[10] = T[10 * s];
+    helper_0[11] = T[11 * s];
     double helper_1 = helper_0[1];
     double helper_2 = helper_0[10];
     double helper_3 = helper_1 - helper_2;
@@ -129,7 +133,7 @@ void AMIPS_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result_0)
     double helper_38 = helper_4 - helper_6;
     double helper_39 = helper_23 * helper_3 - helper_24 * (helper_32 - helper_37) -
                        helper_38 * (helper_16 * helper_36 - helper_20 * helper_31);
-    double helper_40 = pow(pow(helper_39, 2), -0.333333333333333);
+    double helper_40 = Math::pow_m13(pow(helper_39, 2));
     double helper_41 = 0.707106781186548 * helper_10 - 0.707106781186548 * helper_12;
     double helper_42 = 0.707106781186548 * helper_26 - 0.707106781186548 * helper_28;
     double helper_43 = 0.5 * helper_21 + 0.5 * helper_5;
@@ -151,7 +155,7 @@ void AMIPS_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result_0)
          helper_8 * (0.5 * helper_14 + helper_45 - 1.5 * helper_8)) /
         helper_39;
     double helper_47 = -0.707106781186548 * helper_21 + 0.707106781186548 * helper_5;
-    result_0[0] = -helper_40 * (1.0 * helper_21 - 3.0 * helper_4 +
+    result_0[0 * rs] = -helper_40 * (1.0 * helper_21 - 3.0 * helper_4 +
                                 helper_46 * (helper_41 * (-helper_1 + helper_2) -
                                              helper_42 * (helper_14 - helper_8) -
                                              (-helper_17 + helper_18 - helper_19) *
@@ -159,31 +163,32 @@ void AMIPS_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result_0)
                                              (-helper_33 + helper_34 - helper_35) *
                                                  (-helper_11 + helper_13 - helper_15 - helper_9)) +
                                 1.0 * helper_5 + 1.0 * helper_6);
-    result_0[1] =
+    result_0[1 * rs] =
         helper_40 * (3.0 * helper_1 - 1.0 * helper_2 - 1.0 * helper_26 - 1.0 * helper_28 +
                      helper_46 * (helper_23 + helper_24 * helper_47 - helper_38 * helper_41));
-    result_0[2] =
+    result_0[2 * rs] =
         helper_40 *
         (-1.0 * helper_10 - 1.0 * helper_12 - 1.0 * helper_14 +
          helper_46 * (-helper_3 * helper_47 - helper_32 + helper_37 + helper_38 * helper_42) +
          3.0 * helper_8);
 }
 
-void AMIPS_hessian(const std::array<double, 12>& T, Eigen::Matrix3d& result_0)
+template <typename Math>
+WMTK_ALWAYS_INLINE void amips_hessian(const double* T, size_t s, double* result_0, size_t rs)
 {
     double helper_0[12];
-    helper_0[0] = T[0];
-    helper_0[1] = T[1];
-    helper_0[2] = T[2];
-    helper_0[3] = T[3];
-    helper_0[4] = T[4];
-    helper_0[5] = T[5];
-    helper_0[6] = T[6];
-    helper_0[7] = T[7];
-    helper_0[8] = T[8];
-    helper_0[9] = T[9];
-    helper_0[10] = T[10];
-    helper_0[11] = T[11];
+    helper_0[0] = T[0 * s];
+    helper_0[1] = T[1 * s];
+    helper_0[2] = T[2 * s];
+    helper_0[3] = T[3 * s];
+    helper_0[4] = T[4 * s];
+    helper_0[5] = T[5 * s];
+    helper_0[6] = T[6 * s];
+    helper_0[7] = T[7 * s];
+    helper_0[8] = T[8 * s];
+    helper_0[9] = T[9 * s];
+    helper_0[10] = T[10 * s];
+    helper_0[11] = T[11 * s];
     double helper_1 = helper_0[2];
     double helper_2 = helper_0[11];
     double helper_3 = helper_1 - helper_2;
@@ -239,7 +244,7 @@ void AMIPS_hessian(const std::array<double, 12>& T, Eigen::Matrix3d& result_0)
     double helper_53 = helper_49 * helper_52;
     double helper_54 = helper_32 + helper_48 - helper_53;
     double helper_55 = pow(helper_54, 2);
-    double helper_56 = pow(helper_55, -0.333333333333333);
+    double helper_56 = Math::pow_m13(helper_55);
     double helper_57 = 1.0 * helper_27 - 3.0 * helper_4 + 1.0 * helper_6 + 1.0 * helper_8;
     double helper_58 = 0.707106781186548 * helper_13;
     double helper_59 = 0.707106781186548 * helper_15;
@@ -273,7 +278,7 @@ void AMIPS_hessian(const std::array<double, 12>& T, Eigen::Matrix3d& result_0)
     double helper_84 = helper_66 * helper_82;
     double helper_85 = -helper_32 - helper_48 + helper_53;
     double helper_86 = 1.0 / helper_85;
-    double helper_87 = helper_86 * pow(pow(helper_85, 2), -0.333333333333333);
+    double helper_87 = helper_86 * Math::pow_m13(pow(helper_85, 2));
     double helper_88 = 0.707106781186548 * helper_6;
     double helper_89 = 0.707106781186548 * helper_27;
     double helper_90 = helper_88 - helper_89;
@@ -326,23 +331,69 @@ void AMIPS_hessian(const std::array<double, 12>& T, Eigen::Matrix3d& result_0)
     double helper_119 = helper_82 * helper_86 *
                         (helper_112 * (-helper_58 + helper_59) - helper_113 * helper_93 -
                          helper_114 * helper_98 + helper_115 * helper_95);
-    result_0(0, 0) =
+    result_0[0 * rs] =
         helper_56 * (helper_57 * helper_64 * helper_65 - pow(helper_64, 2) * helper_83 +
                      0.666666666666667 * helper_64 * helper_84 *
                          (-helper_41 + helper_46 - helper_61 + helper_63) +
                      3.0);
-    result_0(0, 1) = helper_87 * (helper_104 - helper_105 * helper_35 + helper_106 * helper_91);
-    result_0(0, 2) = helper_87 * (helper_106 * helper_107 + helper_111);
-    result_0(1, 0) = helper_87 * (helper_104 + helper_116 * helper_99);
-    result_0(1, 1) =
+    result_0[3 * rs] = helper_87 * (helper_104 - helper_105 * helper_35 + helper_106 * helper_91);
+    result_0[6 * rs] = helper_87 * (helper_106 * helper_107 + helper_111);
+    result_0[1 * rs] = helper_87 * (helper_104 + helper_116 * helper_99);
+    result_0[4 * rs] =
         helper_56 * (-pow(helper_117, 2) * helper_83 + helper_117 * helper_65 * helper_92 +
                      helper_117 * helper_84 * helper_91 + 3.0);
-    result_0(1, 2) = helper_87 * (-helper_105 * helper_6 - helper_107 * helper_116 + helper_118);
-    result_0(2, 0) = helper_87 * (-helper_105 * helper_13 + helper_111 + helper_119 * helper_99);
-    result_0(2, 1) = helper_87 * (helper_118 - helper_119 * helper_91);
-    result_0(2, 2) = helper_56 * (-helper_108 * helper_109 * helper_65 -
+    result_0[7 * rs] = helper_87 * (-helper_105 * helper_6 - helper_107 * helper_116 + helper_118);
+    result_0[2 * rs] = helper_87 * (-helper_105 * helper_13 + helper_111 + helper_119 * helper_99);
+    result_0[5 * rs] = helper_87 * (helper_118 - helper_119 * helper_91);
+    result_0[8 * rs] = helper_56 * (-helper_108 * helper_109 * helper_65 -
                                   1.11111111111111 * pow(helper_109, 2) * helper_84 + 3.0);
 }
+} // namespace
+
+double AMIPS_energy(const std::array<double, 12>& T)
+{
+    return amips_energy<energy_batch::ScalarMath>(T.data(), 1);
+}
+
+void AMIPS_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result_0)
+{
+    amips_jacobian<energy_batch::ScalarMath>(T.data(), 1, result_0.data(), 1);
+}
+
+void AMIPS_hessian(const std::array<double, 12>& T, Eigen::Matrix3d& result_0)
+{
+    amips_hessian<energy_batch::ScalarMath>(T.data(), 1, result_0.data(), 1);
+}
+
+WMTK_BATCH_TARGETS
+void AMIPS_energy_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++) result[i] = amips_energy<energy_batch::SimdMath>(T + i, stride);
+}
 
+WMTK_BATCH_TARGETS
+void AMIPS_jacobian_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++)
+        amips_jacobian<energy_batch::SimdMath>(T + i, stride, result + i, stride);
+}
 
-} // namespace wmtk
\ No newline at end of file
+WMTK_BATCH_TARGETS
+void AMIPS_hessian_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++)
+        amips_hessian<energy_batch::SimdMath>(T + i, stride, result + i, stride);
+}
+} // namespace wmtk
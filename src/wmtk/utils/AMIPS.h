@@ -9,6 +9,16 @@ namespace wmtk {
 double AMIPS_energy(const std::array<double, 12>& T);
 void AMIPS_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result_0);
 void AMIPS_hessian(const std::array<double, 12>& T, Eigen::Matrix3d& result_0);
+
+/**
+ * @brief Batched AMIPS over n tets in structure-of-arrays layout: coordinate k of tet i is
+ * T[k * stride + i] (see EnergyBatch.hpp). Writes result[i], result[d * stride + i] for the
+ * jacobian and result[(c * 3 + r) * stride + i] for the Hessian. Matches the scalar functions up
+ * to rounding.
+ */
+void AMIPS_energy_batch(size_t n, const double* T, size_t stride, double* result);
+void AMIPS_jacobian_batch(size_t n, const double* T, size_t stride, double* result);
+void AMIPS_hessian_batch(size_t n, const double* T, size_t stride, double* result);
 template <typename rational, typename dtype>
 double AMIPS_energy_rational_p3(const std::array<dtype, 12>& T){
      std::array<rational, 12> r_T;
@@ -7,15 +7,19 @@
 //
 
 #include "AMIPS2D.h"
+#include "EnergyBatch.hpp"
 
-double wmtk::AMIPS2D_energy(const std::array<double, 6>& T){
+namespace {
+// Generated expressions, coordinate k at T[k * s] (see AMIPS.cpp).
+template <typename Math>
+WMTK_ALWAYS_INLINE double amips2d_energy(const double* T, size_t s){
     double helper_0[6];
-    helper_0[0] = T[0];
-    helper_0[1] = T[1];
-    helper_0[2] = T[2];
-    helper_0[3] = T[3];
-    helper_0[4] = T[4];
-    helper_0[5] = T[5];
+    helper_0[0] = T[0 * s];
+    helper_0[1] = T[1 * s];
+    helper_0[2] = T[2 * s];
+    helper_0[3] = T[3 * s];
+    helper_0[4] = T[4 * s];
+    helper_0[5] = T[5 * s];
     double helper_1 = helper_0[0];
     double helper_2 = helper_0[2];
     double helper_3 = helper_0[1];
@@ -27,14 +31,15 @@ double wmtk::AMIPS2D_energy(const std::array<double, 6>& T){
     return -(helper_1*(-1.33333333333333*helper_1 + 0.666666666666667*helper_2 + helper_7) + helper_2*(0.666666666666667*helper_1 - 1.33333333333333*helper_2 + helper_7) + helper_3*(-1.33333333333333*helper_3 + 0.666666666666667*helper_4 + helper_8) + helper_4*(0.666666666666667*helper_3 - 1.33333333333333*helper_4 + helper_8) + helper_5*(0.666666666666667*helper_3 + 0.666666666666667*helper_4 - 1.33333333333333*helper_5) + helper_6*(0.666666666666667*helper_1 + 0.666666666666667*helper_2 - 1.33333333333333*helper_6))/((helper_1 - helper_2)*(0.577350269189626*helper_3 + 0.577350269189626*helper_4 - 1.15470053837925*helper_5) - (helper_3 - helper_4)*(0.577350269189626*helper_1 + 0.577350269189626*helper_2 - 1.15470053837925*helper_6));
 }
 
-void wmtk::AMIPS2D_jacobian(const std::array<double, 6>& T, Eigen::Vector2d& result_0){
+template <typename Math>
+WMTK_ALWAYS_INLINE void amips2d_jacobian(const double* T, size_t s, double* result_0, size_t rs){
     double helper_0[6];
-    helper_0[0] = T[0];
-    helper_0[1] = T[1];
-    helper_0[2] = T[2];
-    helper_0[3] = T[3];
-    helper_0[4] = T[4];
-    helper_0[5] = T[5];
+    helper_0[0] = T[0 * s];
+    helper_0[1] = T[1 * s];
+    helper_0[2] = T[2 * s];
+    helper_0[3] = T[3 * s];
+    helper_0[4] = T[4 * s];
+    helper_0[5] = T[5 * s];
     double helper_1 = helper_0[0];
     double helper_2 = helper_0[2];
     double helper_3 = helper_0[1];
@@ -47,18 +52,19 @@ void wmtk::AMIPS2D_jacobian(const std::array<double, 6>& T, Eigen::Vector2d& res
     double helper_10 = 0.666666666666667*helper_5;
     double helper_11 = 1.33333333333333*helper_5;
     double helper_12 = 1.15470053837925*helper_7*(helper_1*(-1.33333333333333*helper_1 + 0.666666666666667*helper_2 + helper_9) + helper_2*(0.666666666666667*helper_1 - 1.33333333333333*helper_2 + helper_9) + helper_3*(helper_10 - 1.33333333333333*helper_3 + 0.666666666666667*helper_4) + helper_4*(helper_10 + 0.666666666666667*helper_3 - 1.33333333333333*helper_4) + helper_5*(-helper_11 + 0.666666666666667*helper_3 + 0.666666666666667*helper_4) + helper_6*(0.666666666666667*helper_1 + 0.666666666666667*helper_2 + helper_8));
-    result_0(0) = helper_7*(2.66666666666667*helper_1 + helper_12*(helper_4 - helper_5) - 1.33333333333333*helper_2 + helper_8);
-    result_0(1) = -helper_7*(helper_11 + helper_12*(helper_2 - helper_6) - 2.66666666666667*helper_3 + 1.33333333333333*helper_4);
+    result_0[0 * rs] = helper_7*(2.66666666666667*helper_1 + helper_12*(helper_4 - helper_5) - 1.33333333333333*helper_2 + helper_8);
+    result_0[1 * rs] = -helper_7*(helper_11 + helper_12*(helper_2 - helper_6) - 2.66666666666667*helper_3 + 1.33333333333333*helper_4);
 }
 
-void wmtk::AMIPS2D_hessian(const std::array<double, 6>& T, Eigen::Matrix2d& result_0){
+template <typename Math>
+WMTK_ALWAYS_INLINE void amips2d_hessian(const double* T, size_t s, double* result_0, size_t rs){
     double helper_0[6];
-    helper_0[0] = T[0];
-    helper_0[1] = T[1];
-    helper_0[2] = T[2];
-    helper_0[3] = T[3];
-    helper_0[4] = T[4];
-    helper_0[5] = T[5];
+    helper_0[0] = T[0 * s];
+    helper_0[1] = T[1 * s];
+    helper_0[2] = T[2 * s];
+    helper_0[3] = T[3 * s];
+    helper_0[4] = T[4 * s];
+    helper_0[5] = T[5 * s];
     double helper_1 = helper_0[0];
     double helper_2 = helper_0[2];
     double helper_3 = helper_0[1];
@@ -71,7 +77,7 @@ void wmtk::AMIPS2D_hessian(const std::array<double, 6>& T, Eigen::Matrix2d& resu
     double helper_10 = 1.33333333333333*helper_6;
     double helper_11 = -2.66666666666667*helper_1 + helper_10 + 1.33333333333333*helper_2;
     double helper_12 = 2.3094010767585*helper_8;
-    double helper_13 = pow(helper_7, -2);
+    double helper_13 = Math::pow_m2(helper_7);
     double helper_14 = 0.666666666666667*helper_6;
     double helper_15 = 0.666666666666667*helper_5;
     double helper_16 = 1.33333333333333*helper_5;
@@ -80,10 +86,60 @@ void wmtk::AMIPS2D_hessian(const std::array<double, 6>& T, Eigen::Matrix2d& resu
     double helper_19 = helper_2 - helper_6;
     double helper_20 = helper_16 - 2.66666666666667*helper_3 + 1.33333333333333*helper_4;
     double helper_21 = helper_13*(-1.15470053837925*helper_11*helper_19 + 2.66666666666667*helper_17*helper_19*helper_8*helper_9 + 1.15470053837925*helper_20*helper_9);
-    result_0(0) = helper_8*(helper_11*helper_12*helper_9 - helper_18*pow(helper_9, 2) + 2.66666666666667);
-    result_0(1) = helper_21;
-    result_0(2) = helper_21;
-    result_0(3) = helper_8*(-helper_12*helper_19*helper_20 - helper_18*pow(helper_19, 2) + 2.66666666666667);
+    result_0[0 * rs] = helper_8*(helper_11*helper_12*helper_9 - helper_18*pow(helper_9, 2) + 2.66666666666667);
+    result_0[1 * rs] = helper_21;
+    result_0[2 * rs] = helper_21;
+    result_0[3 * rs] = helper_8*(-helper_12*helper_19*helper_20 - helper_18*pow(helper_19, 2) + 2.66666666666667);
+}
+
+} // namespace
+
+double wmtk::AMIPS2D_energy(const std::array<double, 6>& T)
+{
+    return amips2d_energy<energy_batch::ScalarMath>(T.data(), 1);
+}
+
+void wmtk::AMIPS2D_jacobian(const std::array<double, 6>& T, Eigen::Vector2d& result_0)
+{
+    amips2d_jacobian<energy_batch::ScalarMath>(T.data(), 1, result_0.data(), 1);
+}
+
+void wmtk::AMIPS2D_hessian(const std::array<double, 6>& T, Eigen::Matrix2d& result_0)
+{
+    amips2d_hessian<energy_batch::ScalarMath>(T.data(), 1, result_0.data(), 1);
+}
+
+WMTK_BATCH_TARGETS
+void wmtk::AMIPS2D_energy_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++)
+        result[i] = amips2d_energy<energy_batch::SimdMath>(T + i, stride);
+}
+
+WMTK_BATCH_TARGETS
+void wmtk::AMIPS2D_jacobian_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++)
+        amips2d_jacobian<energy_batch::SimdMath>(T + i, stride, result + i, stride);
+}
+
+WMTK_BATCH_TARGETS
+void wmtk::AMIPS2D_hessian_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++)
+        amips2d_hessian<energy_batch::SimdMath>(T + i, stride, result + i, stride);
 }
 
 // double wmtk::AMIPS2D_energy(const feature::FeatureElement &feature, const double t, const std::array<double, 6>& T)
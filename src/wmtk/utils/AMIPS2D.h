@@ -14,6 +14,11 @@ namespace wmtk {
     void AMIPS2D_jacobian(const std::array<double, 6>& T, Eigen::Vector2d& J);
     void AMIPS2D_hessian(const std::array<double, 6>& T, Eigen::Matrix2d& H);
 
+    // Batched versions, coordinate k of triangle i at T[k * stride + i] (see EnergyBatch.hpp).
+    void AMIPS2D_energy_batch(size_t n, const double* T, size_t stride, double* result);
+    void AMIPS2D_jacobian_batch(size_t n, const double* T, size_t stride, double* result);
+    void AMIPS2D_hessian_batch(size_t n, const double* T, size_t stride, double* result);
+
     // TODO add support for features
     // double AMIPS2D_energy(const feature::FeatureElement &feature, const double t, const std::array<double, 6>& T);
     // double AMIPS2D_jacobian(const feature::FeatureElement &feature, const double t, const std::array<double, 6>& T);
@@ -2,27 +2,58 @@
 
 // clang-format off
 #include <wmtk/utils/DisableWarnings.hpp>
+#include <geogram/basic/process.h>
 #include <geogram/delaunay/delaunay.h>
+#include <tbb/task_arena.h>
 #include <wmtk/utils/EnableWarnings.hpp>
 // clang-format on
 
 
 #include <cassert>
 #include <mutex>
+#include <optional>
 
 namespace wmtk {
 
-auto delaunay3D(const std::vector<Point3D>& points)
+namespace {
+// restores geogram's global thread limit on destruction
+class MaxThreadsGuard
+{
+public:
+    MaxThreadsGuard()
+        : m_max_threads(GEO::Process::maximum_concurrent_threads())
+    {}
+    ~MaxThreadsGuard() { GEO::Process::set_max_threads(m_max_threads); }
+    MaxThreadsGuard(const MaxThreadsGuard&) = delete;
+    MaxThreadsGuard& operator=(const MaxThreadsGuard&) = delete;
+
+private:
+    const GEO::index_t m_max_threads;
+};
+} // namespace
+
+auto delaunay3D(const std::vector<Point3D>& points, DelaunayInsertion insertion)
     -> std::pair<std::vector<Point3D>, std::vector<Tetrahedron>>
 {
     static std::once_flag once_flag;
     std::call_once(once_flag, []() { GEO::initialize(); });
 
-    GEO::Delaunay_var engine = GEO::Delaunay::create(3, "BDEL");
+    GEO::Delaunay_var engine;
+    std::optional<MaxThreadsGuard> max_threads_guard;
+    if (insertion == DelaunayInsertion::Parallel) {
+        max_threads_guard.emplace();
+        // PDEL runs geogram's own threads, not TBB tasks, limit them to the calling arena
+        GEO::Process::set_max_threads(GEO::index_t(tbb::this_task_arena::max_concurrency()));
+        // PDEL is missing from geogram builds without it, fall back to the sequential one
+        engine = GEO::Delaunay::create(3, "PDEL");
+    }
+    if (!engine) engine = GEO::Delaunay::create(3, "BDEL");
     assert(engine);
 
     // Some settings
-    engine->set_reorder(false);
+    // The reordering only changes the insertion order: geogram keeps the vertices in the order
+    // they are given and the cells refer to the input indices, so nothing needs to be mapped back.
+    engine->set_reorder(insertion != DelaunayInsertion::Input);
     engine->set_stores_cicl(false); // Incident tetrahedral list.
     engine->set_stores_neighbors(false); // Vertex neighbors.
     engine->set_refine(false);
@@ -10,9 +10,20 @@ using Tetrahedron = std::array<size_t, 4>;
 using Point2D = std::array<double, 2>;
 using Triangle = std::array<size_t, 3>;
 
+/**
+ * Order in which delaunay3D inserts the points.
+ */
+enum class DelaunayInsertion {
+    Input, // sequential, in the order of the input
+    Reordered, // sequential, in BRIO order (random rounds, each sorted along a Hilbert curve)
+    Parallel // geogram's multi-threaded "PDEL", in BRIO order, as many threads as the TBB arena
+};
+
 /**
  * Compute the Delaunay tetrahedralization of the input 3D points.
  * @param[in] points
+ * @param[in] insertion only changes the order in which the points are inserted, the tets always
+ * refer to the indices of the input points
  *
  * @returns A tuple of (vertices, tets).
  *
@@ -21,7 +32,9 @@ using Triangle = std::array<size_t, 3>;
  *     // Populate points.
  *     auto [vertices, tets] = delaunay3D(points);
  */
-auto delaunay3D(const std::vector<Point3D>& points)
+auto delaunay3D(
+    const std::vector<Point3D>& points,
+    DelaunayInsertion insertion = DelaunayInsertion::Input)
     -> std::pair<std::vector<Point3D>, std::vector<Tetrahedron>>;
 
 
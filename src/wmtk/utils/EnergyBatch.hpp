@@ -0,0 +1,250 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+/**
+ * Batched (structure-of-arrays) evaluation of the per-element energies.
+ *
+ * A batch of n elements is stored coordinate-major: coordinate k of element i is at
+ * T[k * stride + i], with stride >= n. Outputs use the same layout, e.g. the jacobian entry d of
+ * element i is at result[d * stride + i] and the Hessian entry (r, c) at
+ * result[(c * dim + r) * stride + i] (column-major, as Eigen). This lets the compiler evaluate
+ * the generated expressions for consecutive elements in SIMD lanes.
+ *
+ * The batch entry points are compiled for AVX-512, AVX2 and baseline x86-64 and the best one is
+ * picked at load time, so no special build flags are needed.
+ */
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+// vectorize with the dynamic cost model also in -O2 builds
+#define WMTK_BATCH_TARGETS                                                              \
+    __attribute__((                                                                     \
+        target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default"),                \
+        optimize("tree-vectorize", "vect-cost-model=dynamic")))
+#else
+#define WMTK_BATCH_TARGETS
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WMTK_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define WMTK_ALWAYS_INLINE __forceinline
+#else
+#define WMTK_ALWAYS_INLINE inline
+#endif
+
+namespace wmtk::energy_batch {
+
+/**
+ * @brief Signature of the batched energies, jacobians and Hessians, e.g. AMIPS_energy_batch.
+ */
+using BatchFunction = void (*)(size_t n, const double* T, size_t stride, double* result);
+
+/**
+ * @brief Math used by the scalar energies, libm calls as in the generated code.
+ */
+struct ScalarMath
+{
+    static double cbrt(double x) { return std::cbrt(x); }
+    static double pow_m13(double x) { return std::pow(x, -0.333333333333333); }
+    static double pow_m2(double x) { return std::pow(x, -2); }
+};
+
+/**
+ * @brief Branch- and call-free math so the batch loops vectorize. Only valid for the arguments
+ * the energies use: cbrt and pow_m13 take squares (x >= 0).
+ */
+struct SimdMath
+{
+    WMTK_ALWAYS_INLINE static double cbrt(double x)
+    {
+        // the guess below is only good for normal numbers away from the ends of the range, the
+        // others are scaled by 2^(-+750) first (selects, not branches) and the root by 2^(+-250)
+        const double scale = x > 0x1p700 ? 0x1p-750 : (x < 0x1p-700 ? 0x1p750 : 1.);
+        const double unscale = x > 0x1p700 ? 0x1p250 : (x < 0x1p-700 ? 0x1p-250 : 1.);
+        const double xs = x * scale;
+        // initial guess: divide the exponent (and mantissa bits) by 3, 1/3 = sum_k 4^-k
+        uint64_t i;
+        std::memcpy(&i, &xs, sizeof(double));
+        uint64_t t = (i >> 2) + (i >> 4);
+        t += t >> 4;
+        t += t >> 8;
+        t += t >> 16;
+        t += t >> 32;
+        t += 0x2A9F7893782DA1CEull;
+        double y;
+        std::memcpy(&y, &t, sizeof(double));
+        // three Halley steps reach ~1 ulp, unrolled by hand so -O2 vectorizes the caller
+        y = halley_step(y, xs);
+        y = halley_step(y, xs);
+        y = halley_step(y, xs);
+        // 0, inf and nan are their own roots
+        return x == 0 || !(x <= std::numeric_limits<double>::max()) ? x : y * unscale;
+    }
+    WMTK_ALWAYS_INLINE static double pow_m13(double x) { return 1.0 / cbrt(x); }
+    WMTK_ALWAYS_INLINE static double pow_m2(double x) { return 1.0 / (x * x); }
+
+private:
+    WMTK_ALWAYS_INLINE static double halley_step(double y, double x)
+    {
+        const double y3 = y * y * y;
+        return y * (y3 + 2 * x) / (2 * y3 + x);
+    }
+};
+
+/**
+ * @brief A local stack (mover vertex in front, as for newton_method_from_stack) packed once in
+ * the batch layout. Only the coordinates of the mover are rewritten between evaluations.
+ *
+ * One-rings of up to Capacity elements live in an inline buffer, larger ones fall back to the
+ * heap.
+ *
+ * @tparam N number of coordinates per element (12 for tets, 6 for triangles)
+ * @tparam dim dimension of the mover
+ */
+template <int N, int dim, size_t Capacity = 48>
+class BatchStack
+{
+public:
+    using Vector = Eigen::Matrix<double, dim, 1>;
+    using Matrix = Eigen::Matrix<double, dim, dim>;
+
+    explicit BatchStack(const std::vector<std::array<double, N>>& stack)
+        : m_n(stack.size())
+        , m_stride((stack.size() + 7) / 8 * 8) // pad rows to whole AVX-512 vectors
+    {
+        if (m_stride <= Capacity) {
+            m_T = m_T_local.data();
+            m_out = m_out_local.data();
+        } else {
+            m_heap.resize((N + dim * dim) * m_stride);
+            m_T = m_heap.data();
+            m_out = m_T + N * m_stride;
+        }
+        for (int k = 0; k < N; k++) {
+            for (size_t i = 0; i < m_n; i++) m_T[k * m_stride + i] = stack[i][k];
+            std::fill(m_T + k * m_stride + m_n, m_T + (k + 1) * m_stride, 0.);
+        }
+    }
+    BatchStack(const BatchStack&) = delete;
+    BatchStack& operator=(const BatchStack&) = delete;
+
+    size_t size() const { return m_n; }
+
+    Vector front() const
+    {
+        Vector pos;
+        for (int j = 0; j < dim; j++) pos[j] = m_T[j * m_stride];
+        return pos;
+    }
+
+    void set_front(const Vector& pos)
+    {
+        for (int j = 0; j < dim; j++) std::fill_n(m_T + j * m_stride, m_n, pos[j]);
+    }
+
+    /**
+     * @param f any callable with the BatchFunction signature
+     */
+    template <typename F>
+    double energy(F&& f)
+    {
+        f(m_n, m_T, m_stride, m_out);
+        return sum(0);
+    }
+
+    template <typename F>
+    Vector jacobian(F&& f)
+    {
+        f(m_n, m_T, m_stride, m_out);
+        Vector res;
+        for (int d = 0; d < dim; d++) res[d] = sum(d);
+        return res;
+    }
+
+    template <typename F>
+    Matrix hessian(F&& f)
+    {
+        f(m_n, m_T, m_stride, m_out);
+        Matrix res;
+        for (int d = 0; d < dim * dim; d++) res.data()[d] = sum(d);
+        return res;
+    }
+
+private:
+    double sum(int row) const
+    {
+        const double* it = m_out + row * m_stride;
+        double s = 0.;
+        for (size_t i = 0; i < m_n; i++) s += it[i];
+        return s;
+    }
+
+    size_t m_n;
+    size_t m_stride;
+    double* m_T;
+    double* m_out;
+    std::array<double, N * Capacity> m_T_local;
+    std::array<double, dim * dim * Capacity> m_out_local;
+    std::vector<double> m_heap;
+};
+
+/**
+ * @brief Adapts a per-element energy, double(const std::array<double, N>&), to the batch
+ * signature. The kernel is called directly, not through std::function, so it can be inlined.
+ */
+template <int N, typename F>
+auto per_element_energy(F f)
+{
+    return [f](size_t n, const double* T, size_t stride, double* result) {
+        std::array<double, N> e;
+        for (size_t i = 0; i < n; i++) {
+            for (int k = 0; k < N; k++) e[k] = T[k * stride + i];
+            result[i] = f(e);
+        }
+    };
+}
+
+/**
+ * @brief Same as per_element_energy for void(const std::array<double, N>&, Vector&).
+ */
+template <int N, int dim, typename F>
+auto per_element_jacobian(F f)
+{
+    return [f](size_t n, const double* T, size_t stride, double* result) {
+        std::array<double, N> e;
+        Eigen::Matrix<double, dim, 1> g;
+        for (size_t i = 0; i < n; i++) {
+            for (int k = 0; k < N; k++) e[k] = T[k * stride + i];
+            f(e, g);
+            for (int d = 0; d < dim; d++) result[d * stride + i] = g[d];
+        }
+    };
+}
+
+/**
+ * @brief Same as per_element_energy for void(const std::array<double, N>&, Matrix&).
+ */
+template <int N, int dim, typename F>
+auto per_element_hessian(F f)
+{
+    return [f](size_t n, const double* T, size_t stride, double* result) {
+        std::array<double, N> e;
+        Eigen::Matrix<double, dim, dim> h;
+        for (size_t i = 0; i < n; i++) {
+            for (int k = 0; k < N; k++) e[k] = T[k * stride + i];
+            f(e, h);
+            for (int d = 0; d < dim * dim; d++) result[d * stride + i] = h.data()[d];
+        }
+    };
+}
+
+} // namespace wmtk::energy_batch
@@ -1,4 +1,5 @@
 #include "EnergyHarmonicTet.hpp"
+#include "EnergyBatch.hpp"
 #include <limits>
 // Generated with following snippet with some text replacement.
 // Also modified for infinity evaluation
@@ -33,47 +34,48 @@
 //         output.write("\n")
 // ```
 using std::pow;
-double wmtk::harmonic_tet_energy(const std::array<double, 12>& T)
+namespace {
+// coordinate k at T[k * s] so the same code serves the scalar and the batched entry points
+WMTK_ALWAYS_INLINE double harmonic_energy_kernel(const double* T, size_t s)
 {
-    double helper0 = T[0] * T[10];
-    double helper1 = T[0] * T[11];
-    double helper2 = T[5] * T[7];
-    double helper3 = T[10] * T[2];
-    double helper4 = T[5] * T[6];
-    double helper5 = T[11] * T[1];
-    double helper6 = T[3] * T[7];
-    double helper7 = T[3] * T[8];
-    double helper8 = T[1] * T[9];
-    double helper9 = T[4] * T[6];
-    double helper10 = T[2] * T[9];
-    double helper11 = T[4] * T[8];
-    double helper12 = T[0] - T[3];
-    double helper13 = -T[10];
-    double helper14 = T[1] + helper13;
-    double helper15 = -T[9];
-    double helper16 = T[0] + helper15;
-    double helper17 = T[1] - T[4];
-    double helper18 = T[2] - T[5];
-    double helper19 = -T[11];
-    double helper20 = T[2] + helper19;
-    double helper21 = -T[7];
-    double helper22 = T[1] + helper21;
-    double helper23 = -T[6];
-    double helper24 = T[0] + helper23;
-    double helper25 = -T[8];
-    double helper26 = T[2] + helper25;
-    double helper27 = T[4] + helper13;
-    double helper28 = T[3] + helper23;
-    double helper29 = T[3] + helper15;
-    double helper30 = T[4] + helper21;
-    double helper31 = T[5] + helper19;
-    double helper32 = T[5] + helper25;
-    auto denom = (-T[0] * helper11 + T[0] * helper2 + T[10] * helper4 - T[10] * helper7 + T[11] * helper6 -
-         T[11] * helper9 - T[1] * helper4 + T[1] * helper7 - T[2] * helper6 + T[2] * helper9 +
-         T[3] * helper3 - T[3] * helper5 + T[4] * helper1 - T[4] * helper10 - T[5] * helper0 +
-         T[5] * helper8 - T[6] * helper3 + T[6] * helper5 - T[7] * helper1 + T[7] * helper10 +
-         T[8] * helper0 - T[8] * helper8 + T[9] * helper11 - T[9] * helper2);
-    if (denom < 0) return std::numeric_limits<double>::infinity();
+    double helper0 = T[0 * s] * T[10 * s];
+    double helper1 = T[0 * s] * T[11 * s];
+    double helper2 = T[5 * s] * T[7 * s];
+    double helper3 = T[10 * s] * T[2 * s];
+    double helper4 = T[5 * s] * T[6 * s];
+    double helper5 = T[11 * s] * T[1 * s];
+    double helper6 = T[3 * s] * T[7 * s];
+    double helper7 = T[3 * s] * T[8 * s];
+    double helper8 = T[1 * s] * T[9 * s];
+    double helper9 = T[4 * s] * T[6 * s];
+    double helper10 = T[2 * s] * T[9 * s];
+    double helper11 = T[4 * s] * T[8 * s];
+    double helper12 = T[0 * s] - T[3 * s];
+    double helper13 = -T[10 * s];
+    double helper14 = T[1 * s] + helper13;
+    double helper15 = -T[9 * s];
+    double helper16 = T[0 * s] + helper15;
+    double helper17 = T[1 * s] - T[4 * s];
+    double helper18 = T[2 * s] - T[5 * s];
+    double helper19 = -T[11 * s];
+    double helper20 = T[2 * s] + helper19;
+    double helper21 = -T[7 * s];
+    double helper22 = T[1 * s] + helper21;
+    double helper23 = -T[6 * s];
+    double helper24 = T[0 * s] + helper23;
+    double helper25 = -T[8 * s];
+    double helper26 = T[2 * s] + helper25;
+    double helper27 = T[4 * s] + helper13;
+    double helper28 = T[3 * s] + helper23;
+    double helper29 = T[3 * s] + helper15;
+    double helper30 = T[4 * s] + helper21;
+    double helper31 = T[5 * s] + helper19;
+    double helper32 = T[5 * s] + helper25;
+    auto denom = (-T[0 * s] * helper11 + T[0 * s] * helper2 + T[10 * s] * helper4 - T[10 * s] * helper7 + T[11 * s] * helper6 -
+         T[11 * s] * helper9 - T[1 * s] * helper4 + T[1 * s] * helper7 - T[2 * s] * helper6 + T[2 * s] * helper9 +
+         T[3 * s] * helper3 - T[3 * s] * helper5 + T[4 * s] * helper1 - T[4 * s] * helper10 - T[5 * s] * helper0 +
+         T[5 * s] * helper8 - T[6 * s] * helper3 + T[6 * s] * helper5 - T[7 * s] * helper1 + T[7 * s] * helper10 +
+         T[8 * s] * helper0 - T[8 * s] * helper8 + T[9 * s] * helper11 - T[9 * s] * helper2);
     auto result_0 =
         ((1.0 / 4.0) * pow(helper12 * helper14 - helper16 * helper17, 2) +
          (1.0 / 4.0) * pow(-helper12 * helper20 + helper16 * helper18, 2) +
@@ -88,66 +90,66 @@ double wmtk::harmonic_tet_energy(const std::array<double, 12>& T)
          (1.0 / 4.0) * pow(-helper27 * helper32 + helper30 * helper31, 2) +
          (1.0 / 4.0) * pow(-helper28 * helper31 + helper29 * helper32, 2)) / denom
         ;
-    return result_0;
+    return denom < 0 ? std::numeric_limits<double>::infinity() : result_0;
 }
 
-void wmtk::harmonic_tet_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result)
+WMTK_ALWAYS_INLINE void harmonic_jacobian_kernel(const double* T, size_t s, double* result, size_t rs)
 {
-    double helper_0 = T[10] * T[8];
-    double helper_1 = T[11] * T[4];
-    double helper_2 = T[5] * T[7];
-    double helper_3 = T[10] * T[3];
-    double helper_4 = T[10] * T[5];
-    double helper_5 = T[11] * T[6];
-    double helper_6 = T[11] * T[7];
-    double helper_7 = T[3] * T[8];
-    double helper_8 = T[5] * T[9];
-    double helper_9 = T[4] * T[6];
-    double helper_10 = T[7] * T[9];
-    double helper_11 = T[4] * T[8];
-    double helper_12 = T[10] * T[6];
-    double helper_13 = T[11] * T[3];
-    double helper_14 = T[5] * T[6];
-    double helper_15 = T[8] * T[9];
-    double helper_16 = T[3] * T[7];
-    double helper_17 = T[4] * T[9];
-    double helper_18 = T[0] * helper_0 + T[0] * helper_1 - T[0] * helper_11 + T[0] * helper_2 -
-                       T[0] * helper_4 - T[0] * helper_6 - T[1] * helper_13 - T[1] * helper_14 -
-                       T[1] * helper_15 + T[1] * helper_5 + T[1] * helper_7 + T[1] * helper_8 +
-                       T[2] * helper_10 - T[2] * helper_12 - T[2] * helper_16 - T[2] * helper_17 +
-                       T[2] * helper_3 + T[2] * helper_9 - T[3] * helper_0 + T[3] * helper_6 -
-                       T[6] * helper_1 + T[6] * helper_4 + T[9] * helper_11 - T[9] * helper_2;
+    double helper_0 = T[10 * s] * T[8 * s];
+    double helper_1 = T[11 * s] * T[4 * s];
+    double helper_2 = T[5 * s] * T[7 * s];
+    double helper_3 = T[10 * s] * T[3 * s];
+    double helper_4 = T[10 * s] * T[5 * s];
+    double helper_5 = T[11 * s] * T[6 * s];
+    double helper_6 = T[11 * s] * T[7 * s];
+    double helper_7 = T[3 * s] * T[8 * s];
+    double helper_8 = T[5 * s] * T[9 * s];
+    double helper_9 = T[4 * s] * T[6 * s];
+    double helper_10 = T[7 * s] * T[9 * s];
+    double helper_11 = T[4 * s] * T[8 * s];
+    double helper_12 = T[10 * s] * T[6 * s];
+    double helper_13 = T[11 * s] * T[3 * s];
+    double helper_14 = T[5 * s] * T[6 * s];
+    double helper_15 = T[8 * s] * T[9 * s];
+    double helper_16 = T[3 * s] * T[7 * s];
+    double helper_17 = T[4 * s] * T[9 * s];
+    double helper_18 = T[0 * s] * helper_0 + T[0 * s] * helper_1 - T[0 * s] * helper_11 + T[0 * s] * helper_2 -
+                       T[0 * s] * helper_4 - T[0 * s] * helper_6 - T[1 * s] * helper_13 - T[1 * s] * helper_14 -
+                       T[1 * s] * helper_15 + T[1 * s] * helper_5 + T[1 * s] * helper_7 + T[1 * s] * helper_8 +
+                       T[2 * s] * helper_10 - T[2 * s] * helper_12 - T[2 * s] * helper_16 - T[2 * s] * helper_17 +
+                       T[2 * s] * helper_3 + T[2 * s] * helper_9 - T[3 * s] * helper_0 + T[3 * s] * helper_6 -
+                       T[6 * s] * helper_1 + T[6 * s] * helper_4 + T[9 * s] * helper_11 - T[9 * s] * helper_2;
     double helper_19 = 1.0 / helper_18;
-    double helper_20 = 2 * T[10];
+    double helper_20 = 2 * T[10 * s];
     double helper_21 = -helper_20;
-    double helper_22 = 2 * T[4];
-    double helper_23 = T[0] - T[3];
-    double helper_24 = -T[10];
-    double helper_25 = T[1] + helper_24;
-    double helper_26 = -T[9];
-    double helper_27 = T[0] + helper_26;
-    double helper_28 = T[1] - T[4];
+    double helper_22 = 2 * T[4 * s];
+    double helper_23 = T[0 * s] - T[3 * s];
+    double helper_24 = -T[10 * s];
+    double helper_25 = T[1 * s] + helper_24;
+    double helper_26 = -T[9 * s];
+    double helper_27 = T[0 * s] + helper_26;
+    double helper_28 = T[1 * s] - T[4 * s];
     double helper_29 = helper_23 * helper_25 - helper_27 * helper_28;
     double helper_30 = (1.0 / 4.0) * helper_29;
-    double helper_31 = 2 * T[7];
-    double helper_32 = -T[6];
-    double helper_33 = T[0] + helper_32;
-    double helper_34 = -T[7];
-    double helper_35 = T[1] + helper_34;
+    double helper_31 = 2 * T[7 * s];
+    double helper_32 = -T[6 * s];
+    double helper_33 = T[0 * s] + helper_32;
+    double helper_34 = -T[7 * s];
+    double helper_35 = T[1 * s] + helper_34;
     double helper_36 = helper_25 * helper_33 - helper_27 * helper_35;
     double helper_37 = (1.0 / 4.0) * helper_36;
-    double helper_38 = 2 * T[11];
-    double helper_39 = 2 * T[5];
+    double helper_38 = 2 * T[11 * s];
+    double helper_39 = 2 * T[5 * s];
     double helper_40 = -helper_39;
-    double helper_41 = T[2] - T[5];
-    double helper_42 = -T[11];
-    double helper_43 = T[2] + helper_42;
+    double helper_41 = T[2 * s] - T[5 * s];
+    double helper_42 = -T[11 * s];
+    double helper_43 = T[2 * s] + helper_42;
     double helper_44 = -helper_23 * helper_43 + helper_27 * helper_41;
     double helper_45 = (1.0 / 4.0) * helper_44;
-    double helper_46 = 2 * T[8];
+    double helper_46 = 2 * T[8 * s];
     double helper_47 = -helper_46;
-    double helper_48 = -T[8];
-    double helper_49 = T[2] + helper_48;
+    double helper_48 = -T[8 * s];
+    double helper_49 = T[2 * s] + helper_48;
     double helper_50 = helper_27 * helper_49 - helper_33 * helper_43;
     double helper_51 = (1.0 / 4.0) * helper_50;
     double helper_52 = -helper_31;
@@ -157,12 +159,12 @@ void wmtk::harmonic_tet_jacobian(const std::array<double, 12>& T, Eigen::Vector3
     double helper_56 = (1.0 / 4.0) * helper_55;
     double helper_57 = -helper_25 * helper_41 + helper_28 * helper_43;
     double helper_58 = -helper_25 * helper_49 + helper_35 * helper_43;
-    double helper_59 = T[4] + helper_24;
-    double helper_60 = T[3] + helper_32;
-    double helper_61 = T[3] + helper_26;
-    double helper_62 = T[4] + helper_34;
-    double helper_63 = T[5] + helper_42;
-    double helper_64 = T[5] + helper_48;
+    double helper_59 = T[4 * s] + helper_24;
+    double helper_60 = T[3 * s] + helper_32;
+    double helper_61 = T[3 * s] + helper_26;
+    double helper_62 = T[4 * s] + helper_34;
+    double helper_63 = T[5 * s] + helper_42;
+    double helper_64 = T[5 * s] + helper_48;
     double helper_65 = helper_28 * helper_49 - helper_35 * helper_41;
     double helper_66 = ((1.0 / 4.0) * pow(helper_29, 2) + (1.0 / 4.0) * pow(helper_36, 2) +
                         (1.0 / 4.0) * pow(helper_44, 2) + (1.0 / 4.0) * pow(helper_50, 2) +
@@ -176,10 +178,10 @@ void wmtk::harmonic_tet_jacobian(const std::array<double, 12>& T, Eigen::Vector3
     double helper_67 = -helper_38;
     double helper_68 = (1.0 / 4.0) * helper_57;
     double helper_69 = (1.0 / 4.0) * helper_58;
-    double helper_70 = 2 * T[3];
+    double helper_70 = 2 * T[3 * s];
     double helper_71 = -helper_70;
-    double helper_72 = 2 * T[6];
-    double helper_73 = 2 * T[9];
+    double helper_72 = 2 * T[6 * s];
+    double helper_73 = 2 * T[9 * s];
     double helper_74 = (1.0 / 4.0) * helper_65;
     double helper_75 = -helper_72;
     double helper_76 = -helper_22;
@@ -200,7 +202,41 @@ void wmtk::harmonic_tet_jacobian(const std::array<double, 12>& T, Eigen::Vector3
                      helper_69 * (helper_20 + helper_52) + helper_74 * (helper_31 + helper_76)) +
         helper_66 * (-helper_10 + helper_12 + helper_16 + helper_17 - helper_3 - helper_9);
 
-    result = Eigen::Vector3d(result_0, result_1, result_2);
+    result[0] = result_0;
+    result[rs] = result_1;
+    result[2 * rs] = result_2;
+}
+
+} // namespace
+
+double wmtk::harmonic_tet_energy(const std::array<double, 12>& T)
+{
+    return harmonic_energy_kernel(T.data(), 1);
+}
+
+void wmtk::harmonic_tet_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result)
+{
+    harmonic_jacobian_kernel(T.data(), 1, result.data(), 1);
+}
+
+WMTK_BATCH_TARGETS
+void wmtk::harmonic_tet_energy_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++) result[i] = harmonic_energy_kernel(T + i, stride);
+}
+
+WMTK_BATCH_TARGETS
+void wmtk::harmonic_tet_jacobian_batch(
+    size_t n,
+    const double* __restrict T,
+    size_t stride,
+    double* __restrict result)
+{
+    for (size_t i = 0; i < n; i++) harmonic_jacobian_kernel(T + i, stride, result + i, stride);
 }
 
 double wmtk::harmonic_energy(const Eigen::MatrixXd& verts)
@@ -7,6 +7,9 @@
 namespace wmtk {
 double harmonic_tet_energy(const std::array<double, 12>& T);
 void harmonic_tet_jacobian(const std::array<double, 12>& T, Eigen::Vector3d& result_0);
+// Batched versions, coordinate k of tet i at T[k * stride + i] (see EnergyBatch.hpp).
+void harmonic_tet_energy_batch(size_t n, const double* T, size_t stride, double* result);
+void harmonic_tet_jacobian_batch(size_t n, const double* T, size_t stride, double* result);
 
 /**
  * @brief Harmonic Triangulation energy: trace of Laplacian operator
@@ -0,0 +1,128 @@
+#include "FaceTagMap.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace wmtk {
+
+void FaceTags::push_back(int tag)
+{
+    if (m_size < inline_capacity) {
+        m_inline[m_size++] = tag;
+        return;
+    }
+    if (m_size == inline_capacity) m_heap.assign(m_inline.begin(), m_inline.end());
+    m_heap.push_back(tag);
+    m_size++;
+}
+
+FaceTagMap::FaceTagMap()
+    : m_shards(num_shards)
+{}
+
+size_t FaceTagMap::hash(const Key& f)
+{
+    // splitmix64 finalizer over the combined vertex ids
+    uint64_t h = f[0] * 0x9E3779B97F4A7C15ull;
+    h ^= (f[1] + 0x632BE59BD9B4E019ull) * 0xBF58476D1CE4E5B9ull;
+    h ^= (f[2] + 0x85EBCA77C2B2AE63ull) * 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 29;
+    return static_cast<size_t>(h);
+}
+
+const FaceTagMap::Slot* FaceTagMap::Shard::find(const Key& f, size_t hash) const
+{
+    if (slots.empty()) return nullptr;
+    const size_t mask = slots.size() - 1;
+    // the low bits chose the shard
+    for (size_t i = (hash / num_shards) & mask;; i = (i + 1) & mask) {
+        const auto& slot = slots[i];
+        if (slot.key == f) return &slot;
+        if (slot.key[0] == empty_key) return nullptr;
+    }
+}
+
+FaceTagMap::Slot& FaceTagMap::Shard::find_or_insert(const Key& f, size_t hash)
+{
+    // at most half full, so that probe runs stay short
+    if (2 * (size + 1) > slots.size()) grow();
+    const size_t mask = slots.size() - 1;
+    for (size_t i = (hash / num_shards) & mask;; i = (i + 1) & mask) {
+        auto& slot = slots[i];
+        if (slot.key == f) return slot;
+        if (slot.key[0] == empty_key) {
+            slot.key = f;
+            size++;
+            return slot;
+        }
+    }
+}
+
+void FaceTagMap::Shard::grow()
+{
+    std::vector<Slot> old(std::max<size_t>(16, 2 * slots.size()));
+    std::swap(old, slots);
+    size = 0;
+    for (auto& slot : old) {
+        if (slot.key[0] == empty_key) continue;
+        find_or_insert(slot.key, FaceTagMap::hash(slot.key)).tags = std::move(slot.tags);
+    }
+}
+
+void FaceTagMap::add(const Key& f, int tag)
+{
+    assert(f[0] <= f[1] && f[1] <= f[2]);
+    const size_t h = hash(f);
+    auto& s = shard(h);
+    tbb::spin_mutex::scoped_lock lock(s.mutex);
+    s.find_or_insert(f, h).tags.push_back(tag);
+}
+
+void FaceTagMap::assign(const Key& f, const FaceTags& tags)
+{
+    assert(f[0] <= f[1] && f[1] <= f[2]);
+    const size_t h = hash(f);
+    auto& s = shard(h);
+    tbb::spin_mutex::scoped_lock lock(s.mutex);
+    s.find_or_insert(f, h).tags = tags;
+}
+
+FaceTags FaceTagMap::take(const Key& f)
+{
+    const size_t h = hash(f);
+    auto& s = shard(h);
+    tbb::spin_mutex::scoped_lock lock(s.mutex);
+    auto* slot = const_cast<Slot*>(s.find(f, h));
+    if (slot == nullptr) return {};
+    FaceTags tags = std::move(slot->tags);
+    slot->tags.clear();
+    return tags;
+}
+
+FaceTags FaceTagMap::get(const Key& f) const
+{
+    const size_t h = hash(f);
+    const auto& s = shard(h);
+    tbb::spin_mutex::scoped_lock lock(s.mutex);
+    const auto* slot = s.find(f, h);
+    return slot == nullptr ? FaceTags() : slot->tags;
+}
+
+size_t FaceTagMap::size() const
+{
+    size_t n = 0;
+    for (const auto& s : m_shards) n += s.size;
+    return n;
+}
+
+void FaceTagMap::clear()
+{
+    for (auto& s : m_shards) {
+        s.slots.clear();
+        s.size = 0;
+    }
+}
+
+} // namespace wmtk
@@ -0,0 +1,112 @@
+#pragma once
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/spin_mutex.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief Input triangle ids attached to a face, the first few are stored inline.
+ */
+class FaceTags
+{
+public:
+    static constexpr uint32_t inline_capacity = 3;
+
+    void push_back(int tag);
+    void clear()
+    {
+        m_size = 0;
+        m_heap.clear();
+    }
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    const int* begin() const { return m_size > inline_capacity ? m_heap.data() : m_inline.data(); }
+    const int* end() const { return begin() + m_size; }
+    std::vector<int> to_vector() const { return std::vector<int>(begin(), end()); }
+
+private:
+    uint32_t m_size = 0;
+    std::array<int, inline_capacity> m_inline;
+    std::vector<int> m_heap; // all the tags once there are more than inline_capacity
+};
+
+/**
+ * @brief Concurrent hash map from faces, given as sorted vertex triples, to their tags.
+ *
+ * The keys are spread over shards, each an open addressing table with linear probing behind its
+ * own spin lock, so concurrent operations on different faces rarely wait and a lookup touches one
+ * contiguous run of slots. Entries are never removed, clear their tags instead.
+ */
+class FaceTagMap
+{
+public:
+    using Key = std::array<size_t, 3>;
+
+    FaceTagMap();
+
+    /// appends a tag to the face, the face is added if needed
+    void add(const Key& f, int tag);
+    /// replaces the tags of the face, the face is added if needed
+    void assign(const Key& f, const FaceTags& tags);
+    /// moves out the tags of the face, which are left empty, empty if the face is not in the map
+    FaceTags take(const Key& f);
+    /// a copy of the tags of the face, empty if the face is not in the map
+    FaceTags get(const Key& f) const;
+
+    /// number of faces, not thread safe with concurrent insertions
+    size_t size() const;
+    void clear();
+
+    /**
+     * @brief calls func(key, tags) on every face, in parallel over the shards. Not thread safe
+     * with concurrent modifications.
+     */
+    template <typename Func>
+    void parallel_for_each(Func&& func) const
+    {
+        tbb::parallel_for(size_t(0), m_shards.size(), [&](size_t s) {
+            for (const auto& slot : m_shards[s].slots)
+                if (slot.key[0] != empty_key) func(slot.key, slot.tags);
+        });
+    }
+
+private:
+    static constexpr size_t empty_key = ~size_t(0);
+    static constexpr size_t num_shards = 128;
+
+    struct Slot
+    {
+        Key key = {{empty_key, empty_key, empty_key}};
+        FaceTags tags;
+    };
+
+    struct alignas(64) Shard
+    {
+        mutable tbb::spin_mutex mutex;
+        std::vector<Slot> slots; // size is a power of two
+        size_t size = 0;
+
+        // the slot of f, or nullptr
+        const Slot* find(const Key& f, size_t hash) const;
+        // the slot of f, added if needed
+        Slot& find_or_insert(const Key& f, size_t hash);
+        void grow();
+    };
+
+    static size_t hash(const Key& f);
+    Shard& shard(size_t hash) { return m_shards[hash % num_shards]; }
+    const Shard& shard(size_t hash) const { return m_shards[hash % num_shards]; }
+
+    std::vector<Shard> m_shards;
+};
+
+} // namespace wmtk
@@ -0,0 +1,131 @@
+#include "FastWindingNumber.hpp"
+
+#include <wmtk/utils/MortonOrder.hpp>
+
+#include <Eigen/Geometry>
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <algorithm>
+#include <cmath>
+
+namespace wmtk {
+
+double triangle_winding_number(
+    const Eigen::Vector3d& q,
+    const Eigen::Vector3d& a,
+    const Eigen::Vector3d& b,
+    const Eigen::Vector3d& c)
+{
+    // Van Oosterom and Strackee, the solid angle is 2 atan2(det, den)
+    const Eigen::Vector3d qa = a - q, qb = b - q, qc = c - q;
+    const double la = qa.norm(), lb = qb.norm(), lc = qc.norm();
+    const double det = qa.dot(qb.cross(qc));
+    const double den = la * lb * lc + qa.dot(qb) * lc + qb.dot(qc) * la + qc.dot(qa) * lb;
+    return std::atan2(det, den) / (2 * M_PI);
+}
+
+void FastWindingNumber::init(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F)
+{
+    const size_t n = F.rows();
+    m_nodes.clear();
+    m_triangles.resize(n);
+    if (n == 0) return;
+
+    // sort the triangles along a Morton curve of their centroids
+    std::vector<Eigen::Vector3d> centroids(n);
+    tbb::parallel_for(size_t(0), n, [&](size_t i) {
+        centroids[i] = (V.row(F(i, 0)) + V.row(F(i, 1)) + V.row(F(i, 2))).transpose() / 3;
+    });
+    const auto order = morton_order(centroids);
+    for (size_t i = 0; i < n; i++) {
+        const int f = int(order[i]);
+        m_triangles[i] = {{V.row(F(f, 0)), V.row(F(f, 1)), V.row(F(f, 2))}};
+    }
+
+    m_nodes.reserve(2 * n / max_leaf_size + 1);
+    build(0, uint32_t(n));
+}
+
+uint32_t FastWindingNumber::build(uint32_t begin, uint32_t end)
+{
+    const auto id = uint32_t(m_nodes.size());
+    m_nodes.emplace_back();
+    {
+        Node& node = m_nodes.back();
+        node.begin = begin;
+        node.end = end;
+        node.right = 0;
+        node.dipole.setZero();
+        Eigen::Vector3d weighted = Eigen::Vector3d::Zero();
+        double area = 0;
+        for (uint32_t t = begin; t < end; t++) {
+            const auto& [a, b, c] = m_triangles[t];
+            const Eigen::Vector3d n = (b - a).cross(c - a) / 2;
+            node.dipole += n;
+            area += n.norm();
+            weighted += n.norm() * (a + b + c) / 3;
+        }
+        // degenerate triangles only, any point of them does
+        node.center = area > 0 ? Eigen::Vector3d(weighted / area) : m_triangles[begin][0];
+        node.radius = 0;
+        for (uint32_t t = begin; t < end; t++)
+            for (const auto& v : m_triangles[t])
+                node.radius = std::max(node.radius, (v - node.center).norm());
+    }
+    if (end - begin <= max_leaf_size) return id;
+
+    const uint32_t mid = begin + (end - begin) / 2;
+    build(begin, mid);
+    const uint32_t right = build(mid, end);
+    m_nodes[id].right = right;
+    return id;
+}
+
+double FastWindingNumber::winding_number(const Eigen::Vector3d& q, double accuracy) const
+{
+    if (m_nodes.empty()) return 0;
+    double w = 0;
+    // the tree is balanced, its depth is about log2(n / max_leaf_size)
+    std::array<uint32_t, 128> stack;
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const auto& node = m_nodes[stack[--top]];
+        const Eigen::Vector3d d = node.center - q;
+        const double dist2 = d.squaredNorm();
+        if (accuracy > 0 && dist2 > accuracy * accuracy * node.radius * node.radius) {
+            w += node.dipole.dot(d) / (4 * M_PI * dist2 * std::sqrt(dist2));
+        } else if (node.right == 0) {
+            for (uint32_t t = node.begin; t < node.end; t++) {
+                const auto& [a, b, c] = m_triangles[t];
+                w += triangle_winding_number(q, a, b, c);
+            }
+        } else {
+            stack[top++] = node.right;
+            stack[top++] = uint32_t(&node - m_nodes.data()) + 1;
+        }
+    }
+    return w;
+}
+
+Eigen::VectorXd FastWindingNumber::winding_numbers(
+    const Eigen::MatrixXd& Q,
+    double accuracy,
+    double refine_margin) const
+{
+    Eigen::VectorXd W(Q.rows());
+    tbb::parallel_for(Eigen::Index(0), Q.rows(), [&](Eigen::Index i) {
+        const Eigen::Vector3d q = Q.row(i);
+        double w = winding_number(q, accuracy);
+        if (accuracy > 0 && std::abs(std::abs(w) - 0.5) < refine_margin) w = winding_number(q, 0.);
+        W[i] = w;
+    });
+    return W;
+}
+
+} // namespace wmtk
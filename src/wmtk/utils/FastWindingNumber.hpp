@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief Generalized winding number of a triangle soup, evaluated with a Barnes-Hut tree
+ * (Barill et al. 2018, "Fast Winding Numbers for Soups and Clouds").
+ *
+ * The triangles are split in a binary tree along the Morton curve of their centroids. Each node
+ * stores the area weighted centroid and the sum of the area weighted normals (a dipole) of its
+ * triangles, and the radius of a ball around the centroid containing them. A query uses the
+ * dipole of every node farther than accuracy * radius, and the exact solid angles of the
+ * triangles of the leaves it reaches, so the cost is logarithmic for points away from the surface.
+ * The tree is built once and queries are const, they can run concurrently.
+ *
+ * The winding number is 1 inside a closed surface oriented outwards, 0 outside.
+ */
+class FastWindingNumber
+{
+public:
+    static constexpr int max_leaf_size = 8;
+
+    FastWindingNumber() = default;
+    FastWindingNumber(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F) { init(V, F); }
+
+    void init(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F);
+
+    /**
+     * @param accuracy nodes are expanded unless the point is farther than accuracy times their
+     * radius, larger is more accurate, 2 is a good default, 0 sums the exact solid angles of all
+     * the triangles
+     */
+    double winding_number(const Eigen::Vector3d& q, double accuracy = 2.) const;
+
+    /**
+     * @brief winding numbers of all the rows of Q, in parallel. Points whose approximate winding
+     * number is within refine_margin of +-0.5 are evaluated again exactly, so that the inside /
+     * outside classification only relies on the approximation where it is clear.
+     */
+    Eigen::VectorXd winding_numbers(
+        const Eigen::MatrixXd& Q,
+        double accuracy = 2.,
+        double refine_margin = 0.1) const;
+
+    size_t num_nodes() const { return m_nodes.size(); }
+
+private:
+    struct Node
+    {
+        Eigen::Vector3d center; // area weighted centroid
+        Eigen::Vector3d dipole; // sum of the area weighted normals
+        double radius;
+        uint32_t begin, end; // triangles, in m_triangles
+        uint32_t right; // the left child follows the node, 0 for leaves
+    };
+
+    uint32_t build(uint32_t begin, uint32_t end);
+
+    std::vector<Node> m_nodes; // root first, depth first order
+    std::vector<std::array<Eigen::Vector3d, 3>> m_triangles;
+};
+
+/**
+ * @brief Signed solid angle of the triangle (a, b, c) seen from q, divided by 4 pi.
+ */
+double triangle_winding_number(
+    const Eigen::Vector3d& q,
+    const Eigen::Vector3d& a,
+    const Eigen::Vector3d& b,
+    const Eigen::Vector3d& c);
+
+} // namespace wmtk
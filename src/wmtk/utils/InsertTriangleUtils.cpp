@@ -7,7 +7,7 @@ void wmtk::match_tet_faces_to_triangles(
     const wmtk::TetMesh& m,
     const std::vector<std::array<size_t, 3>>& faces,
     tbb::concurrent_vector<bool>& is_matched,
-    tbb::concurrent_map<std::array<size_t, 3>, std::vector<int>>& tet_face_tags)
+    FaceTagMap& tet_face_tags)
 {
     is_matched.resize(faces.size(), false);
 
@@ -26,7 +26,7 @@ void wmtk::match_tet_faces_to_triangles(
             auto it = map_surface.find(f);
             if (it != map_surface.end()) {
                 auto fid = it->second;
-                tet_face_tags[f].push_back(fid);
+                tet_face_tags.add(f, fid);
                 is_matched[fid] = true;
             }
         }
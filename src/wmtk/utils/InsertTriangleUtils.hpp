@@ -1,11 +1,13 @@
 #pragma once
 
 #include "wmtk/TetMesh.h"
+#include "wmtk/utils/FaceTagMap.hpp"
 #include "wmtk/utils/GeoUtils.h"
+#include "wmtk/utils/Interval.hpp"
 
 // clang-format off
 #include <wmtk/utils/DisableWarnings.hpp>
-#include <tbb/concurrent_map.h>
+#include <tbb/concurrent_vector.h>
 #include <wmtk/utils/EnableWarnings.hpp>
 // clang-format on
 
@@ -25,7 +27,7 @@ void match_tet_faces_to_triangles(
     const wmtk::TetMesh& m,
     const std::vector<std::array<size_t, 3>>& faces,
     tbb::concurrent_vector<bool>& is_matched,
-    tbb::concurrent_map<std::array<size_t, 3>, std::vector<int>>& tet_face_tags);
+    FaceTagMap& tet_face_tags);
 
 bool remove_duplicates(
     std::vector<Eigen::Vector3d>& vertices,
@@ -35,6 +37,15 @@ bool remove_duplicates(
 
 namespace wmtk {
 
+/**
+ * @brief Find the tets and edges cut by the triangle face_v, and the (exact) positions of the new
+ * vertices on the cut edges.
+ *
+ * @param vertex_pos_r exact vertex positions
+ * @param vertex_pos_interval (optional) interval enclosures of the vertex positions. When given,
+ * the orientation tests are first evaluated in interval arithmetic, and vertex_pos_r is only used
+ * when a sign cannot be certified and for constructing the intersection points.
+ */
 template <typename rational>
 auto triangle_insert_prepare_info(
     const wmtk::TetMesh& m,
@@ -42,7 +53,8 @@ auto triangle_insert_prepare_info(
     std::vector<std::array<size_t, 3>>& marking_tet_faces,
     const std::function<bool(const std::array<size_t, 3>&)>& try_acquire_triangle,
     const std::function<bool(const std::vector<wmtk::TetMesh::Tuple>&)>& try_acquire_tetra,
-    const std::function<Eigen::Matrix<rational, 3, 1>(size_t)>& vertex_pos_r)
+    const std::function<Eigen::Matrix<rational, 3, 1>(size_t)>& vertex_pos_r,
+    const std::function<wmtk::Interval3(size_t)>& vertex_pos_interval = nullptr)
 {
     using Vector3r = Eigen::Matrix<rational, 3, 1>;
     using Vector2r = Eigen::Matrix<rational, 2, 1>;
@@ -71,6 +83,71 @@ auto triangle_insert_prepare_info(
     std::array<Vector2r, 3> tri2;
     int squeeze_to_2d_dir = wmtk::project_triangle_to_2d(tri, tri2);
 
+    // floating point filter: the rational fallbacks are only evaluated on uncertain signs
+    const bool use_filter = static_cast<bool>(vertex_pos_interval);
+    std::array<wmtk::Interval3, 3> tri_i;
+    wmtk::Interval3 tri_normal_i;
+    std::array<wmtk::Interval2, 3> tri2_i;
+    if (use_filter) {
+        for (int j = 0; j < 3; j++) tri_i[j] = vertex_pos_interval(face_v[j]);
+        tri_normal_i = wmtk::cross(tri_i[1] - tri_i[0], tri_i[2] - tri_i[0]);
+        for (int j = 0; j < 3; j++)
+            tri2_i[j] = wmtk::project_point_to_2d(tri_i[j], squeeze_to_2d_dir);
+    }
+    auto filtered_sign = [](const wmtk::Interval& approx, auto&& exact_sign) -> int {
+        auto s = approx.sign();
+        if (s != wmtk::Interval::UNCERTAIN) return s;
+        return exact_sign();
+    };
+    auto side_of_triangle = [&](size_t vid) -> int {
+        auto exact_side = [&]() {
+            Vector3r dir = vertex_pos_r(vid) - tri[0];
+            auto side = dir.dot(tri_normal);
+            return side > 0 ? 1 : (side < 0 ? -1 : 0);
+        };
+        if (!use_filter) return exact_side();
+        return filtered_sign(
+            wmtk::dot(vertex_pos_interval(vid) - tri_i[0], tri_normal_i),
+            exact_side);
+    };
+    // interval counterparts of is_point_inside_triangle and
+    // open_segment_open_segment_intersection_2d, returning 0, 1 or Interval::UNCERTAIN
+    constexpr int UNCERTAIN = wmtk::Interval::UNCERTAIN;
+    auto is_point_inside_triangle_i = [&](const wmtk::Interval2& p) -> int {
+        std::array<int, 3> res;
+        for (int k = 0; k < 3; k++) {
+            res[k] = wmtk::orient2d_interval(p, tri2_i[k], tri2_i[(k + 1) % 3]).sign();
+            if (res[k] == UNCERTAIN) return UNCERTAIN;
+        }
+        const auto& [res1, res2, res3] = res;
+        if (res1 == 0 && res2 == 0) return 1;
+        if (res1 == 0 && res3 == 0) return 1;
+        if (res2 == 0 && res3 == 0) return 1;
+        return (res1 == res2 && res2 == res3) || (res1 == 0 && res2 == res3) ||
+               (res2 == 0 && res3 == res1) || (res3 == 0 && res2 == res1);
+    };
+    auto open_segments_intersect_i = [](const std::array<wmtk::Interval2, 2>& seg_1,
+                                        const std::array<wmtk::Interval2, 2>& seg_2) -> int {
+        const int o1 = wmtk::orient2d_interval(seg_1[0], seg_2[0], seg_2[1]).sign();
+        const int o2 = wmtk::orient2d_interval(seg_1[1], seg_2[0], seg_2[1]).sign();
+        if (o1 == UNCERTAIN || o2 == UNCERTAIN) return UNCERTAIN;
+        if (o1 * o2 >= 0) return 0;
+        const int o3 = wmtk::orient2d_interval(seg_2[0], seg_1[0], seg_1[1]).sign();
+        const int o4 = wmtk::orient2d_interval(seg_2[1], seg_1[0], seg_1[1]).sign();
+        if (o3 == UNCERTAIN || o4 == UNCERTAIN) return UNCERTAIN;
+        return o3 * o4 < 0;
+    };
+    // closed 2d triangle test on the projection of a coplanar vertex
+    auto is_vertex_inside_triangle_2 = [&](size_t vid) {
+        if (use_filter) {
+            auto p = wmtk::project_point_to_2d(vertex_pos_interval(vid), squeeze_to_2d_dir);
+            int res = is_point_inside_triangle_i(p);
+            if (res != UNCERTAIN) return res == 1;
+        }
+        auto p = wmtk::project_point_to_2d(vertex_pos_r(vid), squeeze_to_2d_dir);
+        return wmtk::is_point_inside_triangle(p, tri2);
+    };
+
     std::vector<Tuple> intersected_tets;
     std::map<std::array<size_t, 2>, std::tuple<int, Vector3r, size_t, int>> map_edge2point;
     std::map<std::array<size_t, 3>, bool> map_face2intersected;
@@ -118,6 +195,62 @@ auto triangle_insert_prepare_info(
         }
         return false;
     };
+    // overlap test of the projected coplanar edge (v0, v1) with the triangle
+    auto is_edge_cut_tri_2 = [&](size_t v0, size_t v1) {
+        if (use_filter) {
+            std::array<wmtk::Interval2, 2> seg2_i = {
+                {wmtk::project_point_to_2d(vertex_pos_interval(v0), squeeze_to_2d_dir),
+                 wmtk::project_point_to_2d(vertex_pos_interval(v1), squeeze_to_2d_dir)}};
+            // a certified overlap is enough, otherwise every test has to be certain
+            int res = 0;
+            auto accumulate = [&](int r) {
+                if (r == 1 || res == 1)
+                    res = 1;
+                else if (r == UNCERTAIN)
+                    res = UNCERTAIN;
+            };
+            accumulate(is_point_inside_triangle_i(seg2_i[0]));
+            accumulate(is_point_inside_triangle_i(seg2_i[1]));
+            for (int j = 0; j < 3 && res != 1; j++)
+                accumulate(open_segments_intersect_i(seg2_i, {{tri2_i[j], tri2_i[(j + 1) % 3]}}));
+            if (res != UNCERTAIN) return res == 1;
+        }
+        std::array<Vector2r, 2> seg2 = {
+            {wmtk::project_point_to_2d(vertex_pos_r(v0), squeeze_to_2d_dir),
+             wmtk::project_point_to_2d(vertex_pos_r(v1), squeeze_to_2d_dir)}};
+        return is_seg_cut_tri_2(seg2, tri2);
+    };
+    // does an edge of the triangle cross the (open) tet face f?
+    // an edge with endpoints strictly on both sides of the face plane always crosses it in its
+    // interior, and the crossing lies in the closed face iff the line of the edge does not see the
+    // face edges with mixed strict orientations, which is what the u, v checks of
+    // open_segment_triangle_intersection_3d compute
+    auto is_triangle_cut_tet_face_i = [&](const std::array<size_t, 3>& f) -> int {
+        const std::array<wmtk::Interval3, 3> tet_tri_i = {
+            {vertex_pos_interval(f[0]), vertex_pos_interval(f[1]), vertex_pos_interval(f[2])}};
+        const wmtk::Interval3 tet_tri_normal_i =
+            wmtk::cross(tet_tri_i[1] - tet_tri_i[0], tet_tri_i[2] - tet_tri_i[0]);
+        std::array<int, 3> tet_tri_v_sides;
+        for (int k = 0; k < 3; k++) {
+            tet_tri_v_sides[k] = wmtk::dot(tri_i[k] - tet_tri_i[0], tet_tri_normal_i).sign();
+            if (tet_tri_v_sides[k] == UNCERTAIN) return UNCERTAIN;
+        }
+        for (int k = 0; k < 3; k++) {
+            if (tet_tri_v_sides[k] * tet_tri_v_sides[(k + 1) % 3] >= 0) continue;
+            const auto& e0 = tri_i[k];
+            const auto& e1 = tri_i[(k + 1) % 3];
+            bool has_pos = false, has_neg = false;
+            for (int l = 0; l < 3; l++) {
+                int o = wmtk::orient3d_interval(e0, e1, tet_tri_i[l], tet_tri_i[(l + 1) % 3])
+                            .sign();
+                if (o == UNCERTAIN) return UNCERTAIN;
+                has_pos |= o > 0;
+                has_neg |= o < 0;
+            }
+            if (!(has_pos && has_neg)) return 1;
+        }
+        return 0;
+    };
     //
     // BFS
     while (!tet_queue.empty()) {
@@ -146,8 +279,7 @@ auto triangle_insert_prepare_info(
         std::array<size_t, 4> vertex_vids;
         for (int j = 0; j < 4; j++) {
             vertex_vids[j] = vs[j].vid(m);
-            Vector3r dir = vertex_pos_r(vertex_vids[j]) - tri[0];
-            auto side = dir.dot(tri_normal);
+            auto side = side_of_triangle(vertex_vids[j]);
             if (side > 0) {
                 cnt_pos++;
                 vertex_sides[vertex_vids[j]] = 1;
@@ -163,8 +295,7 @@ auto triangle_insert_prepare_info(
         if (coplanar_f_lvids.size() == 1) {
             int lvid = coplanar_f_lvids[0];
             int vid = vertex_vids[lvid];
-            auto p = wmtk::project_point_to_2d(vertex_pos_r(vid), squeeze_to_2d_dir);
-            bool is_inside = wmtk::is_point_inside_triangle(p, tri2);
+            bool is_inside = is_vertex_inside_triangle_2(vid);
             //
             if (is_inside) {
                 auto conn_tets = m.get_one_ring_tets_for_vertex(vs[lvid]);
@@ -175,14 +306,9 @@ auto triangle_insert_prepare_info(
                 }
             }
         } else if (coplanar_f_lvids.size() == 2) {
-            std::array<Vector2r, 2> seg2;
-            seg2[0] = wmtk::project_point_to_2d(
-                vertex_pos_r(vertex_vids[coplanar_f_lvids[0]]),
-                squeeze_to_2d_dir);
-            seg2[1] = wmtk::project_point_to_2d(
-                vertex_pos_r(vertex_vids[coplanar_f_lvids[1]]),
-                squeeze_to_2d_dir);
-            if (is_seg_cut_tri_2(seg2, tri2)) {
+            if (is_edge_cut_tri_2(
+                    vertex_vids[coplanar_f_lvids[0]],
+                    vertex_vids[coplanar_f_lvids[1]])) {
                 std::array<int, 2> le = {{coplanar_f_lvids[0], coplanar_f_lvids[1]}};
                 if (le[0] > le[1]) std::swap(le[0], le[1]);
                 int leid =
@@ -203,14 +329,9 @@ auto triangle_insert_prepare_info(
         } else if (coplanar_f_lvids.size() == 3) {
             bool is_cut = false;
             for (int i = 0; i < 3; i++) {
-                std::array<Vector2r, 2> seg2;
-                seg2[0] = wmtk::project_point_to_2d(
-                    vertex_pos_r(vertex_vids[coplanar_f_lvids[i]]),
-                    squeeze_to_2d_dir);
-                seg2[1] = wmtk::project_point_to_2d(
-                    vertex_pos_r(vertex_vids[coplanar_f_lvids[(i + 1) % 3]]),
-                    squeeze_to_2d_dir);
-                if (is_seg_cut_tri_2(seg2, tri2)) {
+                if (is_edge_cut_tri_2(
+                        vertex_vids[coplanar_f_lvids[i]],
+                        vertex_vids[coplanar_f_lvids[(i + 1) % 3]])) {
                     is_cut = true;
                     break;
                 }
@@ -328,35 +449,42 @@ auto triangle_insert_prepare_info(
                 if (cnt_pos1 == 0 || cnt_neg1 == 0) continue;
             }
 
-            std::array<Vector3r, 3> tet_tri = {
-                {vertex_pos_r(f[0]), vertex_pos_r(f[1]), vertex_pos_r(f[2])}};
-            //
-            std::array<int, 3> tet_tri_v_sides;
-            Vector3r tet_tri_normal = (tet_tri[1] - tet_tri[0]).cross(tet_tri[2] - tet_tri[0]);
-            for (int k = 0; k < 3; k++) {
-                Vector3r dir = tri[k] - tet_tri[0];
-                auto side = dir.dot(tet_tri_normal);
-                if (side == 0)
-                    tet_tri_v_sides[k] = 0;
-                else if (side > 0)
-                    tet_tri_v_sides[k] = 1;
-                else
-                    tet_tri_v_sides[k] = -1;
-            }
-
             bool is_intersected = false;
-            for (int k = 0; k < 3; k++) { // check intersection
-                if ((tet_tri_v_sides[k] >= 0 && tet_tri_v_sides[(k + 1) % 3] >= 0) ||
-                    (tet_tri_v_sides[k] <= 0 && tet_tri_v_sides[(k + 1) % 3] <= 0))
-                    continue;
-                Vector3r _p;
-                is_intersected = wmtk::open_segment_triangle_intersection_3d(
-                    {{tri[k], tri[(k + 1) % 3]}},
-                    tet_tri,
-                    _p);
-                if (is_intersected) {
-                    need_subdivision = true; // is recorded
-                    break;
+            int filtered = use_filter ? is_triangle_cut_tet_face_i(f) : UNCERTAIN;
+            if (filtered != UNCERTAIN) {
+                is_intersected = filtered == 1;
+                if (is_intersected) need_subdivision = true;
+            } else {
+                std::array<Vector3r, 3> tet_tri = {
+                    {vertex_pos_r(f[0]), vertex_pos_r(f[1]), vertex_pos_r(f[2])}};
+                //
+                std::array<int, 3> tet_tri_v_sides;
+                Vector3r tet_tri_normal =
+                    (tet_tri[1] - tet_tri[0]).cross(tet_tri[2] - tet_tri[0]);
+                for (int k = 0; k < 3; k++) {
+                    Vector3r dir = tri[k] - tet_tri[0];
+                    auto side = dir.dot(tet_tri_normal);
+                    if (side == 0)
+                        tet_tri_v_sides[k] = 0;
+                    else if (side > 0)
+                        tet_tri_v_sides[k] = 1;
+                    else
+                        tet_tri_v_sides[k] = -1;
+                }
+
+                for (int k = 0; k < 3; k++) { // check intersection
+                    if ((tet_tri_v_sides[k] >= 0 && tet_tri_v_sides[(k + 1) % 3] >= 0) ||
+                        (tet_tri_v_sides[k] <= 0 && tet_tri_v_sides[(k + 1) % 3] <= 0))
+                        continue;
+                    Vector3r _p;
+                    is_intersected = wmtk::open_segment_triangle_intersection_3d(
+                        {{tri[k], tri[(k + 1) % 3]}},
+                        tet_tri,
+                        _p);
+                    if (is_intersected) {
+                        need_subdivision = true; // is recorded
+                        break;
+                    }
                 }
             }
             map_face2intersected[f] = is_intersected;
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+namespace wmtk {
+
+/**
+ * @brief Closed interval of doubles with outward rounding, used as a floating-point filter in
+ * front of exact (Rational) predicates. Every operation returns an interval that is guaranteed to
+ * contain the exact result, so a sign read from it is certified whenever the interval does not
+ * straddle zero.
+ *
+ * @note Exact operations (e.g. subtracting two equal values) do not widen the result, so exact
+ * zeros are certified as well.
+ */
+class Interval
+{
+public:
+    static constexpr int UNCERTAIN = 2;
+
+    double lo = 0;
+    double hi = 0;
+
+    Interval() = default;
+    Interval(double d)
+        : lo(d)
+        , hi(d)
+    {}
+    Interval(double l, double h)
+        : lo(l)
+        , hi(h)
+    {}
+
+    /**
+     * @brief interval enclosing a value that is within one ulp of d, e.g. the result of
+     * mpq_get_d() which truncates towards zero.
+     */
+    static Interval around(double d) { return Interval(down(d), up(d)); }
+
+    /**
+     * @return -1, 0, 1 if the sign of every value in the interval is the same, UNCERTAIN otherwise
+     */
+    int sign() const
+    {
+        if (lo > 0) return 1;
+        if (hi < 0) return -1;
+        if (lo == 0 && hi == 0) return 0;
+        return UNCERTAIN;
+    }
+
+    friend Interval operator+(const Interval& a, const Interval& b)
+    {
+        Interval r;
+        double _;
+        add_bounds(a.lo, b.lo, r.lo, _);
+        add_bounds(a.hi, b.hi, _, r.hi);
+        return r;
+    }
+
+    friend Interval operator-(const Interval& a) { return Interval(-a.hi, -a.lo); }
+
+    friend Interval operator-(const Interval& a, const Interval& b) { return a + (-b); }
+
+    friend Interval operator*(const Interval& a, const Interval& b)
+    {
+        Interval r(
+            std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity());
+        for (auto x : {a.lo, a.hi}) {
+            for (auto y : {b.lo, b.hi}) {
+                double l, h;
+                mul_bounds(x, y, l, h);
+                r.lo = std::min(r.lo, l);
+                r.hi = std::max(r.hi, h);
+            }
+        }
+        if (std::isnan(r.lo) || std::isnan(r.hi)) return unbounded();
+        return r;
+    }
+
+private:
+    static double down(double x)
+    {
+        return std::nextafter(x, -std::numeric_limits<double>::infinity());
+    }
+    static double up(double x)
+    {
+        return std::nextafter(x, std::numeric_limits<double>::infinity());
+    }
+    static Interval unbounded()
+    {
+        return Interval(
+            -std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity());
+    }
+
+    // bounds of the exact a + b, using the TwoSum error term to detect rounding
+    static void add_bounds(double a, double b, double& lo, double& hi)
+    {
+        const double s = a + b;
+        if (!std::isfinite(s)) {
+            lo = -std::numeric_limits<double>::infinity();
+            hi = std::numeric_limits<double>::infinity();
+            return;
+        }
+        const double bb = s - a;
+        const double err = (a - (s - bb)) + (b - bb);
+        lo = err < 0 ? down(s) : s;
+        hi = err > 0 ? up(s) : s;
+    }
+
+    // bounds of the exact a * b, using fma to recover the rounding error
+    static void mul_bounds(double a, double b, double& lo, double& hi)
+    {
+        const double p = a * b;
+        if (!std::isfinite(p)) {
+            lo = -std::numeric_limits<double>::infinity();
+            hi = std::numeric_limits<double>::infinity();
+            return;
+        }
+        if (a == 0 || b == 0) {
+            lo = hi = 0;
+            return;
+        }
+        // close to underflow the fma residual is not representable, always widen
+        if (std::abs(p) < 1e-280) {
+            lo = down(p);
+            hi = up(p);
+            return;
+        }
+        const double err = std::fma(a, b, -p);
+        lo = err < 0 ? down(p) : p;
+        hi = err > 0 ? up(p) : p;
+    }
+};
+
+using Interval2 = std::array<Interval, 2>;
+using Interval3 = std::array<Interval, 3>;
+
+inline Interval3 operator-(const Interval3& a, const Interval3& b)
+{
+    return {{a[0] - b[0], a[1] - b[1], a[2] - b[2]}};
+}
+
+inline Interval3 cross(const Interval3& a, const Interval3& b)
+{
+    return {{a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}};
+}
+
+inline Interval dot(const Interval3& a, const Interval3& b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/**
+ * @brief same expression as orient3d_t, ((p2 - p1) x (p3 - p1)) . (p4 - p1), over intervals
+ */
+inline Interval orient3d_interval(
+    const Interval3& p1,
+    const Interval3& p2,
+    const Interval3& p3,
+    const Interval3& p4)
+{
+    return dot(cross(p2 - p1, p3 - p1), p4 - p1);
+}
+
+/**
+ * @brief same expression as orient2d_t, cross_2d(p2 - p1, p3 - p1), over intervals
+ */
+inline Interval orient2d_interval(const Interval2& p1, const Interval2& p2, const Interval2& p3)
+{
+    const Interval a0 = p2[0] - p1[0], a1 = p2[1] - p1[1];
+    const Interval b0 = p3[0] - p1[0], b1 = p3[1] - p1[1];
+    return a0 * b1 - a1 * b0;
+}
+
+/**
+ * @brief drop the squeezed axis, same convention as project_point_to_2d
+ */
+inline Interval2 project_point_to_2d(const Interval3& p, int t)
+{
+    if (t == 0)
+        return {{p[1], p[2]}};
+    else if (t == 1)
+        return {{p[0], p[2]}};
+    else
+        return {{p[0], p[1]}};
+}
+
+} // namespace wmtk
@@ -0,0 +1,60 @@
+#include "MemoryReport.hpp"
+
+#include <wmtk/utils/Logger.hpp>
+
+#include <cstdio>
+
+namespace wmtk {
+
+void MemoryReport::add(const std::string& name, const MemoryUsage& usage)
+{
+    for (auto& [n, u] : m_entries) {
+        if (n == name) {
+            u += usage;
+            return;
+        }
+    }
+    m_entries.emplace_back(name, usage);
+}
+
+void MemoryReport::add(const std::string& prefix, const MemoryReport& other)
+{
+    for (const auto& [name, usage] : other.m_entries) add(prefix + name, usage);
+}
+
+MemoryUsage MemoryReport::total() const
+{
+    MemoryUsage t;
+    for (const auto& [name, usage] : m_entries) t += usage;
+    return t;
+}
+
+std::string MemoryReport::to_string() const
+{
+    constexpr double MB = 1024. * 1024.;
+    std::string out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-32s %12s %12s\n", "", "used MB", "reserved MB");
+    out += line;
+    for (const auto& [name, usage] : m_entries) {
+        std::snprintf(
+            line,
+            sizeof(line),
+            "%-32s %12.3f %12.3f\n",
+            name.c_str(),
+            usage.used / MB,
+            usage.reserved / MB);
+        out += line;
+    }
+    const auto t = total();
+    std::snprintf(line, sizeof(line), "%-32s %12.3f %12.3f", "total", t.used / MB, t.reserved / MB);
+    out += line;
+    return out;
+}
+
+void MemoryReport::log(const std::string& title) const
+{
+    logger().info("memory {}\n{}", title, to_string());
+}
+
+} // namespace wmtk
@@ -0,0 +1,87 @@
+#pragma once
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wmtk {
+
+/// Bytes of the elements in use and bytes allocated, reserved >= used.
+struct MemoryUsage
+{
+    size_t used = 0;
+    size_t reserved = 0;
+
+    MemoryUsage& operator+=(const MemoryUsage& o)
+    {
+        used += o.used;
+        reserved += o.reserved;
+        return *this;
+    }
+};
+
+template <typename T>
+MemoryUsage memory_usage(const std::vector<T>& v)
+{
+    return {v.size() * sizeof(T), v.capacity() * sizeof(T)};
+}
+
+template <typename T>
+MemoryUsage memory_usage(const tbb::concurrent_vector<T>& v)
+{
+    return {v.size() * sizeof(T), v.capacity() * sizeof(T)};
+}
+
+/// Estimated, each node of a red-black tree holds three pointers and a color besides its value.
+template <typename K, typename V>
+MemoryUsage memory_usage(const std::map<K, V>& m)
+{
+    const size_t bytes = m.size() * (sizeof(std::pair<const K, V>) + 4 * sizeof(void*));
+    return {bytes, bytes};
+}
+
+/// The sum over the threads that used the container, plus the per-thread slots.
+template <typename T>
+MemoryUsage memory_usage(const tbb::enumerable_thread_specific<T>& ets)
+{
+    MemoryUsage usage;
+    for (const auto& local : ets) usage += memory_usage(local);
+    usage.reserved += ets.size() * sizeof(T);
+    usage.used += ets.size() * sizeof(T);
+    return usage;
+}
+
+/**
+ * @brief The heap memory of a mesh or a pass, broken down by subsystem. The sizes count the
+ * containers and their elements, not the heap memory owned by the elements unless stated (e.g.
+ * the vertex stars), so compare the total with getCurrentRSS() to find the rest.
+ */
+class MemoryReport
+{
+public:
+    void add(const std::string& name, const MemoryUsage& usage);
+    /// adds the entries of other, with their names prefixed by prefix
+    void add(const std::string& prefix, const MemoryReport& other);
+
+    MemoryUsage total() const;
+    const std::vector<std::pair<std::string, MemoryUsage>>& entries() const { return m_entries; }
+
+    /// one line per entry, used and reserved in MB, then the total
+    std::string to_string() const;
+    /// logs to_string() at info level, after a line with title
+    void log(const std::string& title) const;
+
+private:
+    std::vector<std::pair<std::string, MemoryUsage>> m_entries;
+};
+
+} // namespace wmtk
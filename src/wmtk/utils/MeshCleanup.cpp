@@ -0,0 +1,232 @@
+#include "MeshCleanup.hpp"
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+
+namespace wmtk {
+
+namespace {
+// new position of each kept element, and their number
+size_t compact_ids(const std::vector<uint8_t>& keep, std::vector<size_t>& new_ids)
+{
+    new_ids.resize(keep.size());
+    size_t next = 0;
+    for (size_t i = 0; i < keep.size(); i++) {
+        new_ids[i] = next;
+        next += keep[i];
+    }
+    return next;
+}
+
+void remap_faces(std::vector<std::array<size_t, 3>>& F, const std::vector<size_t>& new_ids)
+{
+    tbb::parallel_for(size_t(0), F.size(), [&](size_t f) {
+        for (auto& v : F[f]) v = new_ids[v];
+    });
+}
+} // namespace
+
+void remove_unreferenced_vertices(
+    std::vector<Eigen::Vector3d>& V,
+    std::vector<std::array<size_t, 3>>& F)
+{
+    std::vector<std::atomic<uint8_t>> used(V.size());
+    tbb::parallel_for(size_t(0), V.size(), [&](size_t v) {
+        used[v].store(0, std::memory_order_relaxed);
+    });
+    tbb::parallel_for(size_t(0), F.size(), [&](size_t f) {
+        for (auto v : F[f]) used[v].store(1, std::memory_order_relaxed);
+    });
+    std::vector<uint8_t> keep(V.size());
+    tbb::parallel_for(size_t(0), V.size(), [&](size_t v) { keep[v] = used[v].load(); });
+
+    std::vector<size_t> new_ids;
+    const size_t n = compact_ids(keep, new_ids);
+    if (n == V.size()) return;
+    std::vector<Eigen::Vector3d> kept(n);
+    tbb::parallel_for(size_t(0), V.size(), [&](size_t v) {
+        if (keep[v]) kept[new_ids[v]] = V[v];
+    });
+    V.swap(kept);
+    remap_faces(F, new_ids);
+}
+
+void weld_vertices(
+    std::vector<Eigen::Vector3d>& V,
+    std::vector<std::array<size_t, 3>>& F,
+    double eps)
+{
+    const size_t n = V.size();
+    // the cell of a vertex, rounded half away from zero like igl::round
+    std::vector<std::array<double, 3>> cells(n);
+    tbb::parallel_for(size_t(0), n, [&](size_t v) {
+        for (int j = 0; j < 3; j++) cells[v][j] = eps > 0 ? std::round(V[v][j] / eps) : V[v][j];
+    });
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    tbb::parallel_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return cells[a] != cells[b] ? cells[a] < cells[b] : a < b;
+    });
+
+    // the first vertex of each cell in the sorted order is kept
+    std::vector<uint8_t> first(n);
+    tbb::parallel_for(size_t(0), n, [&](size_t i) {
+        first[i] = i == 0 || cells[order[i]] != cells[order[i - 1]];
+    });
+    std::vector<size_t> cell_ids;
+    const size_t num_cells = compact_ids(first, cell_ids);
+
+    std::vector<Eigen::Vector3d> welded(num_cells);
+    std::vector<size_t> new_ids(n);
+    tbb::parallel_for(size_t(0), n, [&](size_t i) {
+        // cell_ids counts the cells before i, the cell of i is the last one started
+        const size_t cell = cell_ids[i] + first[i] - 1;
+        new_ids[order[i]] = cell;
+        if (first[i]) welded[cell] = V[order[i]];
+    });
+    V.swap(welded);
+    remap_faces(F, new_ids);
+}
+
+void remove_duplicate_faces(std::vector<std::array<size_t, 3>>& F)
+{
+    const size_t m = F.size();
+    std::vector<std::array<size_t, 3>> keys(m);
+    tbb::parallel_for(size_t(0), m, [&](size_t f) {
+        keys[f] = F[f];
+        std::sort(keys[f].begin(), keys[f].end());
+    });
+    std::vector<size_t> order(m);
+    std::iota(order.begin(), order.end(), 0);
+    tbb::parallel_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return keys[a] != keys[b] ? keys[a] < keys[b] : a < b;
+    });
+
+    std::vector<uint8_t> keep(m);
+    tbb::parallel_for(size_t(0), m, [&](size_t i) {
+        keep[order[i]] = i == 0 || keys[order[i]] != keys[order[i - 1]];
+    });
+    std::vector<size_t> new_ids;
+    const size_t num_kept = compact_ids(keep, new_ids);
+    if (num_kept == m) return;
+    std::vector<std::array<size_t, 3>> kept(num_kept);
+    tbb::parallel_for(size_t(0), m, [&](size_t f) {
+        if (keep[f]) kept[new_ids[f]] = F[f];
+    });
+    F.swap(kept);
+}
+
+bool split_nonmanifold_vertices(
+    std::vector<Eigen::Vector3d>& V,
+    std::vector<std::array<size_t, 3>>& F,
+    std::vector<size_t>& modified_vertices)
+{
+    const size_t n = V.size(), m = F.size();
+    std::atomic<bool> is_degenerate = false;
+    tbb::parallel_for(size_t(0), m, [&](size_t f) {
+        const auto& t = F[f];
+        if (t[0] == t[1] || t[1] == t[2] || t[2] == t[0]) is_degenerate = true;
+    });
+    if (is_degenerate) return false;
+
+    // corners 3f + j sorted by vertex, the star of v is corners[offsets[v]] to
+    // corners[offsets[v + 1]]
+    std::vector<std::pair<size_t, size_t>> corners(3 * m);
+    tbb::parallel_for(size_t(0), m, [&](size_t f) {
+        for (int j = 0; j < 3; j++) corners[3 * f + j] = {F[f][j], 3 * f + j};
+    });
+    tbb::parallel_sort(corners.begin(), corners.end());
+    std::vector<size_t> offsets(n + 1);
+    tbb::parallel_for(size_t(0), n + 1, [&](size_t v) {
+        offsets[v] = std::lower_bound(corners.begin(), corners.end(), std::pair(v, size_t(0))) -
+                     corners.begin();
+    });
+
+    // faces of a star sharing an edge are in the same fan, an edge with more than two faces
+    // is not handled here
+    std::vector<uint32_t> fans(3 * m);
+    std::vector<uint32_t> num_fans(n, 1);
+    std::atomic<bool> is_edge_nonmanifold = false;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n), [&](const tbb::blocked_range<size_t>& r) {
+        std::vector<std::pair<size_t, uint32_t>> links; // other vertex, face in the star
+        std::vector<uint32_t> parent, label;
+        const auto find = [&](uint32_t i) {
+            while (parent[i] != i) i = parent[i] = parent[parent[i]];
+            return i;
+        };
+        for (size_t v = r.begin(); v < r.end(); v++) {
+            const size_t begin = offsets[v];
+            const uint32_t k = uint32_t(offsets[v + 1] - begin);
+            links.clear();
+            for (uint32_t i = 0; i < k; i++) {
+                const size_t corner = corners[begin + i].second;
+                const auto& t = F[corner / 3];
+                links.emplace_back(t[(corner + 1) % 3], i);
+                links.emplace_back(t[(corner + 2) % 3], i);
+            }
+            std::sort(links.begin(), links.end());
+
+            parent.resize(k);
+            std::iota(parent.begin(), parent.end(), 0);
+            for (size_t a = 0; a < links.size();) {
+                size_t b = a + 1;
+                while (b < links.size() && links[b].first == links[a].first) b++;
+                if (b - a > 2) is_edge_nonmanifold = true;
+                for (size_t c = a + 1; c < b; c++)
+                    parent[find(links[c].second)] = find(links[a].second);
+                a = b;
+            }
+
+            label.assign(k, ~uint32_t(0));
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < k; i++) {
+                const uint32_t root = find(i);
+                if (label[root] == ~uint32_t(0)) label[root] = count++;
+                fans[begin + i] = label[root];
+            }
+            num_fans[v] = std::max(count, uint32_t(1));
+        }
+    });
+    if (is_edge_nonmanifold) return false;
+
+    // the copies of v are first_copy[v], first_copy[v] + 1, ...
+    std::vector<size_t> first_copy(n);
+    size_t next = n;
+    modified_vertices.clear();
+    for (size_t v = 0; v < n; v++) {
+        first_copy[v] = next;
+        next += num_fans[v] - 1;
+        if (num_fans[v] > 1) modified_vertices.push_back(v);
+    }
+    if (next == n) return true;
+
+    V.resize(next);
+    const size_t num_split = modified_vertices.size();
+    for (size_t s = 0; s < num_split; s++) {
+        const size_t v = modified_vertices[s];
+        for (size_t c = first_copy[v]; c < first_copy[v] + num_fans[v] - 1; c++) {
+            V[c] = V[v];
+            modified_vertices.push_back(c);
+        }
+    }
+    tbb::parallel_for(size_t(0), n, [&](size_t v) {
+        if (num_fans[v] == 1) return;
+        for (size_t i = offsets[v]; i < offsets[v + 1]; i++) {
+            const size_t corner = corners[i].second;
+            if (fans[i] > 0) F[corner / 3][corner % 3] = first_copy[v] + fans[i] - 1;
+        }
+    });
+    return true;
+}
+
+} // namespace wmtk
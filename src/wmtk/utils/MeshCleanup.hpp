@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <array>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * Parallel cleaning of input triangle soups, used by stl_to_manifold_wmtk_input. Each function
+ * gives the same result as the serial igl/map based code it replaces.
+ */
+
+/**
+ * @brief Removes the vertices that no face uses, the others keep their order
+ * (igl::remove_unreferenced).
+ */
+void remove_unreferenced_vertices(
+    std::vector<Eigen::Vector3d>& V,
+    std::vector<std::array<size_t, 3>>& F);
+
+/**
+ * @brief Merges the vertices that fall in the same cell of a grid of spacing eps, each rounded
+ * coordinate being the cell key (igl::remove_duplicate_vertices). The welded vertices are sorted
+ * by cell, each one is the input vertex of smallest id of its cell. eps = 0 merges exact copies.
+ */
+void weld_vertices(
+    std::vector<Eigen::Vector3d>& V,
+    std::vector<std::array<size_t, 3>>& F,
+    double eps);
+
+/**
+ * @brief Removes the faces with the same vertices as an earlier face, in any order, the kept ones
+ * stay in order (resolve_duplicated_faces).
+ */
+void remove_duplicate_faces(std::vector<std::array<size_t, 3>>& F);
+
+/**
+ * @brief Gives each fan of faces around a non-manifold vertex its own vertex. The first fan keeps
+ * the vertex, the copies are appended to V and listed in modified_vertices with the originals.
+ *
+ * @return false, leaving V and F unchanged, if an edge has more than two faces or a face repeats
+ * a vertex. Such meshes need separate_to_manifold.
+ */
+bool split_nonmanifold_vertices(
+    std::vector<Eigen::Vector3d>& V,
+    std::vector<std::array<size_t, 3>>& F,
+    std::vector<size_t>& modified_vertices);
+
+} // namespace wmtk
@@ -0,0 +1,363 @@
+#include "MeshReader.hpp"
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wmtk {
+
+namespace {
+constexpr size_t chunk_bytes = size_t(1) << 22; // of text parsed by one task
+
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#ifdef _WIN32
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open " + path);
+        m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read " + path);
+        }
+        m_size = size_t(st.st_size);
+        if (m_size > 0) {
+            void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            m_data = static_cast<const char*>(p);
+        }
+        ::close(fd);
+#endif
+    }
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (m_data != nullptr) munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    std::vector<char> m_buffer;
+#endif
+};
+
+bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+/// [begin, end) ranges of about chunk_bytes, each ending after a line break or at the end
+std::vector<std::pair<const char*, const char*>> line_chunks(const char* data, size_t size)
+{
+    std::vector<std::pair<const char*, const char*>> chunks;
+    const char* end = data + size;
+    for (const char* begin = data; begin < end;) {
+        const char* stop = begin + std::min(chunk_bytes, size_t(end - begin));
+        while (stop < end && stop[-1] != '\n') stop++;
+        chunks.emplace_back(begin, stop);
+        begin = stop;
+    }
+    return chunks;
+}
+
+/// calls fn(p, line_end) on the lines of [begin, end), p after the leading blanks and line_end at
+/// the '#' of a trailing comment, comment and blank lines are skipped
+template <typename Fn>
+void for_each_line(const char* begin, const char* end, Fn&& fn)
+{
+    while (begin < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        if (line_end == nullptr) line_end = end;
+        const char* comment = static_cast<const char*>(std::memchr(begin, '#', line_end - begin));
+        const char* stop = comment == nullptr ? line_end : comment;
+        const char* p = begin;
+        while (p < stop && is_blank(*p)) p++;
+        if (p < stop) fn(p, stop);
+        begin = line_end + 1;
+    }
+}
+
+/// whether the line at p starts with the keyword followed by a blank
+bool starts_with(const char* p, const char* end, const char* keyword)
+{
+    const size_t n = std::strlen(keyword);
+    return size_t(end - p) > n && std::memcmp(p, keyword, n) == 0 && is_blank(p[n]);
+}
+
+/// the next token of [p, end), p moves past it, empty at the end of the line
+std::pair<const char*, const char*> next_token(const char*& p, const char* end)
+{
+    while (p < end && is_blank(*p)) p++;
+    const char* begin = p;
+    while (p < end && !is_blank(*p)) p++;
+    return {begin, p};
+}
+
+double parse_double(const char*& p, const char* end)
+{
+    const auto [begin, stop] = next_token(p, end);
+    char buffer[64];
+    const size_t n = size_t(stop - begin);
+    if (n == 0 || n >= sizeof(buffer)) throw std::runtime_error("Expected a coordinate");
+    std::memcpy(buffer, begin, n);
+    buffer[n] = '\0';
+    char* parsed;
+    const double value = std::strtod(buffer, &parsed);
+    if (parsed != buffer + n) throw std::runtime_error("Invalid coordinate");
+    return value;
+}
+
+/// the vertex id at the start of an OBJ face token, up to the first '/'
+long long parse_index(const char* p, const char* end)
+{
+    const bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    if (p == end || !std::isdigit((unsigned char)*p)) throw std::runtime_error("Invalid OBJ face");
+    long long value = 0;
+    while (p < end && std::isdigit((unsigned char)*p)) value = 10 * value + (*p++ - '0');
+    if (p < end && *p != '/') throw std::runtime_error("Invalid OBJ face");
+    return negative ? -value : value;
+}
+
+/// a triangle corner, the corners of triangle t are 3t, 3t + 1, 3t + 2
+template <typename Scalar>
+struct Corner
+{
+    std::array<Scalar, 3> position;
+    size_t id;
+
+    bool operator<(const Corner& c) const
+    {
+        return position != c.position ? position < c.position : id < c.id;
+    }
+};
+
+/**
+ * Merges the corners with the same position, sorting them in place. Vertices are numbered in
+ * order of first appearance.
+ */
+template <typename Scalar>
+void weld_corners(
+    std::vector<Corner<Scalar>>& corners,
+    std::vector<Eigen::Vector3d>& vertices,
+    std::vector<std::array<size_t, 3>>& faces)
+{
+    const size_t n = corners.size();
+    tbb::parallel_sort(corners.begin(), corners.end());
+
+    // the first corner of each group, as it has the smallest id
+    std::vector<size_t> first_corner(n);
+    std::vector<uint8_t> is_first(n, 0);
+    for (size_t i = 0, first = 0; i < n; i++) {
+        if (i == 0 || corners[i].position != corners[i - 1].position) {
+            first = corners[i].id;
+            is_first[first] = 1;
+        }
+        first_corner[corners[i].id] = first;
+    }
+    std::vector<size_t> vertex_ids(n);
+    size_t num_vertices = 0;
+    for (size_t c = 0; c < n; c++) {
+        vertex_ids[c] = num_vertices;
+        num_vertices += is_first[c];
+    }
+
+    vertices.resize(num_vertices);
+    faces.resize(n / 3);
+    tbb::parallel_for(size_t(0), n, [&](size_t i) {
+        const auto& corner = corners[i];
+        const size_t v = vertex_ids[first_corner[corner.id]];
+        faces[corner.id / 3][corner.id % 3] = v;
+        if (is_first[corner.id]) {
+            const auto& p = corner.position;
+            vertices[v] = Eigen::Vector3d(p[0], p[1], p[2]);
+        }
+    });
+}
+
+void read_binary_stl(const MappedFile& file, std::vector<Corner<float>>& corners)
+{
+    uint32_t num_triangles;
+    std::memcpy(&num_triangles, file.data() + 80, sizeof(uint32_t));
+    corners.resize(3 * size_t(num_triangles));
+    // each triangle is a normal, 3 corners (12 floats) and a 2 bytes attribute
+    tbb::parallel_for(size_t(0), size_t(num_triangles), [&](size_t t) {
+        const char* record = file.data() + 84 + 50 * t;
+        for (size_t j = 0; j < 3; j++) {
+            auto& corner = corners[3 * t + j];
+            std::memcpy(corner.position.data(), record + 12 * (j + 1), 3 * sizeof(float));
+            corner.id = 3 * t + j;
+        }
+    });
+}
+
+void read_ascii_stl(const MappedFile& file, std::vector<Corner<double>>& corners)
+{
+    const auto chunks = line_chunks(file.data(), file.size());
+    std::vector<size_t> offsets(chunks.size() + 1, 0);
+    tbb::parallel_for(size_t(0), chunks.size(), [&](size_t c) {
+        for_each_line(chunks[c].first, chunks[c].second, [&](const char* p, const char* end) {
+            if (starts_with(p, end, "vertex")) offsets[c + 1]++;
+        });
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    if (offsets.back() % 3 != 0) throw std::runtime_error("STL facets need 3 vertices");
+
+    corners.resize(offsets.back());
+    tbb::parallel_for(size_t(0), chunks.size(), [&](size_t c) {
+        size_t next = offsets[c];
+        for_each_line(chunks[c].first, chunks[c].second, [&](const char* p, const char* end) {
+            if (!starts_with(p, end, "vertex")) return;
+            p += 6;
+            auto& corner = corners[next];
+            for (int j = 0; j < 3; j++) corner.position[j] = parse_double(p, end);
+            corner.id = next++;
+        });
+    });
+}
+
+void read_obj(
+    const MappedFile& file,
+    std::vector<Eigen::Vector3d>& vertices,
+    std::vector<std::array<size_t, 3>>& faces)
+{
+    // number of vertices and triangles of each chunk, then where they start
+    const auto chunks = line_chunks(file.data(), file.size());
+    std::vector<size_t> vertex_offsets(chunks.size() + 1, 0), face_offsets(chunks.size() + 1, 0);
+    tbb::parallel_for(size_t(0), chunks.size(), [&](size_t c) {
+        for_each_line(chunks[c].first, chunks[c].second, [&](const char* p, const char* end) {
+            if (starts_with(p, end, "v")) {
+                vertex_offsets[c + 1]++;
+            } else if (starts_with(p, end, "f")) {
+                p++;
+                size_t k = 0;
+                while (next_token(p, end).first != end) k++;
+                if (k < 3) throw std::runtime_error("OBJ faces need 3 vertices");
+                face_offsets[c + 1] += k - 2;
+            }
+        });
+    });
+    std::partial_sum(vertex_offsets.begin(), vertex_offsets.end(), vertex_offsets.begin());
+    std::partial_sum(face_offsets.begin(), face_offsets.end(), face_offsets.begin());
+
+    const size_t num_vertices = vertex_offsets.back();
+    vertices.resize(num_vertices);
+    faces.resize(face_offsets.back());
+    tbb::parallel_for(size_t(0), chunks.size(), [&](size_t c) {
+        size_t next_vertex = vertex_offsets[c], next_face = face_offsets[c];
+        std::vector<size_t> polygon;
+        for_each_line(chunks[c].first, chunks[c].second, [&](const char* p, const char* end) {
+            if (starts_with(p, end, "v")) {
+                p++;
+                auto& v = vertices[next_vertex++];
+                for (int j = 0; j < 3; j++) v[j] = parse_double(p, end);
+            } else if (starts_with(p, end, "f")) {
+                p++;
+                polygon.clear();
+                for (auto token = next_token(p, end); token.first != token.second;
+                     token = next_token(p, end)) {
+                    // "v", "v/vt", "v//vn" or "v/vt/vn", negative ids count back from the last
+                    // vertex read
+                    const long long id = parse_index(token.first, token.second);
+                    const long long v = id > 0 ? id - 1 : (long long)next_vertex + id;
+                    if (id == 0 || v < 0 || size_t(v) >= num_vertices) {
+                        throw std::runtime_error("OBJ face refers to a missing vertex");
+                    }
+                    polygon.push_back(size_t(v));
+                }
+                for (size_t j = 1; j + 1 < polygon.size(); j++) {
+                    faces[next_face++] = {{polygon[0], polygon[j], polygon[j + 1]}};
+                }
+            }
+        });
+    });
+}
+
+std::string extension(const std::string& path)
+{
+    const auto dot = path.find_last_of('.');
+    if (dot == std::string::npos) return "";
+    std::string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+        return char(std::tolower(c));
+    });
+    return ext;
+}
+} // namespace
+
+bool read_surface_mesh(
+    const std::string& path,
+    std::vector<Eigen::Vector3d>& vertices,
+    std::vector<std::array<size_t, 3>>& faces)
+{
+    const std::string ext = extension(path);
+    if (ext != "stl" && ext != "obj") return false;
+
+    const MappedFile file(path);
+    if (ext == "obj") {
+        read_obj(file, vertices, faces);
+        return true;
+    }
+
+    // binary files may also start with "solid", their size tells them apart
+    bool is_binary = false;
+    if (file.size() >= 84) {
+        uint32_t num_triangles;
+        std::memcpy(&num_triangles, file.data() + 80, sizeof(uint32_t));
+        is_binary = file.size() == 84 + 50 * size_t(num_triangles);
+    }
+    if (is_binary) {
+        std::vector<Corner<float>> corners;
+        read_binary_stl(file, corners);
+        weld_corners(corners, vertices, faces);
+    } else {
+        if (file.size() < 5 || std::memcmp(file.data(), "solid", 5) != 0) {
+            throw std::runtime_error(path + " is neither a binary nor an ASCII STL");
+        }
+        std::vector<Corner<double>> corners;
+        read_ascii_stl(file, corners);
+        weld_corners(corners, vertices, faces);
+    }
+    return true;
+}
+
+} // namespace wmtk
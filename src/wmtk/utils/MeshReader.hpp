@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief Reads a triangle mesh from a binary or ASCII STL or an OBJ file straight into the
+ * buffers the apps use, without going through GEO::Mesh or Eigen matrices.
+ *
+ * The file is memory mapped and parsed in parallel chunks. The corners of STL triangles with the
+ * same coordinates are merged into one vertex while parsing, the vertices are numbered in order of
+ * first appearance. OBJ polygons are split into fans around their first vertex, other elements
+ * (normals, texture coordinates, groups, ...) are ignored.
+ *
+ * @return false if the extension is neither .stl nor .obj, the file is not read
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+bool read_surface_mesh(
+    const std::string& path,
+    std::vector<Eigen::Vector3d>& vertices,
+    std::vector<std::array<size_t, 3>>& faces);
+
+} // namespace wmtk
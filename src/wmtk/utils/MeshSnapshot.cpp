@@ -0,0 +1,460 @@
+#include "MeshSnapshot.hpp"
+
+#include <wmtk/TetMesh.h>
+#include <wmtk/TriMesh.h>
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wmtk {
+
+namespace {
+constexpr char magic[8] = {'W', 'M', 'T', 'K', 'S', 'N', 'A', 'P'};
+constexpr uint32_t byte_order_mark = 0x01020304;
+constexpr size_t alignment = 64;
+constexpr uint32_t byte_code = MeshSnapshotWriter::scalar_code<uint8_t>();
+constexpr uint32_t id_code = MeshSnapshotWriter::scalar_code<uint64_t>();
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t dimension;
+    uint32_t reserved;
+    uint64_t num_vertices;
+    uint64_t num_cells;
+    uint64_t num_sections;
+    uint64_t padding[2];
+};
+static_assert(sizeof(Header) == alignment, "the sections table starts aligned");
+
+size_t align(size_t offset)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+struct MeshSnapshot::SectionEntry
+{
+    char name[40]; // zero terminated
+    uint64_t offset; // from the start of the file
+    uint64_t size; // number of elements
+    uint32_t element_size; // in bytes
+    uint32_t scalar_code;
+};
+
+/**
+ * A whole file in memory, mapped on POSIX systems, read into a buffer on Windows.
+ */
+struct MeshSnapshot::Mapping
+{
+    char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    std::vector<char> buffer;
+    std::string filename;
+    bool writable = false;
+#endif
+
+    static std::unique_ptr<Mapping> open(const std::string& filename)
+    {
+        auto m = std::make_unique<Mapping>();
+#ifdef _WIN32
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open snapshot " + filename);
+        m->buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        m->data = m->buffer.data();
+        m->size = m->buffer.size();
+#else
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open snapshot " + filename);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read snapshot " + filename);
+        }
+        m->size = size_t(st.st_size);
+        void* p = mmap(nullptr, m->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot map snapshot " + filename);
+        m->data = static_cast<char*>(p);
+#endif
+        return m;
+    }
+
+    static std::unique_ptr<Mapping> create(const std::string& filename, size_t size)
+    {
+        auto m = std::make_unique<Mapping>();
+        m->size = size;
+#ifdef _WIN32
+        m->buffer.assign(size, 0);
+        m->data = m->buffer.data();
+        m->filename = filename;
+        m->writable = true;
+#else
+        const int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("Cannot create snapshot " + filename);
+        // allocate the blocks up front: writing to a hole of a shared mapping on a full disk
+        // raises SIGBUS instead of returning an error
+        if (!allocate(fd, size)) {
+            ::close(fd);
+            throw std::runtime_error("Cannot allocate snapshot " + filename);
+        }
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot map snapshot " + filename);
+        m->data = static_cast<char*>(p);
+#endif
+        return m;
+    }
+
+    /// writes a created mapping back to the file and waits for it, false if that fails
+    bool flush()
+    {
+#ifdef _WIN32
+        std::ofstream out(filename, std::ios::binary);
+        out.write(buffer.data(), std::streamsize(buffer.size()));
+        writable = false;
+        return bool(out);
+#else
+        return msync(data, size, MS_SYNC) == 0;
+#endif
+    }
+
+#ifndef _WIN32
+    static bool allocate(int fd, size_t size)
+    {
+#ifdef __APPLE__
+        fstore_t store = {F_ALLOCATEALL, F_PEOFPOSMODE, 0, off_t(size), 0};
+        if (fcntl(fd, F_PREALLOCATE, &store) == -1) return false;
+        return ftruncate(fd, off_t(size)) == 0;
+#else
+        return posix_fallocate(fd, 0, off_t(size)) == 0;
+#endif
+    }
+#endif
+
+    ~Mapping()
+    {
+#ifdef _WIN32
+        if (writable) {
+            std::ofstream out(filename, std::ios::binary);
+            out.write(buffer.data(), std::streamsize(buffer.size()));
+        }
+#else
+        if (data != nullptr) munmap(data, size);
+#endif
+    }
+};
+
+template <typename Cells, typename Vertices>
+void MeshSnapshotWriter::add_mesh_sections(
+    int dimension,
+    size_t num_vertices,
+    size_t num_cells,
+    const Cells& cells,
+    const Vertices& vertices)
+{
+    m_dimension = dimension;
+    m_num_vertices = num_vertices;
+    m_num_cells = num_cells;
+
+    m_star_offsets.resize(num_vertices + 1);
+    m_star_offsets[0] = 0;
+    for (size_t v = 0; v < num_vertices; v++)
+        m_star_offsets[v + 1] = m_star_offsets[v] + vertices(v).size();
+    const uint64_t* offsets = m_star_offsets.data();
+
+    const Cells* conn = &cells;
+    const size_t cell_size = dimension + 1;
+    add_section("cells", num_cells, cell_size * 8, id_code, [=](char* out, size_t b, size_t e) {
+        auto* ids = reinterpret_cast<uint64_t*>(out);
+        for (size_t i = b; i < e; i++)
+            for (size_t j = 0; j < cell_size; j++) *ids++ = (*conn)[i].m_indices[j];
+    });
+    add_section("cell_removed", num_cells, 1, byte_code, [=](char* out, size_t b, size_t e) {
+        for (size_t i = b; i < e; i++) *out++ = (*conn)[i].m_is_removed;
+    });
+    add_section("vertex_removed", num_vertices, 1, byte_code, [=](char* out, size_t b, size_t e) {
+        for (size_t i = b; i < e; i++) *out++ = vertices.removed(i);
+    });
+    add_section("star_offsets", num_vertices + 1, 8, id_code, [=](char* out, size_t b, size_t e) {
+        std::memcpy(out, offsets + b, (e - b) * 8);
+    });
+    add_section(
+        "stars",
+        offsets[num_vertices],
+        8,
+        id_code,
+        [=](char* out, size_t b, size_t e) {
+            auto* ids = reinterpret_cast<uint64_t*>(out);
+            for (size_t v = b; v < e; v++)
+                for (auto c : vertices(v)) *ids++ = c;
+        },
+        offsets);
+}
+
+namespace {
+/**
+ * Vertex stars and removed flags of the connectivity of a mesh.
+ */
+template <typename Connectivity, typename Member>
+struct VertexStars
+{
+    const Connectivity& conn;
+    Member star;
+    const auto& operator()(size_t v) const { return conn[v].*star; }
+    bool removed(size_t v) const { return conn[v].m_is_removed; }
+};
+template <typename Connectivity, typename Member>
+VertexStars<Connectivity, Member> vertex_stars(const Connectivity& conn, Member star)
+{
+    return {conn, star};
+}
+} // namespace
+
+MeshSnapshotWriter::MeshSnapshotWriter(const TetMesh& mesh)
+{
+    add_mesh_sections(
+        3,
+        mesh.vert_capacity(),
+        mesh.tet_capacity(),
+        mesh.m_tet_connectivity,
+        vertex_stars(mesh.m_vertex_connectivity, &TetMesh::VertexConnectivity::m_conn_tets));
+}
+
+MeshSnapshotWriter::MeshSnapshotWriter(const TriMesh& mesh)
+{
+    add_mesh_sections(
+        2,
+        mesh.vert_capacity(),
+        mesh.tri_capacity(),
+        mesh.m_tri_connectivity,
+        vertex_stars(mesh.m_vertex_connectivity, &TriMesh::VertexConnectivity::m_conn_tris));
+}
+
+void MeshSnapshotWriter::add_section(
+    const std::string& name,
+    size_t size,
+    size_t element_size,
+    uint32_t scalar_code,
+    Fill fill,
+    const uint64_t* vertex_offsets)
+{
+    if (name.size() >= sizeof(MeshSnapshot::SectionEntry::name)) {
+        throw std::runtime_error("Snapshot section name too long: " + name);
+    }
+    for (const auto& s : m_sections) {
+        if (s.name == name) throw std::runtime_error("Duplicate snapshot section " + name);
+    }
+    m_sections.push_back({name, size, element_size, scalar_code, std::move(fill), vertex_offsets});
+}
+
+void MeshSnapshotWriter::write(const std::string& filename) const
+{
+    using SectionEntry = MeshSnapshot::SectionEntry;
+    std::vector<SectionEntry> table(m_sections.size());
+    size_t offset = align(sizeof(Header) + table.size() * sizeof(SectionEntry));
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        const auto& s = m_sections[i];
+        auto& entry = table[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::copy(s.name.begin(), s.name.end(), entry.name);
+        entry.offset = offset;
+        entry.size = s.size;
+        entry.element_size = uint32_t(s.element_size);
+        entry.scalar_code = s.scalar_code;
+        offset = align(offset + s.size * s.element_size);
+    }
+
+    auto mapping = MeshSnapshot::Mapping::create(filename, offset);
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::copy(std::begin(magic), std::end(magic), header.magic);
+    header.version = version;
+    header.byte_order = byte_order_mark;
+    header.dimension = m_dimension;
+    header.num_vertices = m_num_vertices;
+    header.num_cells = m_num_cells;
+    header.num_sections = table.size();
+    std::memcpy(mapping->data, &header, sizeof(header));
+    std::memcpy(mapping->data + sizeof(header), table.data(), table.size() * sizeof(SectionEntry));
+
+    // every section in chunks, the sections in parallel as well
+    tbb::parallel_for(size_t(0), m_sections.size(), [&](size_t i) {
+        const auto& s = m_sections[i];
+        char* out = mapping->data + table[i].offset;
+        if (s.vertex_offsets != nullptr) {
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, m_num_vertices),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    const size_t begin = s.vertex_offsets[r.begin()];
+                    s.fill(out + begin * s.element_size, r.begin(), r.end());
+                });
+            return;
+        }
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, s.size),
+            [&](const tbb::blocked_range<size_t>& r) {
+                s.fill(out + r.begin() * s.element_size, r.begin(), r.end());
+            });
+    });
+    if (!mapping->flush()) throw std::runtime_error("Cannot write snapshot " + filename);
+}
+
+MeshSnapshot::MeshSnapshot(const std::string& filename)
+    : m_mapping(Mapping::open(filename))
+{
+    static_assert(sizeof(SectionEntry) == alignment, "the sections stay aligned");
+    Header header;
+    if (m_mapping->size < sizeof(Header)) {
+        throw std::runtime_error("Truncated snapshot " + filename);
+    }
+    std::memcpy(&header, m_mapping->data, sizeof(header));
+    if (!std::equal(std::begin(magic), std::end(magic), header.magic)) {
+        throw std::runtime_error(filename + " is not a mesh snapshot");
+    }
+    if (header.version != MeshSnapshotWriter::version) {
+        throw std::runtime_error(
+            "Snapshot " + filename + " has version " + std::to_string(header.version) +
+            ", expected " + std::to_string(MeshSnapshotWriter::version));
+    }
+    if (header.byte_order != byte_order_mark) {
+        throw std::runtime_error("Snapshot " + filename + " was written with another byte order");
+    }
+    if (header.dimension != 2 && header.dimension != 3) {
+        throw std::runtime_error("Snapshot " + filename + " has an invalid dimension");
+    }
+
+    m_num_sections = header.num_sections;
+    m_table = reinterpret_cast<const SectionEntry*>(m_mapping->data + sizeof(Header));
+    if (m_num_sections > (m_mapping->size - sizeof(Header)) / sizeof(SectionEntry)) {
+        throw std::runtime_error("Truncated snapshot " + filename);
+    }
+    for (size_t i = 0; i < m_num_sections; i++) {
+        const auto& s = m_table[i];
+        const bool named = std::find(std::begin(s.name), std::end(s.name), 0) != std::end(s.name);
+        const bool aligned = s.offset % alignment == 0 && s.element_size > 0;
+        if (!named || !aligned || s.offset > m_mapping->size ||
+            s.size > (m_mapping->size - s.offset) / s.element_size) {
+            throw std::runtime_error("Corrupted section table in snapshot " + filename);
+        }
+    }
+
+    m_dimension = int(header.dimension);
+    m_num_vertices = header.num_vertices;
+    m_num_cells = header.num_cells;
+    m_cells = mesh_section<uint64_t>("cells", m_num_cells * (m_dimension + 1));
+    m_cell_removed = mesh_section<uint8_t>("cell_removed", m_num_cells);
+    m_vertex_removed = mesh_section<uint8_t>("vertex_removed", m_num_vertices);
+    m_star_offsets = mesh_section<uint64_t>("star_offsets", m_num_vertices + 1);
+    m_stars = mesh_section<uint64_t>("stars", m_star_offsets[m_num_vertices]);
+}
+
+MeshSnapshot::~MeshSnapshot() = default;
+
+void MeshSnapshot::check_connectivity() const
+{
+    if (m_star_offsets[0] != 0) {
+        throw std::runtime_error("Snapshot star offsets do not start at 0");
+    }
+    const size_t cell_size = m_dimension + 1;
+    std::atomic<bool> valid_offsets = true, valid_cells = true, valid_stars = true;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, std::max(m_num_vertices, m_num_cells)),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                if (i < m_num_vertices && m_star_offsets[i] > m_star_offsets[i + 1]) {
+                    valid_offsets = false;
+                }
+                if (i < m_num_cells) {
+                    const uint64_t* cell = m_cells + i * cell_size;
+                    for (size_t j = 0; j < cell_size; j++) {
+                        if (cell[j] >= m_num_vertices) valid_cells = false;
+                    }
+                }
+            }
+        });
+    // the size of the stars section was checked against the last offset when opening
+    if (!valid_offsets) throw std::runtime_error("Snapshot star offsets are not increasing");
+    if (!valid_cells) throw std::runtime_error("Snapshot cell with an invalid vertex id");
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, m_star_offsets[m_num_vertices]),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                if (m_stars[i] >= m_num_cells) valid_stars = false;
+            }
+        });
+    if (!valid_stars) throw std::runtime_error("Snapshot vertex star with an invalid cell id");
+}
+
+const MeshSnapshot::SectionEntry* MeshSnapshot::find(const std::string& name) const
+{
+    for (size_t i = 0; i < m_num_sections; i++) {
+        if (name == m_table[i].name) return &m_table[i];
+    }
+    return nullptr;
+}
+
+const char* MeshSnapshot::section(
+    const std::string& name,
+    uint32_t scalar_code,
+    size_t& size,
+    size_t& element_size) const
+{
+    const auto* s = find(name);
+    if (s == nullptr) throw std::runtime_error("Snapshot has no section " + name);
+    if (s->scalar_code != scalar_code || s->element_size % (scalar_code & 0xff) != 0) {
+        throw std::runtime_error("Snapshot section " + name + " holds another type");
+    }
+    size = s->size;
+    element_size = s->element_size;
+    return m_mapping->data + s->offset;
+}
+
+template <typename T>
+const T* MeshSnapshot::mesh_section(const std::string& name, size_t expected_size) const
+{
+    size_t size, element_size;
+    const char* data =
+        section(name, MeshSnapshotWriter::scalar_code<T>(), size, element_size);
+    if (size * element_size != expected_size * sizeof(T)) {
+        throw std::runtime_error("Snapshot section " + name + " has a wrong size");
+    }
+    return reinterpret_cast<const T*>(data);
+}
+
+std::vector<std::string> MeshSnapshot::attribute_names() const
+{
+    std::vector<std::string> names;
+    for (size_t i = 0; i < m_num_sections; i++) {
+        const std::string name = m_table[i].name;
+        if (name.rfind("attr.", 0) == 0) names.push_back(name.substr(5));
+    }
+    return names;
+}
+
+bool MeshSnapshot::has_attribute(const std::string& name) const
+{
+    return find("attr." + name) != nullptr;
+}
+
+} // namespace wmtk
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace wmtk {
+class TetMesh;
+class TriMesh;
+
+/**
+ * @brief Native binary snapshot of a TetMesh or TriMesh, meant to hand meshes from one stage of a
+ * pipeline to the next without going through MSH.
+ *
+ * The file is a 64 byte header (magic "WMTKSNAP", version, simplex dimension, element counts), a
+ * table of named sections and the sections themselves, each aligned to 64 bytes:
+ *   "cells"          dimension + 1 uint64 vertex ids per cell (tet or triangle)
+ *   "cell_removed"   one byte per cell
+ *   "vertex_removed" one byte per vertex
+ *   "star_offsets"   num_vertices + 1 uint64, the cells around vertex v are
+ *   "stars"          stars[star_offsets[v]] to stars[star_offsets[v + 1]] (CSR)
+ *   "attr.<name>"    a raw attribute column, a fixed number of scalars per element
+ * Values are stored in native byte order, the header records it and loading checks it. The ids
+ * are those of the mesh, removed elements included, so that attribute columns stay aligned with
+ * them; consolidate the mesh first to get a compact file.
+ */
+class MeshSnapshotWriter
+{
+public:
+    static constexpr uint32_t version = 1;
+
+    /**
+     * Collects the sections of the mesh, they are only read by write(), the mesh must outlive
+     * the writer and must not change in between.
+     */
+    explicit MeshSnapshotWriter(const TetMesh& mesh);
+    explicit MeshSnapshotWriter(const TriMesh& mesh);
+    MeshSnapshotWriter(const MeshSnapshotWriter&) = delete;
+    MeshSnapshotWriter& operator=(const MeshSnapshotWriter&) = delete;
+
+    /**
+     * @brief Adds the column "attr.<name>" of size elements with NUM_FIELDS scalars each.
+     * get_attribute_cb(i) returns a Scalar if NUM_FIELDS is 1, something indexable with [j]
+     * otherwise. It is called from several threads during write().
+     */
+    template <typename Scalar, int NUM_FIELDS = 1, typename Fn>
+    void add_attribute(const std::string& name, size_t size, Fn get_attribute_cb)
+    {
+        static_assert(std::is_arithmetic_v<Scalar>, "Attribute columns hold plain scalars");
+        static_assert(NUM_FIELDS >= 1, "An attribute has at least one field");
+        add_section(
+            "attr." + name,
+            size,
+            sizeof(Scalar) * NUM_FIELDS,
+            scalar_code<Scalar>(),
+            [get_attribute_cb](char* out, size_t begin, size_t end) {
+                auto* column = reinterpret_cast<Scalar*>(out);
+                for (size_t i = begin; i < end; i++, column += NUM_FIELDS) {
+                    const auto& attr = get_attribute_cb(i);
+                    if constexpr (NUM_FIELDS == 1) {
+                        column[0] = attr;
+                    } else {
+                        for (int j = 0; j < NUM_FIELDS; j++) column[j] = attr[j];
+                    }
+                }
+            });
+    }
+
+    /**
+     * @brief Writes the file, the sections are filled in parallel directly in a mapping of it.
+     * The whole file is allocated first and the mapping synced at the end.
+     * @throws std::runtime_error if the file cannot be created, e.g. if the disk is full
+     */
+    void write(const std::string& filename) const;
+
+    /// (internal use) type tag of a column: kind of scalar and its size
+    template <typename Scalar>
+    static constexpr uint32_t scalar_code()
+    {
+        const uint32_t kind = std::is_floating_point_v<Scalar> ? 2 : std::is_signed_v<Scalar>;
+        return (kind << 8) | uint32_t(sizeof(Scalar));
+    }
+
+private:
+    /// fills the elements [begin, end) of a section, out points to the element begin
+    using Fill = std::function<void(char* out, size_t begin, size_t end)>;
+    struct Section
+    {
+        std::string name;
+        size_t size; // number of elements
+        size_t element_size; // in bytes
+        uint32_t scalar_code;
+        Fill fill;
+        // if set, fill takes ranges of vertices, whose elements start at vertex_offsets[begin]
+        const uint64_t* vertex_offsets;
+    };
+
+    template <typename Cells, typename Vertices>
+    void add_mesh_sections(
+        int dimension,
+        size_t num_vertices,
+        size_t num_cells,
+        const Cells& cells,
+        const Vertices& vertices);
+    void add_section(
+        const std::string& name,
+        size_t size,
+        size_t element_size,
+        uint32_t scalar_code,
+        Fill fill,
+        const uint64_t* vertex_offsets = nullptr);
+
+    int m_dimension = 0;
+    size_t m_num_vertices = 0;
+    size_t m_num_cells = 0;
+    std::vector<uint64_t> m_star_offsets;
+    std::vector<Section> m_sections;
+};
+
+/**
+ * @brief Raw attribute column of a snapshot, pointing into the mapped file.
+ */
+template <typename Scalar>
+struct SnapshotColumn
+{
+    const Scalar* data = nullptr;
+    size_t size = 0; // number of elements
+    int num_fields = 0; // scalars per element
+
+    const Scalar* operator[](size_t i) const { return data + i * num_fields; }
+};
+
+/**
+ * @brief A snapshot written by MeshSnapshotWriter, mapped in memory.
+ *
+ * Opening only checks the header and the section table, the sections are used in place, without
+ * parsing or copying. The accessors point into the mapping, they stay valid as long as the
+ * snapshot is alive. TetMesh::init and TriMesh::create_mesh take a snapshot directly.
+ */
+class MeshSnapshot
+{
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be mapped, is not a snapshot, has another
+     * version or byte order, or is truncated
+     */
+    explicit MeshSnapshot(const std::string& filename);
+    ~MeshSnapshot();
+    MeshSnapshot(const MeshSnapshot&) = delete;
+    MeshSnapshot& operator=(const MeshSnapshot&) = delete;
+
+    /// 3 for a TetMesh, 2 for a TriMesh
+    int dimension() const { return m_dimension; }
+    size_t num_vertices() const { return m_num_vertices; }
+    size_t num_cells() const { return m_num_cells; }
+
+    /// dimension() + 1 vertex ids per cell
+    const uint64_t* cells() const { return m_cells; }
+    const uint8_t* cell_removed() const { return m_cell_removed; }
+    const uint8_t* vertex_removed() const { return m_vertex_removed; }
+    /// the cells around vertex v are stars()[star_offsets()[v]] to stars()[star_offsets()[v + 1]]
+    const uint64_t* star_offsets() const { return m_star_offsets; }
+    const uint64_t* stars() const { return m_stars; }
+
+    /**
+     * @brief Checks that the star offsets increase and that the cells and stars only hold ids
+     * of existing vertices and cells. TetMesh::init and TriMesh::create_mesh call it first.
+     * @throws std::runtime_error otherwise
+     */
+    void check_connectivity() const;
+
+    std::vector<std::string> attribute_names() const;
+    bool has_attribute(const std::string& name) const;
+
+    /**
+     * @throws std::runtime_error if there is no such attribute or if it holds another scalar type
+     */
+    template <typename Scalar>
+    SnapshotColumn<Scalar> attribute(const std::string& name) const
+    {
+        size_t size, element_size;
+        const auto code = MeshSnapshotWriter::scalar_code<Scalar>();
+        const char* data = section("attr." + name, code, size, element_size);
+        return {reinterpret_cast<const Scalar*>(data), size, int(element_size / sizeof(Scalar))};
+    }
+
+private:
+    friend class MeshSnapshotWriter;
+    struct Mapping;
+    struct SectionEntry;
+
+    const SectionEntry* find(const std::string& name) const;
+    const char* section(
+        const std::string& name,
+        uint32_t scalar_code,
+        size_t& size,
+        size_t& element_size) const;
+    template <typename T>
+    const T* mesh_section(const std::string& name, size_t expected_size) const;
+
+    std::unique_ptr<Mapping> m_mapping;
+    const SectionEntry* m_table = nullptr;
+    size_t m_num_sections = 0;
+    int m_dimension = 0;
+    size_t m_num_vertices = 0;
+    size_t m_num_cells = 0;
+    const uint64_t* m_cells = nullptr;
+    const uint8_t* m_cell_removed = nullptr;
+    const uint8_t* m_vertex_removed = nullptr;
+    const uint64_t* m_star_offsets = nullptr;
+    const uint64_t* m_stars = nullptr;
+};
+
+} // namespace wmtk
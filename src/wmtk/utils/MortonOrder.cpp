@@ -0,0 +1,61 @@
+#include "MortonOrder.hpp"
+
+#include <wmtk/utils/Morton.h>
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <utility>
+
+namespace wmtk {
+
+namespace {
+// the envelope codes a handful of triangles per operation, those run inline
+constexpr size_t parallel_grain = 4096;
+} // namespace
+
+std::vector<uint64_t> morton_codes(
+    const std::vector<Eigen::Vector3d>& points,
+    const Eigen::Vector3d& lo,
+    double extent)
+{
+    constexpr double max_code = (1 << 20) - 1;
+    const double scale = extent > 0 ? max_code / extent : 0;
+    std::vector<uint64_t> codes(points.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, points.size(), parallel_grain),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const Eigen::Vector3d q =
+                    ((points[i] - lo) * scale).cwiseMax(0.).cwiseMin(max_code);
+                codes[i] = uint64_t(
+                    Resorting::MortonCode64(uint32_t(q[0]), uint32_t(q[1]), uint32_t(q[2])));
+            }
+        });
+    return codes;
+}
+
+std::vector<uint32_t> morton_order(const std::vector<Eigen::Vector3d>& points)
+{
+    const size_t n = points.size();
+    if (n == 0) return {};
+    Eigen::Vector3d lo = points[0], hi = points[0];
+    for (size_t i = 1; i < n; i++) {
+        lo = lo.cwiseMin(points[i]);
+        hi = hi.cwiseMax(points[i]);
+    }
+    const auto codes = morton_codes(points, lo, (hi - lo).maxCoeff());
+    std::vector<std::pair<uint64_t, uint32_t>> sorted(n);
+    for (size_t i = 0; i < n; i++) sorted[i] = {codes[i], uint32_t(i)};
+    tbb::parallel_sort(sorted.begin(), sorted.end());
+    std::vector<uint32_t> order(n);
+    for (size_t i = 0; i < n; i++) order[i] = sorted[i].second;
+    return order;
+}
+
+} // namespace wmtk
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief 64-bit Morton codes of points quantized to 20 bits per axis (the top bits of
+ * Resorting::MortonCode64 are flags) in the cube [lo, lo + extent]^3. Points outside the cube
+ * are clamped to it. Large inputs are coded in parallel.
+ */
+std::vector<uint64_t> morton_codes(
+    const std::vector<Eigen::Vector3d>& points,
+    const Eigen::Vector3d& lo,
+    double extent);
+
+/// Indices of the points sorted along the Morton curve of their bounding box.
+std::vector<uint32_t> morton_order(const std::vector<Eigen::Vector3d>& points);
+
+} // namespace wmtk
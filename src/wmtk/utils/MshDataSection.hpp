@@ -0,0 +1,60 @@
+#pragma once
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wmtk::msh_data {
+
+/**
+ * @brief Writes "$<section>" and the tags of a $NodeData or $ElementData section of a MSH 4.1
+ * file, the entries follow.
+ */
+inline void write_header(
+    std::ostream& out,
+    const std::string& section,
+    const std::vector<std::string>& string_tags,
+    const std::vector<double>& real_tags,
+    const std::vector<int>& int_tags)
+{
+    out << "$" << section << "\n";
+    out << string_tags.size() << "\n";
+    for (const auto& tag : string_tags) out << "\"" << tag << "\"\n";
+    out << real_tags.size() << "\n";
+    for (const auto& tag : real_tags) out << tag << "\n";
+    out << int_tags.size() << "\n";
+    for (const auto& tag : int_tags) out << tag << "\n";
+}
+
+/**
+ * @brief Writes n binary entries of a data section, entry i is the int tag first_tag + i followed
+ * by the num_fields doubles values[i * num_fields], ... The entries are packed in parallel into
+ * buffer, which is reused from one call to the next, so a section can be written in chunks.
+ */
+inline void write_binary_entries(
+    std::ostream& out,
+    size_t first_tag,
+    const double* values,
+    size_t n,
+    size_t num_fields,
+    std::vector<char>& buffer)
+{
+    const size_t entry_size = sizeof(int) + sizeof(double) * num_fields;
+    buffer.resize(n * entry_size);
+    tbb::parallel_for(size_t(0), n, [&](size_t i) {
+        char* entry = buffer.data() + i * entry_size;
+        const int tag = int(first_tag + i);
+        std::memcpy(entry, &tag, sizeof(int));
+        std::memcpy(entry + sizeof(int), values + i * num_fields, sizeof(double) * num_fields);
+    });
+    out.write(buffer.data(), std::streamsize(buffer.size()));
+}
+
+} // namespace wmtk::msh_data
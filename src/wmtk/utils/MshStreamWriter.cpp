@@ -0,0 +1,186 @@
+#include "MshStreamWriter.hpp"
+
+#include <wmtk/TetMesh.h>
+#include <wmtk/utils/MshDataSection.hpp>
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <fstream>
+#include <stdexcept>
+
+namespace wmtk {
+
+namespace {
+constexpr size_t chunk_size = size_t(1) << 20; // ids per chunk
+
+template <typename T>
+void write_binary(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void write_binary(std::ostream& out, const std::vector<T>& values, size_t n)
+{
+    out.write(reinterpret_cast<const char*>(values.data()), n * sizeof(T));
+}
+
+// calls fill(ids, n, out) on subranges of ids in parallel, out has num_fields values per id
+void parallel_fill(
+    const std::function<void(const size_t*, size_t, double*)>& fill,
+    const size_t* ids,
+    size_t n,
+    int num_fields,
+    double* out)
+{
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n), [&](const tbb::blocked_range<size_t>& r) {
+        fill(ids + r.begin(), r.size(), out + r.begin() * num_fields);
+    });
+}
+} // namespace
+
+MshStreamWriter::MshStreamWriter(const TetMesh& mesh)
+    : m_mesh(mesh)
+{
+    const size_t n_vertices = mesh.vert_capacity();
+    for (size_t i = 0; i < n_vertices; i++) {
+        if (!mesh.m_vertex_connectivity[i].m_is_removed) m_num_vertices++;
+    }
+    if (m_num_vertices != n_vertices) {
+        m_vertex_remap.resize(n_vertices);
+        size_t next = 0;
+        for (size_t i = 0; i < n_vertices; i++) {
+            m_vertex_remap[i] = next;
+            if (!mesh.m_vertex_connectivity[i].m_is_removed) next++;
+        }
+    }
+    for (size_t i = 0; i < mesh.tet_capacity(); i++) {
+        if (!mesh.m_tet_connectivity[i].m_is_removed) m_num_tets++;
+    }
+}
+
+template <typename Func>
+void MshStreamWriter::for_each_chunk(bool vertices, Func&& func) const
+{
+    const size_t capacity = vertices ? m_mesh.vert_capacity() : m_mesh.tet_capacity();
+    std::vector<size_t> ids;
+    ids.reserve(std::min(capacity, chunk_size));
+    for (size_t begin = 0; begin < capacity; begin += chunk_size) {
+        const size_t end = std::min(capacity, begin + chunk_size);
+        ids.clear();
+        for (size_t i = begin; i < end; i++) {
+            const bool removed = vertices ? m_mesh.m_vertex_connectivity[i].m_is_removed
+                                          : m_mesh.m_tet_connectivity[i].m_is_removed;
+            if (!removed) ids.push_back(i);
+        }
+        if (!ids.empty()) func(ids.data(), ids.size());
+    }
+}
+
+void MshStreamWriter::write(const std::string& filename) const
+{
+    if (!m_positions) {
+        throw std::runtime_error("The vertex positions of " + filename + " are not set.");
+    }
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open " + filename + " for writing.");
+    }
+
+    out << "$MeshFormat\n4.1 1 8\n";
+    write_binary(out, int(1));
+    out << "\n$EndMeshFormat\n";
+
+    // one block of tet vertices, tagged 1 to n, entity 1 of dimension 3
+    const size_t n = m_num_vertices, m = m_num_tets;
+    out << "$Nodes\n";
+    write_binary(out, size_t(n > 0));
+    write_binary(out, n);
+    write_binary(out, size_t(n > 0));
+    write_binary(out, n);
+    if (n > 0) {
+        write_binary(out, int(3));
+        write_binary(out, int(1));
+        write_binary(out, int(0));
+        write_binary(out, n);
+        std::vector<size_t> tags(std::min(n, chunk_size));
+        for (size_t begin = 0; begin < n; begin += chunk_size) {
+            const size_t end = std::min(n, begin + chunk_size);
+            for (size_t i = begin; i < end; i++) tags[i - begin] = i + 1;
+            write_binary(out, tags, end - begin);
+        }
+        std::vector<double> coordinates;
+        for_each_chunk(true, [&](const size_t* ids, size_t k) {
+            coordinates.resize(3 * k);
+            parallel_fill(m_positions, ids, k, 3, coordinates.data());
+            write_binary(out, coordinates, 3 * k);
+        });
+    }
+    out << "\n$EndNodes\n";
+
+    // one block of 4-node tets (type 4), on the entity of the vertices
+    out << "$Elements\n";
+    write_binary(out, size_t(m > 0));
+    write_binary(out, m);
+    write_binary(out, size_t(m > 0));
+    write_binary(out, m);
+    if (m > 0) {
+        write_binary(out, int(3));
+        write_binary(out, int(1));
+        write_binary(out, int(4));
+        write_binary(out, m);
+        std::vector<size_t> elements;
+        size_t written = 0;
+        for_each_chunk(false, [&](const size_t* ids, size_t k) {
+            elements.resize(5 * k);
+            tbb::parallel_for(size_t(0), k, [&](size_t i) {
+                const auto& tet = m_mesh.m_tet_connectivity[ids[i]];
+                size_t* element = elements.data() + 5 * i;
+                element[0] = written + i + 1;
+                for (int j = 0; j < 4; j++) {
+                    const size_t v = tet[j];
+                    element[j + 1] = (m_vertex_remap.empty() ? v : m_vertex_remap[v]) + 1;
+                }
+            });
+            write_binary(out, elements, 5 * k);
+            written += k;
+        });
+    }
+    out << "\n$EndElements\n";
+
+    for (const auto& attribute : m_vertex_attributes) write_data(out, "NodeData", attribute, true);
+    for (const auto& attribute : m_tet_attributes) write_data(out, "ElementData", attribute, false);
+
+    if (!out) {
+        throw std::runtime_error("Failed to write " + filename + ".");
+    }
+}
+
+void MshStreamWriter::write_data(
+    std::ostream& out,
+    const std::string& section,
+    const Attribute& attribute,
+    bool vertices) const
+{
+    const size_t size = vertices ? m_num_vertices : m_num_tets;
+    const int num_fields = attribute.num_fields;
+    msh_data::write_header(out, section, {attribute.name}, {0.}, {0, num_fields, int(size), 0, 3});
+
+    std::vector<double> values;
+    std::vector<char> buffer;
+    size_t written = 0;
+    for_each_chunk(vertices, [&](const size_t* ids, size_t k) {
+        values.resize(num_fields * k);
+        parallel_fill(attribute.fill, ids, k, num_fields, values.data());
+        msh_data::write_binary_entries(out, written + 1, values.data(), k, num_fields, buffer);
+        written += k;
+    });
+    out << "\n$End" << section << "\n";
+}
+
+} // namespace wmtk
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace wmtk {
+class TetMesh;
+
+/**
+ * @brief Writes the live vertices and tets of a TetMesh as a binary MSH 4.1 file, in the layout
+ * of MshData::save, without consolidating the mesh or building an MshData.
+ *
+ * Removed elements are skipped and the vertex ids are remapped on the fly, the output is the same
+ * as the one of the consolidated mesh. Blocks are filled in parallel one chunk at a time and
+ * written as they are done, so the memory used is a chunk plus one id per vertex when the mesh
+ * has removed vertices.
+ *
+ * The callbacks take the ids of the mesh (removed elements included, as the attributes are
+ * stored) and are called from several threads. The mesh must not change until write() returns.
+ */
+class MshStreamWriter
+{
+public:
+    explicit MshStreamWriter(const TetMesh& mesh);
+    MshStreamWriter(const MshStreamWriter&) = delete;
+    MshStreamWriter& operator=(const MshStreamWriter&) = delete;
+
+    /// number of vertices and tets that are written
+    size_t num_vertices() const { return m_num_vertices; }
+    size_t num_tets() const { return m_num_tets; }
+
+    /// get_position_cb(vid) returns something indexable with [0], [1], [2]
+    template <typename Fn>
+    void set_positions(Fn get_position_cb)
+    {
+        m_positions = make_fill<3>(get_position_cb);
+    }
+
+    template <int NUM_FIELDS, typename Fn>
+    void add_vertex_attribute(const std::string& name, Fn get_attribute_cb)
+    {
+        static_assert(
+            NUM_FIELDS == 1 || NUM_FIELDS == 3 || NUM_FIELDS == 9,
+            "Only scalar, vector and tensor fields are supported as attribute!");
+        m_vertex_attributes.push_back({name, NUM_FIELDS, make_fill<NUM_FIELDS>(get_attribute_cb)});
+    }
+
+    template <int NUM_FIELDS, typename Fn>
+    void add_tet_attribute(const std::string& name, Fn get_attribute_cb)
+    {
+        static_assert(
+            NUM_FIELDS == 1 || NUM_FIELDS == 3 || NUM_FIELDS == 9,
+            "Only scalar, vector and tensor fields are supported as attribute!");
+        m_tet_attributes.push_back({name, NUM_FIELDS, make_fill<NUM_FIELDS>(get_attribute_cb)});
+    }
+
+    /**
+     * @throws std::runtime_error if the positions are not set or the file cannot be written
+     */
+    void write(const std::string& filename) const;
+
+private:
+    /// writes the values of the elements ids[0], ..., ids[n - 1] to out, NUM_FIELDS each
+    using Fill = std::function<void(const size_t* ids, size_t n, double* out)>;
+    struct Attribute
+    {
+        std::string name;
+        int num_fields;
+        Fill fill;
+    };
+
+    template <int NUM_FIELDS, typename Fn>
+    static Fill make_fill(Fn get_cb)
+    {
+        return [get_cb](const size_t* ids, size_t n, double* out) {
+            for (size_t i = 0; i < n; i++, out += NUM_FIELDS) {
+                const auto& value = get_cb(ids[i]);
+                if constexpr (NUM_FIELDS == 1) {
+                    out[0] = value;
+                } else {
+                    for (int j = 0; j < NUM_FIELDS; j++) out[j] = value[j];
+                }
+            }
+        };
+    }
+
+    /// calls func(ids, n) on the live vertices or tets, in order, a chunk at a time
+    template <typename Func>
+    void for_each_chunk(bool vertices, Func&& func) const;
+    void write_data(
+        std::ostream& out,
+        const std::string& section,
+        const Attribute& attribute,
+        bool vertices) const;
+
+    const TetMesh& m_mesh;
+    size_t m_num_vertices = 0;
+    size_t m_num_tets = 0;
+    // output index of each vertex id, empty if no vertex is removed
+    std::vector<size_t> m_vertex_remap;
+    Fill m_positions;
+    std::vector<Attribute> m_vertex_attributes;
+    std::vector<Attribute> m_tet_attributes;
+};
+
+} // namespace wmtk
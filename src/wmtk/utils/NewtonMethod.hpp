@@ -0,0 +1,147 @@
+#pragma once
+
+#include "EnergyBatch.hpp"
+#include "Logger.hpp"
+
+#include <Eigen/Core>
+#include <Eigen/Dense>
+
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace wmtk {
+
+struct SmoothingOptions
+{
+    int max_iterations = 10;
+    int line_search_iterations = 12;
+    /// stop when the accepted step is shorter than this
+    double min_step = 1e-9;
+    /// stop when an iteration lowers the energy by less than this fraction, 0 disables it
+    double min_relative_decrease = 0.;
+};
+
+namespace newton_internal {
+/**
+ * @brief Backtracking line search from pos, whose energy is known. On success the front of the
+ * stack is left at the returned position so the next derivatives need no extra rewrite.
+ * @return the accepted position and its energy, or (pos, energy) if no step decreases it
+ */
+template <int N, int dim, size_t C, typename Energy>
+std::pair<Eigen::Matrix<double, dim, 1>, double> line_search(
+    energy_batch::BatchStack<N, dim, C>& stack,
+    Energy& energy,
+    const Eigen::Matrix<double, dim, 1>& pos,
+    double pos_energy,
+    const Eigen::Matrix<double, dim, 1>& dir,
+    int max_iter)
+{
+    double step = 1.;
+    for (auto iter = 1; iter <= max_iter; iter++) {
+        step *= 0.5;
+        Eigen::Matrix<double, dim, 1> newpos = pos + step * dir;
+        stack.set_front(newpos);
+        const double new_energy = stack.energy(energy);
+        logger().trace("iter {}, E= {}, [{}]", iter, new_energy, newpos.transpose());
+        if (new_energy < pos_energy) return {newpos, new_energy}; // TODO: armijo conditions.
+    }
+    stack.set_front(pos);
+    return {pos, pos_energy};
+}
+} // namespace newton_internal
+
+/**
+ * Newton's method on the position of the vertex in front of every element of the stack, with
+ * a gradient descent step whenever the Hessian is not positive definite.
+ *
+ * Energy, jacobian and hessian are callables with the batch signature of EnergyBatch.hpp
+ * (e.g. AMIPS_energy_batch, or energy_batch::per_element_energy for per-element kernels). They
+ * are template arguments, so nothing goes through std::function. The one-ring is packed once
+ * and the energy of the accepted line search step is reused by the next iteration.
+ *
+ * @tparam N number of coordinates per element, 12 for tets and 6 for triangles
+ * @tparam dim dimension of the moving vertex
+ * @return the new position of the moving vertex
+ */
+template <int N, int dim, typename Energy, typename Jacobian, typename Hessian>
+Eigen::Matrix<double, dim, 1> newton_method(
+    const std::vector<std::array<double, N>>& stack,
+    Energy&& energy,
+    Jacobian&& jacobian,
+    Hessian&& hessian,
+    const SmoothingOptions& options = {})
+{
+    using Vector = Eigen::Matrix<double, dim, 1>;
+    using Matrix = Eigen::Matrix<double, dim, dim>;
+    assert(!stack.empty());
+    energy_batch::BatchStack<N, dim> batch(stack);
+
+    Vector pos = batch.front();
+    double pos_energy = batch.energy(energy);
+    for (auto iter = 0; iter < options.max_iterations; iter++) {
+        const Vector total_jac = batch.jacobian(jacobian);
+        const Matrix total_hess = batch.hessian(hessian);
+        const Vector x = total_hess.ldlt().solve(total_jac);
+        Vector dir = -x;
+        if (!total_jac.isApprox(total_hess * x)) { // a hacky PSD trick. TODO: change this.
+            logger().trace("gradient descent instead.");
+            dir = -total_jac;
+        }
+        logger().trace("energy {} dir {}", pos_energy, dir.transpose());
+        const auto [newpos, new_energy] = newton_internal::line_search(
+            batch,
+            energy,
+            pos,
+            pos_energy,
+            dir,
+            options.line_search_iterations);
+        if ((newpos - pos).norm() < options.min_step) break; // barely moves
+        const bool small_decrease =
+            pos_energy - new_energy < options.min_relative_decrease * std::abs(pos_energy);
+        pos = newpos;
+        pos_energy = new_energy;
+        if (small_decrease) break;
+    }
+    return pos;
+}
+
+/**
+ * Gradient descent with the same conventions as newton_method. The direction is normalized
+ * before the line search.
+ */
+template <int N, int dim, typename Energy, typename Jacobian>
+Eigen::Matrix<double, dim, 1> gradient_descent(
+    const std::vector<std::array<double, N>>& stack,
+    Energy&& energy,
+    Jacobian&& jacobian,
+    const SmoothingOptions& options = {})
+{
+    using Vector = Eigen::Matrix<double, dim, 1>;
+    assert(!stack.empty());
+    energy_batch::BatchStack<N, dim> batch(stack);
+
+    Vector pos = batch.front();
+    double pos_energy = batch.energy(energy);
+    for (auto iter = 0; iter < options.max_iterations; iter++) {
+        Vector dir = -batch.jacobian(jacobian);
+        dir.normalize(); // HACK: TODO: should use flip_avoid_line_search.
+        const auto [newpos, new_energy] = newton_internal::line_search(
+            batch,
+            energy,
+            pos,
+            pos_energy,
+            dir,
+            options.line_search_iterations);
+        if ((newpos - pos).norm() < options.min_step) break; // barely moves
+        const bool small_decrease =
+            pos_energy - new_energy < options.min_relative_decrease * std::abs(pos_energy);
+        pos = newpos;
+        pos_energy = new_energy;
+        if (small_decrease) break;
+    }
+    return pos;
+}
+
+} // namespace wmtk
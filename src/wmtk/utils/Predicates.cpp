@@ -0,0 +1,91 @@
+#include "Predicates.hpp"
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <igl/predicates/predicates.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <cmath>
+#include <limits>
+
+namespace wmtk::predicates {
+
+namespace {
+// constants of Shewchuk's predicates.c, epsilon is half an ulp of 1
+constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2;
+constexpr double o3derrboundA = (7.0 + 56.0 * epsilon) * epsilon;
+constexpr int UNCERTAIN = 2;
+
+int to_int(igl::predicates::Orientation res)
+{
+    if (res == igl::predicates::Orientation::POSITIVE) return 1;
+    if (res == igl::predicates::Orientation::NEGATIVE) return -1;
+    return 0;
+}
+} // namespace
+
+void init()
+{
+    // function-local statics are initialized exactly once, even with concurrent callers
+    static const bool initialized = [] {
+        igl::predicates::exactinit();
+        return true;
+    }();
+    (void)initialized;
+}
+
+int orient3d(
+    const Eigen::Vector3d& a,
+    const Eigen::Vector3d& b,
+    const Eigen::Vector3d& c,
+    const Eigen::Vector3d& d)
+{
+    init();
+    return to_int(igl::predicates::orient3d(a, b, c, d));
+}
+
+int orient2d(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c)
+{
+    init();
+    return to_int(igl::predicates::orient2d(a, b, c));
+}
+
+void orient3d_batch(size_t n, const std::array<Eigen::Vector3d, 4>* tets, int* result)
+{
+    // same expression and error bound as the first stage of orient3d in predicates.c
+    bool any_uncertain = false;
+    for (size_t i = 0; i < n; i++) {
+        const auto& t = tets[i];
+        const Eigen::Vector3d ad = t[0] - t[3];
+        const Eigen::Vector3d bd = t[1] - t[3];
+        const Eigen::Vector3d cd = t[2] - t[3];
+
+        const double bdxcdy = bd[0] * cd[1];
+        const double cdxbdy = cd[0] * bd[1];
+        const double cdxady = cd[0] * ad[1];
+        const double adxcdy = ad[0] * cd[1];
+        const double adxbdy = ad[0] * bd[1];
+        const double bdxady = bd[0] * ad[1];
+
+        const double det = ad[2] * (bdxcdy - cdxbdy) + bd[2] * (cdxady - adxcdy) +
+                           cd[2] * (adxbdy - bdxady);
+        const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(ad[2]) +
+                                 (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bd[2]) +
+                                 (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cd[2]);
+        const double errbound = o3derrboundA * permanent;
+
+        // NaN compares false and ends up uncertain as well
+        result[i] = det > errbound ? 1 : (-det > errbound ? -1 : UNCERTAIN);
+        any_uncertain |= result[i] == UNCERTAIN;
+    }
+    if (!any_uncertain) return;
+
+    for (size_t i = 0; i < n; i++) {
+        if (result[i] != UNCERTAIN) continue;
+        const auto& t = tets[i];
+        result[i] = orient3d(t[0], t[1], t[2], t[3]);
+    }
+}
+
+} // namespace wmtk::predicates
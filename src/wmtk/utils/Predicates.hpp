@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <array>
+#include <cstddef>
+
+namespace wmtk::predicates {
+
+/**
+ * @brief Computes the constants of Shewchuk's robust predicates (igl::predicates::exactinit).
+ * The work is done by the first call only. Later calls are free, and it is safe to call from
+ * several threads. Call it before using igl::predicates directly; the functions below already do.
+ */
+void init();
+
+/**
+ * @brief Exact orientation with the convention of igl::predicates::orient3d.
+ * @return 1 if d lies below the plane through a, b, c (a, b, c counterclockwise seen from
+ * above), -1 if above, 0 if coplanar
+ */
+int orient3d(
+    const Eigen::Vector3d& a,
+    const Eigen::Vector3d& b,
+    const Eigen::Vector3d& c,
+    const Eigen::Vector3d& d);
+
+/**
+ * @brief Exact orientation with the convention of igl::predicates::orient2d.
+ * @return 1 if a, b, c are counterclockwise, -1 if clockwise, 0 if collinear
+ */
+int orient2d(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c);
+
+/**
+ * @brief orient3d of n tets at once, e.g. all tets around a vertex.
+ *
+ * One pass evaluates the determinants in floating point and certifies their sign with
+ * Shewchuk's static error bound. Only the tets that pass too close to the filter go to the
+ * adaptive exact predicate.
+ *
+ * @param tets the four corners of tet i, in orient3d argument order
+ * @param result orient3d(tets[i][0], ..., tets[i][3]) for every i
+ */
+void orient3d_batch(size_t n, const std::array<Eigen::Vector3d, 4>* tets, int* result);
+
+} // namespace wmtk::predicates
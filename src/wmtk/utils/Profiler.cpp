@@ -0,0 +1,262 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace wmtk {
+
+namespace {
+struct Event
+{
+    const char* name;
+    int64_t begin;
+    int64_t end;
+};
+
+struct Stat
+{
+    size_t calls = 0;
+    int64_t total = 0;
+    int64_t self = 0;
+};
+
+std::string json_escape(const char* s)
+{
+    std::string out;
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') out += '\\';
+        out += *s;
+    }
+    return out;
+}
+
+void write_to(const std::string& path, const std::string& text)
+{
+    if (path.empty()) {
+        std::fputs(text.c_str(), stderr);
+        return;
+    }
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write the profile " + path);
+    out << text;
+}
+} // namespace
+
+struct Profiler::ThreadBuffer
+{
+    size_t thread_id = 0;
+    std::vector<Event> events; // ring buffer, events[i % size] is the i-th event, empty if unused
+    size_t num_events = 0;
+    std::unordered_map<const char*, Stat> stats;
+    std::vector<int64_t> children; // time spent in the children of each open zone
+};
+
+std::atomic<bool> Profiler::s_enabled = false;
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+// reads WMTK_PROFILE when the library is loaded
+static const bool s_profiler_initialized = (Profiler::instance(), true);
+
+Profiler::Profiler()
+{
+    m_epoch = now();
+    const char* env = std::getenv("WMTK_PROFILE");
+    if (env == nullptr || *env == '\0') return;
+    const std::string value(env);
+    const auto colon = value.find(':');
+    const std::string kind = value.substr(0, colon);
+    const std::string path = colon == std::string::npos ? "" : value.substr(colon + 1);
+    size_t events = size_t(1) << 20;
+    if (const char* n = std::getenv("WMTK_PROFILE_EVENTS")) events = std::strtoull(n, nullptr, 10);
+    if (kind == "trace")
+        enable(Output::kTrace, path.empty() ? "wmtk_trace.json" : path, events);
+    else if (kind == "flat")
+        enable(Output::kFlat, path, events);
+    else
+        std::fprintf(stderr, "Unknown WMTK_PROFILE %s, use trace:<file> or flat[:<file>]\n", env);
+}
+
+Profiler::~Profiler()
+{
+    if (m_output == Output::kNone) return;
+    s_enabled = false;
+    try {
+        if (m_output == Output::kTrace)
+            write_trace(m_path);
+        else
+            write_flat_profile(m_path);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+    }
+}
+
+void Profiler::enable(Output output, const std::string& path, size_t events_per_thread)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_output = output;
+    m_path = path;
+    m_trace_events = output == Output::kTrace ? std::max(events_per_thread, size_t(1)) : 0;
+    s_enabled = true;
+}
+
+void Profiler::disable()
+{
+    s_enabled = false;
+}
+
+Profiler::Output Profiler::output() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_output;
+}
+
+std::string Profiler::path() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_path;
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& b : m_buffers) {
+        b->num_events = 0;
+        b->stats.clear();
+    }
+}
+
+const char* Profiler::intern(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& n : m_names) {
+        if (*n == name) return n->c_str();
+    }
+    m_names.push_back(std::make_unique<std::string>(name));
+    return m_names.back()->c_str();
+}
+
+Profiler::ThreadBuffer& Profiler::thread_buffer()
+{
+    // the buffers belong to the profiler, they outlive their threads for the output at exit
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = m_buffers.back().get();
+        buffer->thread_id = m_buffers.size() - 1;
+    }
+    return *buffer;
+}
+
+void Profiler::begin_zone()
+{
+    thread_buffer().children.push_back(0);
+}
+
+void Profiler::end_zone(const char* name, int64_t begin, int64_t end)
+{
+    auto& buffer = thread_buffer();
+    const int64_t duration = end - begin;
+    const int64_t children = buffer.children.back();
+    buffer.children.pop_back();
+    if (!buffer.children.empty()) buffer.children.back() += duration;
+
+    auto& stat = buffer.stats[name];
+    stat.calls++;
+    stat.total += duration;
+    stat.self += duration - children;
+
+    if (buffer.events.empty()) {
+        const size_t capacity = m_trace_events.load(std::memory_order_relaxed);
+        if (capacity == 0) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffer.events.resize(capacity);
+    }
+    buffer.events[buffer.num_events % buffer.events.size()] = {name, begin, end};
+    buffer.num_events++;
+}
+
+void Profiler::write_trace(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ostringstream out;
+    out.precision(15);
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    size_t dropped = 0;
+    for (const auto& b : m_buffers) {
+        const size_t capacity = b->events.size();
+        const size_t begin = b->num_events > capacity ? b->num_events - capacity : 0;
+        dropped += begin;
+        for (size_t i = begin; i < b->num_events; i++) {
+            const auto& e = b->events[i % capacity];
+            // complete events, times in microseconds
+            out << (first ? "" : ",\n") << "{\"name\": \"" << json_escape(e.name)
+                << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << b->thread_id
+                << ", \"ts\": " << (e.begin - m_epoch) / 1e3
+                << ", \"dur\": " << (e.end - e.begin) / 1e3 << "}";
+            first = false;
+        }
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": " << dropped
+        << "}}\n";
+    write_to(path, out.str());
+}
+
+void Profiler::write_flat_profile(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // the same name can have several pointers, one per translation unit
+    std::map<std::string, Stat> totals;
+    for (const auto& b : m_buffers) {
+        for (const auto& [name, stat] : b->stats) {
+            auto& t = totals[name];
+            t.calls += stat.calls;
+            t.total += stat.total;
+            t.self += stat.self;
+        }
+    }
+    std::vector<std::pair<std::string, Stat>> sorted(totals.begin(), totals.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.total > b.second.total;
+    });
+
+    std::ostringstream out;
+    char line[256];
+    std::snprintf(
+        line,
+        sizeof(line),
+        "%-40s %12s %12s %12s %12s\n",
+        "zone",
+        "calls",
+        "total ms",
+        "self ms",
+        "mean us");
+    out << line;
+    for (const auto& [name, s] : sorted) {
+        std::snprintf(
+            line,
+            sizeof(line),
+            "%-40s %12zu %12.3f %12.3f %12.3f\n",
+            name.c_str(),
+            s.calls,
+            s.total / 1e6,
+            s.self / 1e6,
+            s.total / 1e3 / s.calls);
+        out << line;
+    }
+    write_to(path, out.str());
+}
+
+} // namespace wmtk
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <Tracy.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief Lightweight profiler of the zones of the library, for the runs where no Tracy server is
+ * attached.
+ *
+ * Each thread records its zones in per-zone totals and, for the trace output only, in its own ring
+ * buffer, which keeps the last events. The totals are exact however many events are dropped.
+ * Profiling is off by default, a zone then costs a relaxed atomic load. It is selected at runtime
+ * by the WMTK_PROFILE environment variable, read when the library is loaded, or by enable():
+ *
+ *     WMTK_PROFILE=trace:<file>   Chrome trace_event JSON (chrome://tracing, Perfetto) at exit
+ *     WMTK_PROFILE=flat:<file>    flat profile, calls and total/self time per zone, at exit
+ *     WMTK_PROFILE=flat           flat profile on stderr at exit
+ *
+ * WMTK_PROFILE_EVENTS sets the number of events kept per thread for the trace (default 2^20),
+ * the other outputs keep none. The zones are also Tracy zones, so they reach the Tracy server
+ * when the library is built with TRACY_ENABLE.
+ */
+class Profiler
+{
+public:
+    enum class Output { kNone, kTrace, kFlat };
+
+    static Profiler& instance();
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Starts recording, output and path say what is written at exit (kNone for nothing,
+     * an empty path for stderr). The buffers are kept, call clear() to start over. Only kTrace
+     * keeps events, a thread allocates its ring of events_per_thread events with the first zone
+     * it records while tracing, and keeps its size afterwards.
+     */
+    void enable(
+        Output output = Output::kNone,
+        const std::string& path = "",
+        size_t events_per_thread = size_t(1) << 20);
+    void disable();
+    /// The arguments of the last enable(), events_per_thread is 0 unless the output is kTrace.
+    Output output() const;
+    std::string path() const;
+    size_t events_per_thread() const { return m_trace_events; }
+    /**
+     * @brief Drops the recorded events and totals. The threads update their buffers without
+     * locking, so it must only be called while no zone is running, e.g. between passes.
+     */
+    void clear();
+
+    /**
+     * @brief Writes the recorded events as a Chrome trace, or the totals of each zone sorted by
+     * total time. Zones still open on other threads are not included.
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void write_trace(const std::string& path) const;
+    void write_flat_profile(const std::string& path) const;
+
+    /// A pointer to a copy of name that lives as long as the program, for runtime zone names.
+    const char* intern(const std::string& name);
+
+    // used by ProfileZone
+    static int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+    void begin_zone();
+    void end_zone(const char* name, int64_t begin, int64_t end);
+
+    ~Profiler();
+
+private:
+    struct ThreadBuffer;
+    Profiler();
+    ThreadBuffer& thread_buffer();
+
+    static std::atomic<bool> s_enabled;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    std::vector<std::unique_ptr<std::string>> m_names;
+    std::atomic<size_t> m_trace_events = 0; // size of the rings, 0 unless the output is kTrace
+    int64_t m_epoch = 0;
+    Output m_output = Output::kNone;
+    std::string m_path;
+};
+
+/// Records its lifetime as a zone of the Profiler, name must outlive the program.
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name)
+        : m_name(name)
+    {
+        if (Profiler::enabled()) {
+            Profiler::instance().begin_zone();
+            m_begin = Profiler::now();
+        }
+    }
+    ~ProfileZone()
+    {
+        if (m_begin >= 0) Profiler::instance().end_zone(m_name, m_begin, Profiler::now());
+    }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_begin = -1;
+};
+
+} // namespace wmtk
+
+#define WMTK_PROFILE_CONCAT_IMPL(a, b) a##b
+#define WMTK_PROFILE_CONCAT(a, b) WMTK_PROFILE_CONCAT_IMPL(a, b)
+// one variable per line, so that nested zones do not shadow each other
+#define WMTK_PROFILE_ZONE_VARIABLE WMTK_PROFILE_CONCAT(wmtk_profile_zone_, __LINE__)
+
+/// A zone named by a string literal, one per scope like ZoneScopedN.
+#define WMTK_PROFILE_SCOPE(name) \
+    ZoneScopedN(name);           \
+    ::wmtk::ProfileZone WMTK_PROFILE_ZONE_VARIABLE(name)
+
+/// A zone with a name known at runtime, see Profiler::intern.
+#define WMTK_PROFILE_SCOPE_DYNAMIC(name)                  \
+    ZoneScoped;                                           \
+    ZoneName(name, std::char_traits<char>::length(name)); \
+    ::wmtk::ProfileZone WMTK_PROFILE_ZONE_VARIABLE(name)
@@ -1,151 +1,439 @@
 #pragma once
 
 #include <gmp.h>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace wmtk {
 
-class Rational
+namespace rational_internal {
+/**
+ * @brief Per-thread pool of initialized mpq_t. A Rational that leaves the double fast path takes
+ * its mpq from here and gives it back on destruction, so the limb storage is reused instead of
+ * going through mpq_init/mpq_clear for every temporary. It also holds the scratch mpq used to
+ * lift double operands in mixed operations.
+ */
+class MpqPool
 {
 public:
-    mpq_t value;
-    void canonicalize() { mpq_canonicalize(value); }
-    int get_sign() { return mpq_sgn(value); }
+    static constexpr size_t max_pooled = 256;
 
-    Rational()
+    MpqPool()
+    {
+        for (auto& s : m_scratch) mpq_init(s);
+    }
+    ~MpqPool()
     {
-        mpq_init(value);
-        mpq_set_d(value, 0);
+        for (auto& q : m_free) mpq_clear(&q);
+        for (auto& s : m_scratch) mpq_clear(s);
+        destroyed() = true;
     }
 
-    Rational(double d)
+    static MpqPool& local()
+    {
+        static thread_local MpqPool pool;
+        return pool;
+    }
+
+    static void acquire(mpq_ptr q)
+    {
+        auto& free = local().m_free;
+        if (free.empty()) {
+            mpq_init(q);
+            return;
+        }
+        *q = free.back();
+        free.pop_back();
+    }
+
+    static void release(mpq_ptr q)
+    {
+        // the pool of this thread may already be gone during thread/static teardown
+        if (destroyed() || local().m_free.size() >= max_pooled) {
+            mpq_clear(q);
+            return;
+        }
+        local().m_free.push_back(*q);
+    }
+
+    static mpq_ptr scratch(int i) { return local().m_scratch[i]; }
+
+private:
+    static bool& destroyed()
     {
-        mpq_init(value);
-        mpq_set_d(value, d);
-        // canonicalize();
+        static thread_local bool flag = false;
+        return flag;
     }
 
+    std::vector<__mpq_struct> m_free;
+    mpq_t m_scratch[2];
+};
+} // namespace rational_internal
+
+/**
+ * @brief Exact rational number.
+ *
+ * Values that are exactly representable as a double are stored inline and operated on in double
+ * precision as long as the result is exact (checked with TwoSum/fma error terms), only falling
+ * back to GMP when it is not. Results of GMP operations that fit a double are demoted back to the
+ * fast path. The GMP storage is taken from a per-thread pool and moved, not copied, out of
+ * temporaries.
+ */
+class Rational
+{
+public:
+    void canonicalize()
+    {
+        if (m_is_mpq) mpq_canonicalize(m_q);
+    }
+    int get_sign() const
+    {
+        if (!m_is_mpq) return (m_d > 0) - (m_d < 0);
+        return mpq_sgn(m_q);
+    }
+
+    Rational() = default;
+
+    Rational(double d)
+        : m_d(d)
+    {}
+
     Rational(const mpq_t& v_)
     {
-        mpq_init(value);
-        mpq_set(value, v_);
-        // canonicalize();
+        to_mpq();
+        mpq_set(m_q, v_);
+        try_demote();
     }
 
     Rational(const Rational& other)
     {
-        mpq_init(value);
-        mpq_set(value, other.value);
+        if (!other.m_is_mpq) {
+            m_d = other.m_d;
+            return;
+        }
+        rational_internal::MpqPool::acquire(m_q);
+        m_is_mpq = true;
+        mpq_set(m_q, other.m_q);
+    }
+
+    Rational(Rational&& other) noexcept { steal(other); }
+
+    ~Rational() { drop_mpq(); }
+
+    Rational& operator=(const Rational& x)
+    {
+        if (this == &x) return *this;
+        if (!x.m_is_mpq) {
+            drop_mpq();
+            m_d = x.m_d;
+        } else {
+            to_mpq();
+            mpq_set(m_q, x.m_q);
+        }
+        return *this;
+    }
+
+    Rational& operator=(Rational&& x) noexcept
+    {
+        if (this == &x) return *this;
+        drop_mpq();
+        steal(x);
+        return *this;
+    }
+
+    Rational& operator=(const double x)
+    {
+        drop_mpq();
+        m_d = x;
+        return *this;
+    }
+
+    Rational& operator+=(const Rational& y)
+    {
+        if (!m_is_mpq && !y.m_is_mpq) {
+            const double s = m_d + y.m_d;
+            if (is_exact_sum(m_d, y.m_d, s)) {
+                m_d = s;
+                return *this;
+            }
+        }
+        const auto y_q = y.as_mpq(0);
+        to_mpq();
+        mpq_add(m_q, m_q, y_q);
+        try_demote();
+        return *this;
+    }
+
+    Rational& operator-=(const Rational& y)
+    {
+        if (!m_is_mpq && !y.m_is_mpq) {
+            const double s = m_d - y.m_d;
+            if (is_exact_sum(m_d, -y.m_d, s)) {
+                m_d = s;
+                return *this;
+            }
+        }
+        const auto y_q = y.as_mpq(0);
+        to_mpq();
+        mpq_sub(m_q, m_q, y_q);
+        try_demote();
+        return *this;
     }
 
-    ~Rational() { mpq_clear(value); }
+    Rational& operator*=(const Rational& y)
+    {
+        if (!m_is_mpq && !y.m_is_mpq) {
+            const double p = m_d * y.m_d;
+            if (is_exact_product(m_d, y.m_d, p)) {
+                m_d = p;
+                return *this;
+            }
+        }
+        const auto y_q = y.as_mpq(0);
+        to_mpq();
+        mpq_mul(m_q, m_q, y_q);
+        try_demote();
+        return *this;
+    }
 
+    Rational& operator/=(const Rational& y)
+    {
+        if (!m_is_mpq && !y.m_is_mpq) {
+            const double q = m_d / y.m_d;
+            if (is_exact_quotient(m_d, y.m_d, q)) {
+                m_d = q;
+                return *this;
+            }
+        }
+        const auto y_q = y.as_mpq(0);
+        to_mpq();
+        mpq_div(m_q, m_q, y_q);
+        try_demote();
+        return *this;
+    }
+
+    // binary operators reuse the storage of rvalue operands
     friend Rational operator+(const Rational& x, const Rational& y)
     {
-        Rational r_out;
-        mpq_add(r_out.value, x.value, y.value);
+        Rational r_out = x;
+        r_out += y;
         return r_out;
     }
+    friend Rational operator+(Rational&& x, const Rational& y) { return std::move(x += y); }
+    friend Rational operator+(const Rational& x, Rational&& y) { return std::move(y += x); }
+    friend Rational operator+(Rational&& x, Rational&& y) { return std::move(x += y); }
 
     friend Rational operator-(const Rational& x, const Rational& y)
     {
-        Rational r_out;
-        mpq_sub(r_out.value, x.value, y.value);
+        Rational r_out = x;
+        r_out -= y;
         return r_out;
     }
-
+    friend Rational operator-(Rational&& x, const Rational& y) { return std::move(x -= y); }
 
     friend Rational operator-(const Rational& x)
     {
-        Rational r_out;
-        mpq_neg(r_out.value, x.value);
+        Rational r_out = x;
+        r_out.negate();
         return r_out;
     }
+    friend Rational operator-(Rational&& x)
+    {
+        x.negate();
+        return std::move(x);
+    }
 
-    friend Rational pow(const Rational& x, int p)
+    friend Rational operator*(const Rational& x, const Rational& y)
     {
         Rational r_out = x;
-        for (int i = 1; i < std::abs(p); i++) {
-            r_out = r_out * x;
-        }
-        if (p < 0) return 1 / r_out;
+        r_out *= y;
         return r_out;
     }
+    friend Rational operator*(Rational&& x, const Rational& y) { return std::move(x *= y); }
+    friend Rational operator*(const Rational& x, Rational&& y) { return std::move(y *= x); }
+    friend Rational operator*(Rational&& x, Rational&& y) { return std::move(x *= y); }
 
-    friend Rational operator*(const Rational& x, const Rational& y)
+    friend Rational operator/(const Rational& x, const Rational& y)
     {
-        Rational r_out;
-        mpq_mul(r_out.value, x.value, y.value);
+        Rational r_out = x;
+        r_out /= y;
         return r_out;
     }
+    friend Rational operator/(Rational&& x, const Rational& y) { return std::move(x /= y); }
 
-    friend Rational operator/(const Rational& x, const Rational& y)
+    friend Rational pow(const Rational& x, int p)
     {
-        Rational r_out;
-        mpq_div(r_out.value, x.value, y.value);
+        Rational r_out = 1;
+        Rational base = x;
+        for (unsigned int e = std::abs(p); e > 0; e >>= 1) {
+            if (e & 1) r_out *= base;
+            if (e > 1) base *= base;
+        }
+        if (p < 0) return 1 / std::move(r_out);
         return r_out;
     }
 
-    Rational& operator=(const Rational& x)
+    //> < ==
+    friend bool operator<(const Rational& r, const Rational& r1) { return compare(r, r1) < 0; }
+
+    friend bool operator>(const Rational& r, const Rational& r1) { return compare(r, r1) > 0; }
+
+    friend bool operator<=(const Rational& r, const Rational& r1) { return compare(r, r1) <= 0; }
+
+    friend bool operator>=(const Rational& r, const Rational& r1) { return compare(r, r1) >= 0; }
+
+    friend bool operator==(const Rational& r, const Rational& r1) { return compare(r, r1) == 0; }
+
+    friend bool operator!=(const Rational& r, const Rational& r1) { return compare(r, r1) != 0; }
+
+    // to double
+    double to_double() const { return m_is_mpq ? mpq_get_d(m_q) : m_d; }
+
+    /**
+     * @brief Exact text form, "numerator/denominator" (or "numerator" for integers) in base 62,
+     * read back by from_string.
+     */
+    std::string to_string() const
     {
-        if (this == &x) return *this;
-        mpq_set(value, x.value);
-        return *this;
+        char* str = mpq_get_str(nullptr, 62, as_mpq(0));
+        std::string res(str);
+        void (*free_func)(void*, size_t);
+        mp_get_memory_functions(nullptr, nullptr, &free_func);
+        free_func(str, res.size() + 1);
+        return res;
     }
 
-    Rational& operator=(const double x)
+    /**
+     * @throws std::invalid_argument if str is not the output of to_string
+     */
+    static Rational from_string(const std::string& str)
     {
-        mpq_set_d(value, x);
-        //            canonicalize();
-        return *this;
+        Rational r;
+        r.to_mpq();
+        if (mpq_set_str(r.m_q, str.c_str(), 62) != 0 || mpz_sgn(mpq_denref(r.m_q)) == 0) {
+            throw std::invalid_argument("Invalid rational " + str);
+        }
+        mpq_canonicalize(r.m_q);
+        r.try_demote();
+        return r;
     }
 
-    //> < ==
-    friend bool operator<(const Rational& r, const Rational& r1)
+    friend Rational abs(const Rational& r0)
     {
-        return mpq_cmp(r.value, r1.value) < 0;
+        Rational r = r0;
+        if (r.get_sign() < 0) r.negate();
+        return r;
     }
 
-    friend bool operator>(const Rational& r, const Rational& r1)
+    //<<
+    friend std::ostream& operator<<(std::ostream& os, const Rational& r)
     {
-        return mpq_cmp(r.value, r1.value) > 0;
+        os << r.to_double();
+        return os;
     }
 
-    friend bool operator<=(const Rational& r, const Rational& r1)
+private:
+    // below this magnitude the fma/TwoSum error terms may underflow, so exactness is not checked
+    static constexpr double min_checked = 1e-280;
+
+    static bool is_exact_sum(double a, double b, double s)
     {
-        return mpq_cmp(r.value, r1.value) <= 0;
+        if (!std::isfinite(s)) return false;
+        const double bb = s - a;
+        return (a - (s - bb)) + (b - bb) == 0;
     }
 
-    friend bool operator>=(const Rational& r, const Rational& r1)
+    static bool is_exact_product(double a, double b, double p)
     {
-        return mpq_cmp(r.value, r1.value) >= 0;
+        if (a == 0 || b == 0) return true;
+        if (!std::isfinite(p) || std::abs(p) < min_checked) return false;
+        return std::fma(a, b, -p) == 0;
     }
 
-    friend bool operator==(const Rational& r, const Rational& r1)
+    static bool is_exact_quotient(double a, double b, double q)
     {
-        return mpq_equal(r.value, r1.value);
+        if (b == 0) return false; // let gmp report the division by zero
+        if (a == 0) return true;
+        if (!std::isfinite(q) || std::abs(a) < min_checked || std::abs(q) < min_checked)
+            return false;
+        return std::fma(q, b, -a) == 0;
     }
 
-    friend bool operator!=(const Rational& r, const Rational& r1)
+    static int compare(const Rational& x, const Rational& y)
     {
-        return !mpq_equal(r.value, r1.value);
+        if (!x.m_is_mpq && !y.m_is_mpq) return (x.m_d > y.m_d) - (x.m_d < y.m_d);
+        return mpq_cmp(x.as_mpq(0), y.as_mpq(1));
     }
 
-    // to double
-    double to_double() const { return mpq_get_d(value); }
+    // the value as an mpq, lifting doubles into the thread-local scratch slot
+    mpq_srcptr as_mpq(int slot) const
+    {
+        if (m_is_mpq) return m_q;
+        auto s = rational_internal::MpqPool::scratch(slot);
+        mpq_set_d(s, m_d);
+        return s;
+    }
 
-    friend Rational abs(const Rational& r0)
+    void to_mpq()
     {
-        Rational r;
-        mpq_abs(r.value, r0.value);
-        return r;
+        if (m_is_mpq) return;
+        const double d = m_d; // overwritten by the mpq
+        rational_internal::MpqPool::acquire(m_q);
+        mpq_set_d(m_q, d);
+        m_is_mpq = true;
     }
 
-    //<<
-    friend std::ostream& operator<<(std::ostream& os, const Rational& r)
+    void drop_mpq()
     {
-        os << mpq_get_d(r.value);
-        return os;
+        if (!m_is_mpq) return;
+        rational_internal::MpqPool::release(m_q);
+        m_is_mpq = false;
     }
+
+    // takes the value of other, which is left at 0, this must not hold an mpq
+    void steal(Rational& other)
+    {
+        m_is_mpq = other.m_is_mpq;
+        if (m_is_mpq)
+            *m_q = *other.m_q;
+        else
+            m_d = other.m_d;
+        other.m_is_mpq = false;
+        other.m_d = 0;
+    }
+
+    void negate()
+    {
+        if (m_is_mpq)
+            mpq_neg(m_q, m_q);
+        else
+            m_d = -m_d;
+    }
+
+    // go back to the double path when the value is k / 2^e with at most 53 significant bits
+    void try_demote()
+    {
+        mpz_srcptr num = mpq_numref(m_q);
+        mpz_srcptr den = mpq_denref(m_q);
+        if (mpz_size(num) > 1 || mpz_sizeinbase(num, 2) > 53) return;
+        const size_t e = mpz_sizeinbase(den, 2) - 1;
+        if (e > 1074 || mpz_scan1(den, 0) != e) return;
+        const double d = mpq_get_d(m_q);
+        drop_mpq();
+        m_d = d;
+    }
+
+    union {
+        double m_d = 0; // the value while !m_is_mpq
+        mpq_t m_q; // only initialized while m_is_mpq
+    };
+    bool m_is_mpq = false;
 };
-} // namespace apps
+
+// the double shares the storage of the mpq, only the flag is added
+static_assert(sizeof(Rational) == sizeof(mpq_t) + alignof(mpq_t), "Rational grew");
+} // namespace wmtk
@@ -1,4 +1,15 @@
 #include "Reader.hpp"
+#include "MeshCleanup.hpp"
+#include "MeshReader.hpp"
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
 namespace wmtk {
 void stl_to_eigen(std::string input_surface, Eigen::MatrixXd& VI, Eigen::MatrixXi& FI)
 {
@@ -32,22 +43,14 @@ void eigen_to_wmtk_input(
 
 void resolve_duplicated_faces(const Eigen::MatrixXi& inF, Eigen::MatrixXi& outF)
 {
-    std::map<std::array<int, 3>, int> unique;
-    std::vector<Eigen::Vector3i> newF;
-    newF.reserve(inF.rows());
+    std::vector<std::array<size_t, 3>> F(inF.rows());
     for (auto i = 0; i < inF.rows(); i++) {
-        std::array<int, 3> tri;
-        for (auto j = 0; j < 3; j++) tri[j] = inF(i, j);
-
-        std::sort(tri.begin(), tri.end());
-        auto [it, suc] = unique.emplace(tri, i);
-        if (suc) {
-            newF.emplace_back(inF.row(i));
-        }
+        for (auto j = 0; j < 3; j++) F[i][j] = inF(i, j);
     }
-    outF.resize(newF.size(), 3);
-    for (auto i = 0; i < newF.size(); i++) {
-        outF.row(i) = newF[i];
+    wmtk::remove_duplicate_faces(F);
+    outF.resize(F.size(), 3);
+    for (auto i = 0; i < F.size(); i++) {
+        outF.row(i) << F[i][0], F[i][1], F[i][2];
     }
 }
 
@@ -59,50 +62,55 @@ void stl_to_manifold_wmtk_input(
     std::vector<std::array<size_t, 3>>& tris,
     std::vector<size_t>& modified_nonmanifold_v)
 {
-    Eigen::MatrixXd inV, V;
-    Eigen::MatrixXi inF, F;
-    wmtk::stl_to_eigen(input_path, inV, inF);
-    Eigen::VectorXi _I;
+    // STL and OBJ are read directly, geogram handles the other formats
+    if (!wmtk::read_surface_mesh(input_path, verts, tris)) {
+        Eigen::MatrixXd inV;
+        Eigen::MatrixXi inF;
+        wmtk::stl_to_eigen(input_path, inV, inF);
+        verts.resize(inV.rows());
+        tris.resize(inF.rows());
+        tbb::parallel_for(Eigen::Index(0), inV.rows(), [&](Eigen::Index i) {
+            verts[i] = inV.row(i);
+        });
+        tbb::parallel_for(Eigen::Index(0), inF.rows(), [&](Eigen::Index i) {
+            for (int j = 0; j < 3; j++) tris[i][j] = (size_t)inF(i, j);
+        });
+    }
 
-    igl::remove_unreferenced(inV, inF, V, F, _I);
+    wmtk::remove_unreferenced_vertices(verts, tris);
 
-    if (V.rows() == 0 || F.rows() == 0) {
+    if (verts.size() == 0 || tris.size() == 0) {
         wmtk::logger().info("== finish with Empty Input, stop.");
         exit(0);
     }
 
-    box_minmax = std::pair(V.colwise().minCoeff(), V.colwise().maxCoeff());
+    using MinMax = std::pair<Eigen::Vector3d, Eigen::Vector3d>;
+    box_minmax = tbb::parallel_reduce(
+        tbb::blocked_range<size_t>(0, verts.size()),
+        MinMax(verts[0], verts[0]),
+        [&](const tbb::blocked_range<size_t>& r, MinMax box) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                box.first = box.first.cwiseMin(verts[i]);
+                box.second = box.second.cwiseMax(verts[i]);
+            }
+            return box;
+        },
+        [](const MinMax& a, const MinMax& b) {
+            return MinMax(a.first.cwiseMin(b.first), a.second.cwiseMax(b.second));
+        });
     double diag = (box_minmax.first - box_minmax.second).norm();
 
     // using the same error tolerance as in tetwild
-    Eigen::VectorXi SVI, SVJ, SVK;
-    Eigen::MatrixXd temp_V = V; // for STL file
-    igl::remove_duplicate_vertices(
-        temp_V,
-        std::min(1e-5, remove_duplicate_esp / 10 * diag),
-        V,
-        SVI,
-        SVJ);
-    for (int i = 0; i < F.rows(); i++)
-        for (int j : {0, 1, 2}) F(i, j) = SVJ[F(i, j)];
-    auto F1 = F;
-
-    resolve_duplicated_faces(F1, F);
-
-
-    verts.resize(V.rows());
-    tris.resize(F.rows());
-    wmtk::eigen_to_wmtk_input(verts, tris, V, F);
-
-    wmtk::logger().info("after remove duplicate v#: {} f#: {}", V.rows(), F.rows());
-
+    wmtk::weld_vertices(verts, tris, std::min(1e-5, remove_duplicate_esp / 10 * diag));
+    wmtk::remove_duplicate_faces(tris);
 
-    Eigen::VectorXi dummy;
+    wmtk::logger().info("after remove duplicate v#: {} f#: {}", verts.size(), tris.size());
 
-    if (!igl::is_edge_manifold(F) || !igl::is_vertex_manifold(F, dummy)) {
+    modified_nonmanifold_v.clear();
+    if (!wmtk::split_nonmanifold_vertices(verts, tris, modified_nonmanifold_v)) {
         auto v1 = verts;
         auto tri1 = tris;
         wmtk::separate_to_manifold(v1, tri1, verts, tris, modified_nonmanifold_v);
     }
 }
-} // namespace wmtk
\ No newline at end of file
+} // namespace wmtk
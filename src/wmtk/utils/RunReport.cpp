@@ -0,0 +1,113 @@
+#include "RunReport.hpp"
+
+#include <wmtk/TriMesh.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+extern "C" {
+#include "getRSS.c"
+}
+
+namespace wmtk {
+
+namespace {
+void accumulate(
+    std::vector<std::pair<std::string, double>>& entries,
+    const std::string& key,
+    double value,
+    bool add)
+{
+    for (auto& [k, v] : entries) {
+        if (k == key) {
+            v = add ? v + value : value;
+            return;
+        }
+    }
+    entries.emplace_back(key, value);
+}
+} // namespace
+
+RunReport& RunReport::global()
+{
+    static RunReport report;
+    return report;
+}
+
+void RunReport::add_time(const std::string& phase, double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    accumulate(m_times, phase, seconds, true);
+}
+
+void RunReport::set(const std::string& key, double value)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    accumulate(m_values, key, value, false);
+}
+
+void RunReport::start_total()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_total_start = std::chrono::steady_clock::now();
+}
+
+void RunReport::stop_total()
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_total_start) throw std::runtime_error("stop_total() without start_total()");
+    const std::chrono::duration<double> elapsed = now - *m_total_start;
+    accumulate(m_values, "total_time", elapsed.count(), false);
+    m_total_start.reset();
+}
+
+void RunReport::write(const std::string& path) const
+{
+    std::ofstream fout(path);
+    if (!fout) throw std::runtime_error("Cannot write the run report " + path);
+    fout.precision(17);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [phase, seconds] : m_times) {
+        fout << "time_" << phase << ": " << seconds << "\n";
+    }
+    for (const auto& [key, value] : m_values) fout << key << ": " << value << "\n";
+    fout << "peak_memory_mb: " << getPeakRSS() / (1024. * 1024) << "\n";
+}
+
+void report_edge_length_valence(
+    const TriMesh& mesh,
+    const std::function<Eigen::Vector3d(size_t)>& position)
+{
+    const auto edges = mesh.get_edges();
+    const auto vertices = mesh.get_vertices();
+    if (edges.empty() || vertices.empty()) return;
+
+    double sum_length = 0, max_length = 0, min_length = std::numeric_limits<double>::max();
+    for (const auto& e : edges) {
+        const double length =
+            (position(e.vid(mesh)) - position(e.switch_vertex(mesh).vid(mesh))).norm();
+        sum_length += length;
+        max_length = std::max(max_length, length);
+        min_length = std::min(min_length, length);
+    }
+    size_t sum_valence = 0, max_valence = 0, min_valence = std::numeric_limits<size_t>::max();
+    for (const auto& v : vertices) {
+        const size_t valence = mesh.get_one_ring_edges_for_vertex(v).size();
+        sum_valence += valence;
+        max_valence = std::max(max_valence, valence);
+        min_valence = std::min(min_valence, valence);
+    }
+
+    auto& report = RunReport::global();
+    report.set("avg_edge_length", sum_length / edges.size());
+    report.set("max_edge_length", max_length);
+    report.set("min_edge_length", min_length);
+    report.set("avg_valence", double(sum_valence) / vertices.size());
+    report.set("max_valence", max_valence);
+    report.set("min_valence", min_valence);
+}
+
+} // namespace wmtk
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <wmtk/utils/Profiler.hpp>
+
+#include <Eigen/Core>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// defined by getRSS.c, which is compiled with RunReport.cpp
+extern "C" {
+size_t getPeakRSS();
+size_t getCurrentRSS();
+}
+
+namespace wmtk {
+
+class TriMesh;
+
+/**
+ * @brief Timings and results of one run of an application, read by the scaling driver of
+ * app/scaling. The phase times are accumulated process wide so that the passes of the apps can
+ * time themselves with a ScopedPhase, without passing a report around.
+ */
+class RunReport
+{
+public:
+    static RunReport& global();
+
+    /// adds to the wall time of phase, a phase can run several times (e.g. once per iteration)
+    void add_time(const std::string& phase, double seconds);
+    /// a result of the run, e.g. an element count or a quality measure
+    void set(const std::string& key, double value);
+
+    /**
+     * @brief total_time is the wall time from start_total() to stop_total(). The apps start it
+     * once the input is read and stop it before the output is written, so that it covers the same
+     * span in all of them, the input and output phases are reported separately.
+     */
+    void start_total();
+    void stop_total();
+
+    /**
+     * @brief Writes "key: value" lines, time_<phase> in seconds for each phase in order of first
+     * use, then the values and peak_memory_mb.
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void write(const std::string& path) const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::optional<std::chrono::steady_clock::time_point> m_total_start;
+    std::vector<std::pair<std::string, double>> m_times;
+    std::vector<std::pair<std::string, double>> m_values;
+};
+
+/**
+ * @brief Sets the edge length and valence of a surface mesh in RunReport::global(): the
+ * avg/max/min_edge_length and avg/max/min_valence values, with position(vid) the vertex positions.
+ */
+void report_edge_length_valence(
+    const TriMesh& mesh,
+    const std::function<Eigen::Vector3d(size_t)>& position);
+
+/// Adds its lifetime to a phase of RunReport::global(), and records it as a Profiler zone.
+class ScopedPhase
+{
+public:
+    explicit ScopedPhase(std::string phase)
+        : m_phase(std::move(phase))
+        , m_start(std::chrono::steady_clock::now())
+        , m_zone(Profiler::enabled() ? Profiler::instance().intern(m_phase) : "")
+    {}
+    ~ScopedPhase()
+    {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+        RunReport::global().add_time(m_phase, elapsed.count());
+    }
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    std::string m_phase;
+    std::chrono::steady_clock::time_point m_start;
+    ProfileZone m_zone;
+};
+
+} // namespace wmtk
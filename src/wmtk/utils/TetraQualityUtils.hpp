@@ -1,5 +1,7 @@
 #pragma once
 
+#include "EnergyBatch.hpp"
+
 #include <Eigen/Core>
 #include <optional>
 
@@ -11,6 +13,7 @@ namespace wmtk {
  * @param stack with flattened 4x3 vertices positions, with the mover vertex always on the front.
  * This is the same convention with AMIPS_energy
  * @return Descend direction as computed from Newton method, (or gradient descent if Newton fails).
+ * @note wrappers of the templated newton_method/gradient_descent in NewtonMethod.hpp
  */
 Eigen::Vector3d newton_method_from_stack(
     std::vector<std::array<double, 12>>& stack,
@@ -22,6 +25,21 @@ Eigen::Vector3d gradient_descent_from_stack(
     std::vector<std::array<double, 12>>& stack,
     std::function<double(const std::array<double, 12>&)> energy,
     std::function<void(const std::array<double, 12>&, Eigen::Vector3d&)> jacobian);
+
+/**
+ * Same as above with batched energies (e.g. AMIPS_energy_batch): the stack is packed once in the
+ * structure-of-arrays layout and every evaluation runs over the whole one-ring at once.
+ */
+Eigen::Vector3d newton_method_from_stack(
+    const std::vector<std::array<double, 12>>& stack,
+    energy_batch::BatchFunction energy,
+    energy_batch::BatchFunction jacobian,
+    energy_batch::BatchFunction hessian);
+
+Eigen::Vector3d gradient_descent_from_stack(
+    const std::vector<std::array<double, 12>>& stack,
+    energy_batch::BatchFunction energy,
+    energy_batch::BatchFunction jacobian);
 /**
  * Reorders indices in a tetrahedron such that v0 is on the front. Using the tetra symmetry to
  * preserve orientation. Assumes v0 in tetra.
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "EnergyBatch.hpp"
+
 #include <Eigen/Core>
 #include <optional>
 
@@ -11,6 +13,7 @@ namespace wmtk {
  * @param stack with flattened 4x3 vertices positions, with the mover vertex always on the front.
  * This is the same convention with AMIPS_energy
  * @return Descend direction as computed from Newton method, (or gradient descent if Newton fails).
+ * @note wrappers of the templated newton_method/gradient_descent in NewtonMethod.hpp
  */
 Eigen::Vector2d newton_method_from_stack_2d(
     std::vector<std::array<double, 6>>& stack,
@@ -22,6 +25,16 @@ Eigen::Vector2d gradient_descent_from_stack_2d(
     std::vector<std::array<double, 6>>& stack,
     std::function<double(const std::array<double, 6>&)> energy,
     std::function<void(const std::array<double, 6>&, Eigen::Vector2d&)> jacobian);
+
+/**
+ * Same as above with batched energies (e.g. AMIPS2D_energy_batch), evaluated over the whole
+ * stack at once.
+ */
+Eigen::Vector2d newton_method_from_stack_2d(
+    const std::vector<std::array<double, 6>>& stack,
+    energy_batch::BatchFunction energy,
+    energy_batch::BatchFunction jacobian,
+    energy_batch::BatchFunction hessian);
 /**
  * Reorders indices in a triangle such that v0 is on the front. Using the triangle symmetry to
  * preserve orientation. Assumes v0 is in the triangle.
@@ -0,0 +1,313 @@
+#include "TriangleBVH.hpp"
+
+#include <wmtk/utils/EnergyBatch.hpp>
+#include <wmtk/utils/MortonOrder.hpp>
+
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace wmtk {
+
+namespace {
+constexpr double inf = std::numeric_limits<double>::infinity();
+// ranges larger than this are built in parallel
+constexpr size_t parallel_grain = 4096;
+constexpr uint32_t empty_slot = std::numeric_limits<uint32_t>::max();
+// entries of the traversal stack, checked against the depth of the tree in init
+constexpr size_t traversal_stack_size = 256;
+
+float round_down(double x)
+{
+    float f = static_cast<float>(x);
+    return f > x ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+}
+
+float round_up(double x)
+{
+    float f = static_cast<float>(x);
+    return f < x ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+}
+
+struct Box
+{
+    Eigen::Vector3d min = Eigen::Vector3d::Constant(inf);
+    Eigen::Vector3d max = Eigen::Vector3d::Constant(-inf);
+
+    void extend(const Box& b)
+    {
+        min = min.cwiseMin(b.min);
+        max = max.cwiseMax(b.max);
+    }
+};
+
+// stores the box of child slot i, rounded outwards to float, empty boxes are never reached
+void set_box(TriangleBVH::Node& node, int i, const Box& box)
+{
+    constexpr float finf = std::numeric_limits<float>::infinity();
+    const bool empty = box.min[0] > box.max[0];
+    node.min_x[i] = empty ? finf : round_down(box.min[0]);
+    node.min_y[i] = empty ? finf : round_down(box.min[1]);
+    node.min_z[i] = empty ? finf : round_down(box.min[2]);
+    node.max_x[i] = empty ? -finf : round_up(box.max[0]);
+    node.max_y[i] = empty ? -finf : round_up(box.max[1]);
+    node.max_z[i] = empty ? -finf : round_up(box.max[2]);
+}
+
+// the tree splits a range of triangles into four nearly equal parts
+std::array<size_t, 5> split(size_t b, size_t e)
+{
+    const size_t n = e - b;
+    return {{b, b + n / 4, b + n / 2, b + 3 * n / 4, e}};
+}
+
+// number of inner nodes of the subtree over n triangles
+size_t count_nodes(size_t n)
+{
+    if (n <= TriangleBVH::max_leaf_size) return 0;
+    const auto s = split(0, n);
+    size_t c = 1;
+    for (int i = 0; i < 4; i++) c += count_nodes(s[i + 1] - s[i]);
+    return c;
+}
+
+// number of inner node levels of the tree over n triangles, the splits are balanced
+size_t tree_depth(size_t n)
+{
+    size_t depth = 0;
+    for (; n > TriangleBVH::max_leaf_size; n = (n + 3) / 4) depth++;
+    return depth;
+}
+
+// lay out nodes in depth first order, the subtree of node i starts at i + 1
+struct Builder
+{
+    const std::vector<std::array<Eigen::Vector3d, 3>>& tris;
+    std::vector<TriangleBVH::Node>& nodes;
+
+    Box leaf_box(size_t b, size_t e) const
+    {
+        Box box;
+        for (size_t t = b; t < e; t++) {
+            for (const auto& v : tris[t]) {
+                box.min = box.min.cwiseMin(v);
+                box.max = box.max.cwiseMax(v);
+            }
+        }
+        return box;
+    }
+
+    // builds the inner node over [b, e) at index id and returns its box
+    Box build(size_t id, size_t b, size_t e)
+    {
+        const auto s = split(b, e);
+        std::array<Box, 4> boxes;
+        std::array<size_t, 4> child_ids;
+        size_t next = id + 1;
+        for (int i = 0; i < 4; i++) {
+            child_ids[i] = next;
+            next += count_nodes(s[i + 1] - s[i]);
+        }
+
+        auto build_child = [&](int i) {
+            auto& node = nodes[id];
+            const size_t n = s[i + 1] - s[i];
+            if (n == 0) {
+                node.child[i] = empty_slot;
+                node.count[i] = 0;
+            } else if (n <= TriangleBVH::max_leaf_size) {
+                node.child[i] = static_cast<uint32_t>(s[i]);
+                node.count[i] = static_cast<uint32_t>(n);
+                boxes[i] = leaf_box(s[i], s[i + 1]);
+            } else {
+                node.child[i] = static_cast<uint32_t>(child_ids[i]);
+                node.count[i] = 0;
+                boxes[i] = build(child_ids[i], s[i], s[i + 1]);
+            }
+        };
+        if (e - b > parallel_grain) {
+            tbb::parallel_invoke(
+                [&] { build_child(0); },
+                [&] { build_child(1); },
+                [&] { build_child(2); },
+                [&] { build_child(3); });
+        } else {
+            for (int i = 0; i < 4; i++) build_child(i);
+        }
+
+        auto& node = nodes[id];
+        Box box;
+        for (int i = 0; i < 4; i++) {
+            set_box(node, i, boxes[i]);
+            box.extend(boxes[i]);
+        }
+        return box;
+    }
+};
+
+// squared distances from p to the four child boxes, written so the loop runs in SIMD lanes
+WMTK_ALWAYS_INLINE void box_squared_distances(
+    const TriangleBVH::Node& node,
+    const Eigen::Vector3d& p,
+    double* __restrict d)
+{
+    auto axis = [](float lo, float hi, double x) {
+        const double d = std::max(double(lo) - x, x - double(hi));
+        return d > 0 ? d * d : 0.;
+    };
+    for (int i = 0; i < 4; i++) {
+        d[i] = axis(node.min_x[i], node.max_x[i], p[0]) + axis(node.min_y[i], node.max_y[i], p[1]) +
+               axis(node.min_z[i], node.max_z[i], p[2]);
+    }
+}
+
+/**
+ * Visits the triangles whose leaf box is closer than the current bound, nearer children first.
+ * Visit(t) returns the new bound (squared), or a negative value to stop.
+ */
+template <typename Visit>
+WMTK_ALWAYS_INLINE void traverse(
+    const std::vector<TriangleBVH::Node>& nodes,
+    const Eigen::Vector3d& p,
+    double bound,
+    Visit&& visit)
+{
+    if (nodes.empty()) return;
+    // at most 3 pending siblings per level, init checked that the tree is shallow enough
+    std::array<std::pair<uint32_t, double>, traversal_stack_size> stack;
+    int top = 0;
+    stack[top++] = {0, 0.};
+    while (top > 0) {
+        const auto [id, node_dist] = stack[--top];
+        if (node_dist > bound) continue;
+        const auto& node = nodes[id];
+        double d[4];
+        box_squared_distances(node, p, d);
+        std::array<int, 4> order = {{0, 1, 2, 3}};
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return d[a] < d[b]; });
+        // leaves right away, in order, inner nodes pushed so that the nearest is popped first
+        for (int k = 0; k < 4; k++) {
+            const int i = order[k];
+            if (d[i] > bound || node.count[i] == 0) continue;
+            for (uint32_t t = node.child[i]; t < node.child[i] + node.count[i]; t++) {
+                bound = visit(t);
+                if (bound < 0) return;
+            }
+        }
+        for (int k = 3; k >= 0; k--) {
+            const int i = order[k];
+            if (d[i] > bound || node.count[i] != 0 || node.child[i] == empty_slot) continue;
+            assert(top < int(stack.size()));
+            stack[top++] = {node.child[i], d[i]};
+        }
+    }
+}
+} // namespace
+
+double point_triangle_squared_distance(
+    const Eigen::Vector3d& p,
+    const Eigen::Vector3d& a,
+    const Eigen::Vector3d& b,
+    const Eigen::Vector3d& c)
+{
+    // Ericson, Real-Time Collision Detection, 5.1.5
+    const Eigen::Vector3d ab = b - a, ac = c - a, ap = p - a;
+    const double d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if (d1 <= 0 && d2 <= 0) return ap.squaredNorm();
+    const Eigen::Vector3d bp = p - b;
+    const double d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if (d3 >= 0 && d4 <= d3) return bp.squaredNorm();
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) return (ap - d1 / (d1 - d3) * ab).squaredNorm();
+    const Eigen::Vector3d cp = p - c;
+    const double d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if (d6 >= 0 && d5 <= d6) return cp.squaredNorm();
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) return (ap - d2 / (d2 - d6) * ac).squaredNorm();
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+        return (bp - (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b)).squaredNorm();
+    const double denom = 1 / (va + vb + vc);
+    return (ap - vb * denom * ab - vc * denom * ac).squaredNorm();
+}
+
+void TriangleBVH::init(
+    const std::vector<Eigen::Vector3d>& V,
+    const std::vector<Eigen::Vector3i>& F)
+{
+    const size_t n = F.size();
+    m_nodes.clear();
+    m_triangles.resize(n);
+    m_face_ids.resize(n);
+    if (n == 0) return;
+    // the triangles are indexed with 32 bits and the traversal stack has a fixed size
+    if (n >= empty_slot || 3 * tree_depth(n) + 1 > traversal_stack_size) {
+        throw std::runtime_error("Too many triangles for a TriangleBVH.");
+    }
+
+    // sort the triangles along a Morton curve of their centroids
+    std::vector<Eigen::Vector3d> centroids(n);
+    tbb::parallel_for(size_t(0), n, [&](size_t i) {
+        centroids[i] = (V[F[i][0]] + V[F[i][1]] + V[F[i][2]]) / 3;
+    });
+    const auto order = morton_order(centroids);
+    tbb::parallel_for(size_t(0), n, [&](size_t i) {
+        const auto& f = F[order[i]];
+        m_face_ids[i] = int(order[i]);
+        m_triangles[i] = {{V[f[0]], V[f[1]], V[f[2]]}};
+    });
+
+    // a root also for tiny meshes, so the traversal needs no special case
+    m_nodes.resize(std::max<size_t>(count_nodes(n), 1));
+    Builder builder{m_triangles, m_nodes};
+    if (n <= max_leaf_size) {
+        auto& root = m_nodes[0];
+        for (int i = 0; i < 4; i++) {
+            set_box(root, i, i == 0 ? builder.leaf_box(0, n) : Box());
+            root.child[i] = i == 0 ? 0 : empty_slot;
+            root.count[i] = i == 0 ? uint32_t(n) : 0;
+        }
+    } else {
+        builder.build(0, 0, n);
+    }
+}
+
+WMTK_BATCH_TARGETS bool TriangleBVH::is_within(const Eigen::Vector3d& p, double sq_eps, int& hint)
+    const
+{
+    if (hint >= 0 && hint < int(m_triangles.size())) {
+        const auto& t = m_triangles[hint];
+        if (point_triangle_squared_distance(p, t[0], t[1], t[2]) <= sq_eps) return true;
+    }
+    bool found = false;
+    traverse(m_nodes, p, sq_eps, [&](uint32_t id) {
+        const auto& t = m_triangles[id];
+        if (point_triangle_squared_distance(p, t[0], t[1], t[2]) > sq_eps) return sq_eps;
+        found = true;
+        hint = int(id);
+        return -1.;
+    });
+    return found;
+}
+
+WMTK_BATCH_TARGETS double TriangleBVH::squared_distance(const Eigen::Vector3d& p) const
+{
+    double best = inf;
+    traverse(m_nodes, p, inf, [&](uint32_t id) {
+        const auto& t = m_triangles[id];
+        best = std::min(best, point_triangle_squared_distance(p, t[0], t[1], t[2]));
+        return best;
+    });
+    return best;
+}
+
+} // namespace wmtk
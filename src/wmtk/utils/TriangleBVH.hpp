@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace wmtk {
+
+/**
+ * @brief Bounding volume hierarchy of a triangle soup, answering "is there a triangle within
+ * distance eps of p".
+ *
+ * The tree is 4-wide and stored as a flat array of 128-byte nodes, each holding the boxes of its
+ * four children in structure-of-arrays form, so one node costs two cache lines and its four box
+ * distances are computed together in SIMD lanes. Boxes are stored as floats rounded outwards,
+ * distances are computed in double, so pruning is always conservative. Leaves hold up to four
+ * triangles, in the order of the Morton codes of their centroids, which is also how the tree is
+ * split. The build runs in parallel with TBB.
+ *
+ * Queries are const and only use the stack, so any number of threads can query concurrently.
+ */
+class TriangleBVH
+{
+public:
+    static constexpr int max_leaf_size = 4;
+
+    struct alignas(64) Node
+    {
+        float min_x[4], min_y[4], min_z[4];
+        float max_x[4], max_y[4], max_z[4];
+        // inner node index, or first triangle of the leaf
+        uint32_t child[4];
+        // number of triangles of the leaf, 0 for inner nodes and empty slots
+        uint32_t count[4];
+    };
+    static_assert(sizeof(Node) == 128, "two cache lines per node");
+
+    TriangleBVH() = default;
+    TriangleBVH(const std::vector<Eigen::Vector3d>& V, const std::vector<Eigen::Vector3i>& F)
+    {
+        init(V, F);
+    }
+
+    void init(const std::vector<Eigen::Vector3d>& V, const std::vector<Eigen::Vector3i>& F);
+
+    /**
+     * @brief Stops at the first triangle closer than sqrt(sq_eps), not necessarily the nearest.
+     * @param hint in: a triangle to try first, e.g. the one found for the previous query, -1 for
+     * none. out: the triangle found, unchanged if none.
+     */
+    bool is_within(const Eigen::Vector3d& p, double sq_eps, int& hint) const;
+    bool is_within(const Eigen::Vector3d& p, double sq_eps) const
+    {
+        int hint = -1;
+        return is_within(p, sq_eps, hint);
+    }
+
+    /// squared distance from p to the nearest triangle, infinity if empty
+    double squared_distance(const Eigen::Vector3d& p) const;
+
+    size_t num_triangles() const { return m_triangles.size(); }
+    size_t num_nodes() const { return m_nodes.size(); }
+    /// index of a triangle (e.g. a hint) in the input faces
+    int input_face(int t) const { return m_face_ids[t]; }
+
+private:
+    std::vector<Node> m_nodes; // root first
+    std::vector<std::array<Eigen::Vector3d, 3>> m_triangles; // in leaf order
+    std::vector<int> m_face_ids;
+};
+
+/**
+ * @brief Squared distance between p and the triangle (a, b, c).
+ */
+double point_triangle_squared_distance(
+    const Eigen::Vector3d& p,
+    const Eigen::Vector3d& a,
+    const Eigen::Vector3d& b,
+    const Eigen::Vector3d& c);
+
+} // namespace wmtk
@@ -1,14 +1,31 @@
 #pragma once
 
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
 
 #include <mshio/mshio.h>
 
+// clang-format off
+#include <wmtk/utils/DisableWarnings.hpp>
+#include <tbb/parallel_for.h>
+#include <wmtk/utils/EnableWarnings.hpp>
+// clang-format on
+
 #include "Logger.hpp"
+#include "MshDataSection.hpp"
 
 namespace wmtk {
 
+/**
+ * @brief Gmsh MSH (4.1) mesh with vertex and element attributes.
+ *
+ * The add_* callbacks are called from several threads, each index once. Attributes added here
+ * are kept as contiguous columns and written as whole blocks by save(), the ones of a loaded
+ * file are stored per entry by mshio.
+ */
 class MshData
 {
 public:
@@ -200,9 +217,11 @@ public:
 
     void save(const std::string& filename, bool binary = true)
     {
-        m_spec.mesh_format.file_type = binary;
-        mshio::validate_spec(m_spec);
-        mshio::save_msh(filename, m_spec);
+        std::ofstream out(filename, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Cannot open " + filename + " for writing.");
+        }
+        save(out, binary);
     }
 
     void save(std::ostream& out, bool binary = true)
@@ -210,11 +229,25 @@ public:
         m_spec.mesh_format.file_type = binary;
         mshio::validate_spec(m_spec);
         mshio::save_msh(out, m_spec);
+        // data sections may follow the ones written by mshio in any order
+        for (const auto& column : m_node_columns) save_column(out, "NodeData", column, binary);
+        for (const auto& column : m_element_columns)
+            save_column(out, "ElementData", column, binary);
     }
 
-    void load(const std::string& filename) { m_spec = mshio::load_msh(filename); }
+    void load(const std::string& filename)
+    {
+        m_spec = mshio::load_msh(filename);
+        m_node_columns.clear();
+        m_element_columns.clear();
+    }
 
-    void load(std::istream& in) { m_spec = mshio::load_msh(in); }
+    void load(std::istream& in)
+    {
+        m_spec = mshio::load_msh(in);
+        m_node_columns.clear();
+        m_element_columns.clear();
+    }
 
 private:
     template <int DIM, typename Fn>
@@ -224,19 +257,19 @@ private:
         if (num_vertices == 0) return;
         mshio::NodeBlock block;
         block.num_nodes_in_block = num_vertices;
-        block.tags.reserve(num_vertices);
-        block.data.reserve(num_vertices * 3);
         block.entity_dim = DIM;
         block.entity_tag = m_spec.nodes.num_entity_blocks + 1;
 
         const size_t tag_offset = m_spec.nodes.max_node_tag;
-        for (size_t i = 0; i < num_vertices; i++) {
+        block.tags.resize(num_vertices);
+        block.data.resize(num_vertices * 3);
+        tbb::parallel_for(size_t(0), num_vertices, [&](size_t i) {
             const auto& v = get_vertex_cb(i);
-            block.tags.push_back(tag_offset + i + 1);
-            block.data.push_back(v[0]);
-            block.data.push_back(v[1]);
-            block.data.push_back(v[2]);
-        }
+            block.tags[i] = tag_offset + i + 1;
+            block.data[i * 3] = v[0];
+            block.data[i * 3 + 1] = v[1];
+            block.data[i * 3 + 2] = v[2];
+        });
 
         m_spec.nodes.num_entity_blocks += 1;
         m_spec.nodes.num_nodes += num_vertices;
@@ -277,14 +310,15 @@ private:
 
         const size_t vertex_offset = vertex_block.tags.front() - 1;
         const size_t tag_offset = m_spec.elements.max_element_tag;
-        block.data.reserve(num_elements * (DIM + 2));
-        for (size_t i = 0; i < num_elements; i++) {
+        block.data.resize(num_elements * (DIM + 2));
+        tbb::parallel_for(size_t(0), num_elements, [&](size_t i) {
             const auto& e = get_element_cb(i);
-            block.data.push_back(tag_offset + i + 1); // element tag.
+            auto* element = block.data.data() + i * (DIM + 2);
+            element[0] = tag_offset + i + 1; // element tag.
             for (size_t j = 0; j <= DIM; j++) {
-                block.data.push_back(vertex_offset + e[j] + 1);
+                element[j + 1] = vertex_offset + e[j] + 1;
             }
-        }
+        });
 
         m_spec.elements.num_entity_blocks++;
         m_spec.elements.num_elements += num_elements;
@@ -311,27 +345,11 @@ private:
                                      "from the vertex attribute you want to add.");
         }
 
-        mshio::Data data;
-        data.header.string_tags = {name};
-        data.header.real_tags = {0.0};
-        data.header.int_tags = {0, NUM_FIELDS, int(num_vertices), 0, ELEMENT_DIM};
-
-        data.entries.resize(num_vertices);
-        for (size_t i = 0; i < num_vertices; i++) {
-            auto& entry = data.entries[i];
-            entry.tag = vertex_block.tags[i];
-            entry.data.reserve(NUM_FIELDS);
-            const auto& attr = get_attribute_cb(i);
-            if constexpr (NUM_FIELDS == 1) {
-                entry.data.push_back(attr);
-            } else {
-                for (size_t j = 0; j < NUM_FIELDS; j++) {
-                    entry.data.push_back(attr[j]);
-                }
-            }
-        }
-
-        m_spec.node_data.push_back(std::move(data));
+        m_node_columns.push_back(make_column<NUM_FIELDS, ELEMENT_DIM>(
+            name,
+            vertex_block.tags.front(),
+            num_vertices,
+            get_attribute_cb));
     }
 
     template <int NUM_FIELDS, int ELEMENT_DIM, typename Fn>
@@ -351,27 +369,98 @@ private:
         }
         const size_t num_elements = elem_block.num_elements_in_block;
 
-        mshio::Data data;
-        data.header.string_tags = {name};
-        data.header.real_tags = {0.0};
-        data.header.int_tags = {0, NUM_FIELDS, int(num_elements), 0, ELEMENT_DIM};
+        // element tags are consecutive within a block
+        m_element_columns.push_back(make_column<NUM_FIELDS, ELEMENT_DIM>(
+            name,
+            elem_block.data.front(),
+            num_elements,
+            get_attribute_cb));
+    }
 
-        data.entries.resize(num_elements);
-        for (size_t i = 0; i < num_elements; i++) {
-            auto& entry = data.entries[i];
-            entry.tag = elem_block.data[i * (ELEMENT_DIM + 2)];
-            entry.data.reserve(NUM_FIELDS);
+    /**
+     * Attribute values of size consecutive vertices or elements, the first one tagged first_tag,
+     * stored as NUM_FIELDS contiguous values per entry.
+     */
+    struct DataColumn
+    {
+        mshio::DataHeader header;
+        size_t first_tag;
+        size_t size;
+        int num_fields;
+        std::vector<double> values;
+    };
+
+    template <int NUM_FIELDS, int ELEMENT_DIM, typename Fn>
+    static DataColumn make_column(
+        const std::string& name,
+        size_t first_tag,
+        size_t size,
+        const Fn& get_attribute_cb)
+    {
+        DataColumn column;
+        column.header.string_tags = {name};
+        column.header.real_tags = {0.0};
+        column.header.int_tags = {0, NUM_FIELDS, int(size), 0, ELEMENT_DIM};
+        column.first_tag = first_tag;
+        column.size = size;
+        column.num_fields = NUM_FIELDS;
+        column.values.resize(size * NUM_FIELDS);
+        tbb::parallel_for(size_t(0), size, [&](size_t i) {
             const auto& attr = get_attribute_cb(i);
             if constexpr (NUM_FIELDS == 1) {
-                entry.data.push_back(attr);
+                column.values[i] = attr;
             } else {
                 for (size_t j = 0; j < NUM_FIELDS; j++) {
-                    entry.data.push_back(attr[j]);
+                    column.values[i * NUM_FIELDS + j] = attr[j];
                 }
             }
+        });
+        return column;
+    }
+
+    // writes a $NodeData or $ElementData section the way mshio does
+    static void save_column(
+        std::ostream& out,
+        const std::string& section,
+        const DataColumn& column,
+        bool binary)
+    {
+        const auto& header = column.header;
+        msh_data::write_header(
+            out,
+            section,
+            header.string_tags,
+            header.real_tags,
+            header.int_tags);
+
+        const size_t num_fields = column.num_fields;
+        if (binary) {
+            // written one chunk at a time, so the buffer stays small
+            const size_t entry_size = sizeof(int) + sizeof(double) * num_fields;
+            const size_t chunk_size = std::max<size_t>(1, (size_t(1) << 24) / entry_size);
+            std::vector<char> buffer;
+            for (size_t begin = 0; begin < column.size; begin += chunk_size) {
+                const size_t end = std::min(column.size, begin + chunk_size);
+                msh_data::write_binary_entries(
+                    out,
+                    column.first_tag + begin,
+                    column.values.data() + begin * num_fields,
+                    end - begin,
+                    num_fields,
+                    buffer);
+            }
+            out << "\n";
+        } else {
+            const auto precision = out.precision(17);
+            for (size_t i = 0; i < column.size; i++) {
+                out << column.first_tag + i;
+                for (size_t j = 0; j < num_fields; j++)
+                    out << " " << column.values[i * num_fields + j];
+                out << "\n";
+            }
+            out.precision(precision);
         }
-
-        m_spec.element_data.push_back(std::move(data));
+        out << "$End" << section << "\n";
     }
 
     template <int DIM>
@@ -483,6 +572,11 @@ private:
                 attr_names.push_back(data.header.string_tags.front());
             }
         }
+        for (const auto& column : m_node_columns) {
+            if (column.header.int_tags[4] == DIM) {
+                attr_names.push_back(column.header.string_tags.front());
+            }
+        }
         return attr_names;
     }
 
@@ -497,6 +591,11 @@ private:
                 attr_names.push_back(data.header.string_tags.front());
             }
         }
+        for (const auto& column : m_element_columns) {
+            if (column.header.int_tags[4] == DIM) {
+                attr_names.push_back(column.header.string_tags.front());
+            }
+        }
         return attr_names;
     }
 
@@ -517,6 +616,7 @@ private:
                 set_attr(tag, entry.data);
             }
         }
+        extract_column_attribute<DIM>(m_node_columns, attr_name, tag_offset, set_attr);
     }
 
     template <int DIM, typename Fn>
@@ -536,10 +636,36 @@ private:
                 set_attr(tag, entry.data);
             }
         }
+        extract_column_attribute<DIM>(m_element_columns, attr_name, tag_offset, set_attr);
+    }
+
+    template <int DIM, typename Fn>
+    static void extract_column_attribute(
+        const std::vector<DataColumn>& columns,
+        const std::string& attr_name,
+        size_t tag_offset,
+        Fn&& set_attr)
+    {
+        std::vector<double> data;
+        for (const auto& column : columns) {
+            if (column.header.string_tags.front() != attr_name) continue;
+            if (column.header.int_tags[4] != DIM) {
+                throw std::runtime_error("Attribute " + attr_name + " is of the wrong DIM.");
+            }
+
+            for (size_t i = 0; i < column.size; i++) {
+                const auto* values = column.values.data() + i * column.num_fields;
+                data.assign(values, values + column.num_fields);
+                set_attr(column.first_tag + i - tag_offset, data);
+            }
+        }
     }
 
 private:
     mshio::MshSpec m_spec;
+    // attributes added with add_*_attribute, written after the mshio sections
+    std::vector<DataColumn> m_node_columns;
+    std::vector<DataColumn> m_element_columns;
 };
 
 } // namespace wmtk
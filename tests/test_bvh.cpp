@@ -0,0 +1,136 @@
+#include <wmtk/utils/MortonOrder.hpp>
+#include <wmtk/utils/TriangleBVH.hpp>
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace wmtk;
+
+namespace {
+// a bumpy open grid, so that boxes overlap and points are at all distances
+void bumpy_grid(int n, std::vector<Eigen::Vector3d>& V, std::vector<Eigen::Vector3i>& F)
+{
+    V.clear();
+    F.clear();
+    for (int i = 0; i <= n; i++)
+        for (int j = 0; j <= n; j++)
+            V.emplace_back(double(i) / n, double(j) / n, 0.1 * std::sin(7. * i / n + 5. * j / n));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            const int v = i * (n + 1) + j;
+            F.emplace_back(v, v + n + 1, v + 1);
+            F.emplace_back(v + 1, v + n + 1, v + n + 2);
+        }
+    }
+}
+
+double brute_force_squared_distance(
+    const std::vector<Eigen::Vector3d>& V,
+    const std::vector<Eigen::Vector3i>& F,
+    const Eigen::Vector3d& p)
+{
+    double d = std::numeric_limits<double>::infinity();
+    for (const auto& f : F)
+        d = std::min(d, point_triangle_squared_distance(p, V[f[0]], V[f[1]], V[f[2]]));
+    return d;
+}
+} // namespace
+
+TEST_CASE("point_triangle_squared_distance", "[bvh]")
+{
+    const Eigen::Vector3d a(0, 0, 0), b(1, 0, 0), c(0, 1, 0);
+    REQUIRE(point_triangle_squared_distance({0.2, 0.2, 0.5}, a, b, c) == Approx(0.25));
+    REQUIRE(point_triangle_squared_distance({-1, -1, 0}, a, b, c) == Approx(2));
+    REQUIRE(point_triangle_squared_distance({2, 0, 1}, a, b, c) == Approx(2));
+    REQUIRE(point_triangle_squared_distance({0.5, -1, 0}, a, b, c) == Approx(1));
+    REQUIRE(point_triangle_squared_distance({1, 1, 0}, a, b, c) == Approx(0.5));
+    REQUIRE(point_triangle_squared_distance({-1, 0.5, 0}, a, b, c) == Approx(1));
+}
+
+TEST_CASE("triangle_bvh_matches_brute_force", "[bvh]")
+{
+    std::vector<Eigen::Vector3d> V;
+    std::vector<Eigen::Vector3i> F;
+    // 3 triangles fit the root, 2 * 40 * 40 need several levels
+    for (int n : {1, 2, 40}) {
+        bumpy_grid(n, V, F);
+        if (n == 1) F.pop_back();
+        TriangleBVH bvh(V, F);
+        REQUIRE(bvh.num_triangles() == F.size());
+
+        std::mt19937 gen(n);
+        std::uniform_real_distribution<double> dist(-0.3, 1.3);
+        const double sq_eps = 0.01 * 0.01;
+        int hint = -1;
+        for (int k = 0; k < 500; k++) {
+            const Eigen::Vector3d p(dist(gen), dist(gen), 0.2 * dist(gen) - 0.1);
+            const double d = brute_force_squared_distance(V, F, p);
+            REQUIRE(bvh.squared_distance(p) == Approx(d));
+            REQUIRE(bvh.is_within(p, sq_eps) == (d <= sq_eps));
+            REQUIRE(bvh.is_within(p, sq_eps, hint) == (d <= sq_eps));
+            if (d <= sq_eps) {
+                const auto& f = F[bvh.input_face(hint)];
+                REQUIRE(point_triangle_squared_distance(p, V[f[0]], V[f[1]], V[f[2]]) <= sq_eps);
+            }
+        }
+    }
+
+    TriangleBVH empty({}, {});
+    REQUIRE(!empty.is_within(Eigen::Vector3d::Zero(), 1.));
+}
+
+TEST_CASE("morton_order", "[bvh]")
+{
+    // a 4x4x4 grid, shuffled
+    std::vector<Eigen::Vector3d> pts;
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            for (int k = 0; k < 4; k++) pts.emplace_back(i, j, k);
+    std::shuffle(pts.begin(), pts.end(), std::mt19937(5));
+
+    const auto order = morton_order(pts);
+    auto sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    for (uint32_t i = 0; i < pts.size(); i++) REQUIRE(sorted[i] == i);
+    // the curve visits the octants of the grid one after the other
+    for (size_t i = 0; i < pts.size(); i++) {
+        const Eigen::Vector3d octant = (pts[order[i]] / 2).array().floor();
+        REQUIRE(octant == (pts[order[i - i % 8]] / 2).array().floor().matrix());
+    }
+
+    // points outside the cube are clamped to it
+    const Eigen::Vector3d lo(0, 0, 0);
+    const auto codes = morton_codes(
+        {Eigen::Vector3d(-1, -1, -1), lo, Eigen::Vector3d(3, 3, 3), Eigen::Vector3d(9, 9, 9)},
+        lo,
+        3.);
+    REQUIRE(codes[0] == codes[1]);
+    REQUIRE(codes[2] == codes[3]);
+    REQUIRE(codes[1] < codes[2]);
+    REQUIRE(morton_order({}).empty());
+}
+
+TEST_CASE("triangle_bvh_benchmark", "[bvh][.benchmark]")
+{
+    std::vector<Eigen::Vector3d> V;
+    std::vector<Eigen::Vector3i> F;
+    bumpy_grid(500, V, F);
+
+    BENCHMARK("build 500k triangles")
+    {
+        return TriangleBVH(V, F).num_nodes();
+    };
+
+    TriangleBVH bvh(V, F);
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dist(0, 1);
+    std::vector<Eigen::Vector3d> pts(10000);
+    for (auto& p : pts) p = Eigen::Vector3d(dist(gen), dist(gen), 0.2 * dist(gen) - 0.1);
+    BENCHMARK("10k is_within")
+    {
+        int n = 0;
+        for (const auto& p : pts) n += bvh.is_within(p, 1e-6);
+        return n;
+    };
+}
@@ -2,7 +2,9 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <limits>
+#include <random>
 
 namespace {
     // TODO: this should use a predicate instead
@@ -185,6 +187,28 @@ TEST_CASE("Delaunay3D", "[delaunay][3d]")
         REQUIRE(tets.size() == (N - 1) * (N - 1) * (N - 1) * 6);
         validate(vertices, tets);
     }
+    SECTION("Insertion orders")
+    {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> coord(0, 1);
+        std::vector<Point3D> points(5000);
+        for (auto& p : points) p = {{coord(gen), coord(gen), coord(gen)}};
+
+        // random points are in general position, the tetrahedralization is unique
+        auto sorted_tets = [](std::vector<Tetrahedron> tets) {
+            for (auto& t : tets) std::sort(t.begin(), t.end());
+            std::sort(tets.begin(), tets.end());
+            return tets;
+        };
+        auto [vertices, tets] = delaunay3D(points);
+        const auto expected = sorted_tets(tets);
+        for (auto insertion : {DelaunayInsertion::Reordered, DelaunayInsertion::Parallel}) {
+            auto [reordered_vertices, reordered_tets] = delaunay3D(points, insertion);
+            REQUIRE(reordered_vertices == points);
+            validate(reordered_vertices, reordered_tets);
+            REQUIRE(sorted_tets(reordered_tets) == expected);
+        }
+    }
 }
 
 TEST_CASE("Delaunay2D", "[delaunay][2d]")
@@ -0,0 +1,204 @@
+#include <wmtk/utils/AMIPS.h>
+#include <wmtk/utils/AMIPS2D.h>
+#include <wmtk/utils/EnergyBatch.hpp>
+#include <wmtk/utils/EnergyHarmonicTet.hpp>
+#include <wmtk/utils/NewtonMethod.hpp>
+#include <wmtk/utils/TetraQualityUtils.hpp>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace wmtk;
+
+namespace {
+// random positively oriented tets around a common first vertex, as in a one-ring
+std::vector<std::array<double, 12>> random_stack(size_t n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<std::array<double, 12>> stack;
+    while (stack.size() < n) {
+        std::array<double, 12> T;
+        T[0] = 0.1, T[1] = 0.2, T[2] = 0.3;
+        for (int k = 3; k < 12; k++) T[k] = dist(gen);
+        Eigen::Map<const Eigen::Vector3d> a(T.data()), b(T.data() + 3), c(T.data() + 6),
+            d(T.data() + 9);
+        if ((b - a).cross(c - a).dot(d - a) > 1e-2) stack.push_back(T);
+    }
+    return stack;
+}
+
+template <size_t N>
+std::vector<double> to_soa(const std::vector<std::array<double, N>>& stack)
+{
+    std::vector<double> T(N * stack.size());
+    for (size_t i = 0; i < stack.size(); i++)
+        for (size_t k = 0; k < N; k++) T[k * stack.size() + i] = stack[i][k];
+    return T;
+}
+} // namespace
+
+TEST_CASE("amips_batch_matches_scalar", "[energy]")
+{
+    const size_t n = 37; // not a multiple of the vector width
+    const auto stack = random_stack(n, 3);
+    const auto T = to_soa(stack);
+
+    std::vector<double> e(n), J(3 * n), H(9 * n);
+    AMIPS_energy_batch(n, T.data(), n, e.data());
+    AMIPS_jacobian_batch(n, T.data(), n, J.data());
+    AMIPS_hessian_batch(n, T.data(), n, H.data());
+    for (size_t i = 0; i < n; i++) {
+        REQUIRE(e[i] == Approx(AMIPS_energy(stack[i])).epsilon(1e-12));
+        Eigen::Vector3d j;
+        AMIPS_jacobian(stack[i], j);
+        for (int d = 0; d < 3; d++)
+            REQUIRE(J[d * n + i] == Approx(j[d]).epsilon(1e-10).margin(1e-10));
+        Eigen::Matrix3d h;
+        AMIPS_hessian(stack[i], h);
+        for (int d = 0; d < 9; d++)
+            REQUIRE(H[d * n + i] == Approx(h.data()[d]).epsilon(1e-10).margin(1e-10));
+    }
+
+    std::vector<double> g(3 * n);
+    harmonic_tet_energy_batch(n, T.data(), n, e.data());
+    harmonic_tet_jacobian_batch(n, T.data(), n, g.data());
+    for (size_t i = 0; i < n; i++) {
+        REQUIRE(e[i] == Approx(harmonic_tet_energy(stack[i])).epsilon(1e-12));
+        Eigen::Vector3d j;
+        harmonic_tet_jacobian(stack[i], j);
+        for (int d = 0; d < 3; d++)
+            REQUIRE(g[d * n + i] == Approx(j[d]).epsilon(1e-10).margin(1e-10));
+    }
+
+    // inverted elements keep the scalar convention
+    auto flipped = stack[0];
+    std::swap(flipped[3], flipped[6]);
+    std::swap(flipped[4], flipped[7]);
+    std::swap(flipped[5], flipped[8]);
+    double h;
+    harmonic_tet_energy_batch(1, flipped.data(), 1, &h);
+    REQUIRE(h == std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("amips2d_batch_matches_scalar", "[energy]")
+{
+    const std::vector<std::array<double, 6>> stack = {
+        {{0, 0, 1, 0, 0.5, 0.8}},
+        {{0, 0, 0.5, 0.8, -0.7, 0.3}},
+        {{0, 0, -0.7, 0.3, -0.2, -0.9}}};
+    const size_t n = stack.size();
+    const auto T = to_soa(stack);
+    std::vector<double> e(n), J(2 * n), H(4 * n);
+    AMIPS2D_energy_batch(n, T.data(), n, e.data());
+    AMIPS2D_jacobian_batch(n, T.data(), n, J.data());
+    AMIPS2D_hessian_batch(n, T.data(), n, H.data());
+    for (size_t i = 0; i < n; i++) {
+        REQUIRE(e[i] == Approx(AMIPS2D_energy(stack[i])));
+        Eigen::Vector2d j;
+        AMIPS2D_jacobian(stack[i], j);
+        Eigen::Matrix2d h;
+        AMIPS2D_hessian(stack[i], h);
+        for (int d = 0; d < 2; d++) REQUIRE(J[d * n + i] == Approx(j[d]).margin(1e-12));
+        for (int d = 0; d < 4; d++) REQUIRE(H[d * n + i] == Approx(h.data()[d]).margin(1e-12));
+    }
+}
+
+TEST_CASE("newton_batch_matches_scalar", "[energy]")
+{
+    auto stack = random_stack(24, 5);
+    const Eigen::Vector3d batched = newton_method_from_stack(
+        stack,
+        AMIPS_energy_batch,
+        AMIPS_jacobian_batch,
+        AMIPS_hessian_batch);
+    const Eigen::Vector3d scalar =
+        newton_method_from_stack(stack, AMIPS_energy, AMIPS_jacobian, AMIPS_hessian);
+    REQUIRE((batched - scalar).norm() < 1e-8);
+}
+
+TEST_CASE("newton_batch_benchmark", "[.benchmark]")
+{
+    auto stack = random_stack(24, 5);
+    BENCHMARK("newton_method_from_stack scalar")
+    {
+        return newton_method_from_stack(stack, AMIPS_energy, AMIPS_jacobian, AMIPS_hessian);
+    };
+    BENCHMARK("newton_method_from_stack batch")
+    {
+        return newton_method_from_stack(
+            stack,
+            AMIPS_energy_batch,
+            AMIPS_jacobian_batch,
+            AMIPS_hessian_batch);
+    };
+}
+
+TEST_CASE("simd_cbrt_full_range", "[energy]")
+{
+    using energy_batch::SimdMath;
+    using limits = std::numeric_limits<double>;
+    // every binade from the smallest subnormal to the largest double, a few mantissas each
+    for (int e = limits::min_exponent - 53;
+         e <= limits::max_exponent;
+         e++) {
+        for (double m : {0.5, 0.61, 0.75, 0.9, 0.9999999999999999}) {
+            const double x = std::ldexp(m, e);
+            if (x == 0 || std::isinf(x)) continue;
+            const double expected = std::cbrt(x);
+            CAPTURE(x);
+            REQUIRE(std::abs(SimdMath::cbrt(x) - expected) <= 1e-15 * expected);
+            REQUIRE(SimdMath::pow_m13(x) == Approx(1 / expected).epsilon(1e-15));
+        }
+    }
+    REQUIRE(SimdMath::cbrt(0.) == 0.);
+    REQUIRE(SimdMath::cbrt(limits::denorm_min()) ==
+            Approx(std::cbrt(limits::denorm_min())).epsilon(1e-15));
+    REQUIRE(SimdMath::cbrt(limits::max()) ==
+            Approx(std::cbrt(limits::max())).epsilon(1e-15));
+    REQUIRE(std::isinf(SimdMath::cbrt(limits::infinity())));
+}
+
+TEST_CASE("newton_method_template", "[energy]")
+{
+    // single tet, the optimum is the regular configuration with AMIPS = 3
+    std::vector<std::array<double, 12>> stack = {{{0.1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1}}};
+    const auto scalar_kernels = [&](const SmoothingOptions& options) {
+        return newton_method<12, 3>(
+            stack,
+            energy_batch::per_element_energy<12>(AMIPS_energy),
+            energy_batch::per_element_jacobian<12, 3>(AMIPS_jacobian),
+            energy_batch::per_element_hessian<12, 3>(AMIPS_hessian),
+            options);
+    };
+    SmoothingOptions options;
+    options.max_iterations = 100;
+    Eigen::Vector3d pos = scalar_kernels(options);
+    const Eigen::Vector3d batched = newton_method<12, 3>(
+        stack,
+        AMIPS_energy_batch,
+        AMIPS_jacobian_batch,
+        AMIPS_hessian_batch,
+        options);
+    REQUIRE((pos - batched).norm() < 1e-8);
+
+    auto T = stack[0];
+    for (int j = 0; j < 3; j++) T[j] = pos[j];
+    REQUIRE(AMIPS_energy(T) == Approx(3.));
+
+    options.min_relative_decrease = 1e-6;
+    pos = scalar_kernels(options);
+    for (int j = 0; j < 3; j++) T[j] = pos[j];
+    REQUIRE(AMIPS_energy(T) == Approx(3.));
+
+    // the std::function interface forwards to the same solver
+    REQUIRE(
+        (gradient_descent_from_stack(stack, AMIPS_energy, AMIPS_jacobian) -
+         gradient_descent<12, 3>(
+             stack,
+             energy_batch::per_element_energy<12>(AMIPS_energy),
+             energy_batch::per_element_jacobian<12, 3>(AMIPS_jacobian)))
+            .norm() == 0);
+}
@@ -0,0 +1,99 @@
+#include <wmtk/utils/FaceTagMap.hpp>
+
+#include <catch2/catch.hpp>
+#include <tbb/global_control.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <random>
+
+using namespace wmtk;
+
+TEST_CASE("face_tags_inline_and_heap", "[face_tag_map]")
+{
+    FaceTags tags;
+    REQUIRE(tags.empty());
+    for (int i = 0; i < 10; i++) {
+        tags.push_back(i);
+        REQUIRE(tags.size() == i + 1);
+        REQUIRE(tags.to_vector().back() == i);
+    }
+    REQUIRE(tags.to_vector() == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    auto copy = tags;
+    tags.clear();
+    REQUIRE(tags.empty());
+    REQUIRE(copy.size() == 10);
+    tags.push_back(7);
+    REQUIRE(tags.to_vector() == std::vector<int>{7});
+}
+
+TEST_CASE("face_tag_map_matches_std_map", "[face_tag_map]")
+{
+    FaceTagMap map;
+    std::map<FaceTagMap::Key, std::vector<int>> expected;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<size_t> vertex(0, 200);
+    for (int i = 0; i < 20000; i++) {
+        FaceTagMap::Key f = {{vertex(gen), vertex(gen), vertex(gen)}};
+        std::sort(f.begin(), f.end());
+        switch (i % 4) {
+        case 0:
+        case 1:
+            map.add(f, i);
+            expected[f].push_back(i);
+            break;
+        case 2: {
+            const auto tags = map.take(f);
+            auto it = expected.find(f);
+            REQUIRE(tags.to_vector() == (it == expected.end() ? std::vector<int>() : it->second));
+            if (it != expected.end()) it->second.clear();
+            break;
+        }
+        case 3: {
+            FaceTags tags;
+            tags.push_back(-i);
+            map.assign(f, tags);
+            expected[f] = {-i};
+            break;
+        }
+        }
+    }
+    REQUIRE(map.size() == expected.size());
+    for (const auto& [f, tags] : expected) REQUIRE(map.get(f).to_vector() == tags);
+    REQUIRE(map.get({{1000, 1001, 1002}}).empty());
+
+    std::atomic<size_t> visited{0};
+    map.parallel_for_each([&](const auto& f, const auto& tags) {
+        visited++;
+        if (tags.to_vector() != expected.at(f)) visited += 1000000;
+    });
+    REQUIRE(visited == expected.size());
+
+    map.clear();
+    REQUIRE(map.size() == 0);
+    REQUIRE(map.get(expected.begin()->first).empty());
+}
+
+TEST_CASE("face_tag_map_concurrent", "[face_tag_map]")
+{
+    FaceTagMap map;
+    const int n = 100000;
+    // more threads than cores, so that the insertions interleave also on small machines
+    tbb::global_control threads(tbb::global_control::max_allowed_parallelism, 8);
+    tbb::task_arena arena(8);
+    arena.execute([&] {
+        tbb::parallel_for(0, n, [&](int i) {
+            const size_t v = i / 2;
+            map.add({{v, v + 1, v + 2}}, i);
+        });
+    });
+    REQUIRE(map.size() == n / 2);
+    for (size_t v = 0; v < n / 2; v++) {
+        auto tags = map.get({{v, v + 1, v + 2}}).to_vector();
+        std::sort(tags.begin(), tags.end());
+        REQUIRE(tags == std::vector<int>{int(2 * v), int(2 * v + 1)});
+    }
+}
@@ -1,6 +1,12 @@
+#include <wmtk/TetMesh.h>
 #include <wmtk/utils/GeoUtils.h>
+#include <wmtk/utils/InsertTriangleUtils.hpp>
+#include <wmtk/utils/Interval.hpp>
+#include <wmtk/utils/Predicates.hpp>
+#include <wmtk/utils/Rational.hpp>
 
 #include <catch2/catch.hpp>
+#include <random>
 
 using namespace wmtk;
 using namespace Eigen;
@@ -213,4 +219,207 @@ TEST_CASE("segment_triangle_coplanar_3d", "[test_geom]")
 
     const auto res = segment_triangle_coplanar_3d(seg, tri);
     REQUIRE(res);
-}
\ No newline at end of file
+}
+
+
+TEST_CASE("interval_orient3d_filter", "[test_geom]")
+{
+    using Vector3r = Eigen::Matrix<Rational, 3, 1>;
+    auto to_interval = [](const Vector3d& p) { return Interval3{{p[0], p[1], p[2]}}; };
+    auto to_rational = [](const Vector3d& p) { return Vector3r(p[0], p[1], p[2]); };
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    auto random_point = [&]() { return Vector3d(dist(gen), dist(gen), dist(gen)); };
+
+    int n_certain = 0;
+    for (int i = 0; i < 1000; i++) {
+        std::array<Vector3d, 4> p = {{random_point(), random_point(), random_point(), {}}};
+        if (i % 3 == 0) // exactly coplanar
+            p[3] = p[0];
+        else if (i % 3 == 1) // almost coplanar
+            p[3] = (p[0] + p[1] + p[2]) / 3;
+        else
+            p[3] = random_point();
+
+        const int exact =
+            orient3d_t(to_rational(p[0]), to_rational(p[1]), to_rational(p[2]), to_rational(p[3]));
+        const int filtered = orient3d_interval(
+                                 to_interval(p[0]),
+                                 to_interval(p[1]),
+                                 to_interval(p[2]),
+                                 to_interval(p[3]))
+                                 .sign();
+        if (filtered == Interval::UNCERTAIN) continue;
+        n_certain++;
+        REQUIRE(filtered == exact);
+    }
+    // all but the almost coplanar cases are decided by the filter
+    REQUIRE(n_certain >= 666);
+}
+
+TEST_CASE("interval_around_truncated_rational", "[test_geom]")
+{
+    const Rational third = Rational(1) / Rational(3);
+    const Interval i = Interval::around(third.to_double());
+    REQUIRE(Rational(i.lo) < third);
+    REQUIRE(third < Rational(i.hi));
+
+    const Interval zero = Interval(0.1) - Interval(0.1);
+    REQUIRE(zero.sign() == 0);
+    REQUIRE((Interval(0.1) * Interval(3)).sign() == 1);
+}
+
+TEST_CASE("orient3d_batch_filter", "[test_geom]")
+{
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<std::array<Vector3d, 4>> tets;
+    for (int i = 0; i < 100; i++) {
+        std::array<Vector3d, 4> t;
+        for (auto& p : t) p = Vector3d(dist(gen), dist(gen), dist(gen));
+        tets.push_back(t);
+        // coplanar, left to the exact fallback
+        tets.push_back(
+            {{Vector3d(dist(gen), dist(gen), 0.5),
+              Vector3d(0, 0, 0.5),
+              Vector3d(8, 4, 0.5),
+              Vector3d(2, 1, 0.5)}});
+    }
+
+    std::vector<int> res(tets.size());
+    predicates::orient3d_batch(tets.size(), tets.data(), res.data());
+    for (size_t i = 0; i < tets.size(); i++) {
+        const auto& t = tets[i];
+        REQUIRE(res[i] == predicates::orient3d(t[0], t[1], t[2], t[3]));
+        REQUIRE(res[i] == -orient3d_t<Rational>(
+                              t[0].cast<Rational>(),
+                              t[1].cast<Rational>(),
+                              t[2].cast<Rational>(),
+                              t[3].cast<Rational>()));
+    }
+    REQUIRE(res[1] == 0);
+}
+
+TEST_CASE("triangle_insert_prepare_info_filter", "[test_geom]")
+{
+    using Vector3r = Eigen::Matrix<Rational, 3, 1>;
+    using Tuple = TetMesh::Tuple;
+
+    // Kuhn triangulation of an n^3 grid, six tets per cube along the paths from corner 0 to 7
+    const int n = 4;
+    auto grid_vid = [&](int x, int y, int z) { return size_t((x * (n + 1) + y) * (n + 1) + z); };
+    std::vector<std::array<size_t, 4>> tets;
+    const std::array<std::array<int, 3>, 6> axes = {
+        {{{0, 1, 2}}, {{0, 2, 1}}, {{1, 0, 2}}, {{1, 2, 0}}, {{2, 0, 1}}, {{2, 1, 0}}}};
+    for (int x = 0; x < n; x++) {
+        for (int y = 0; y < n; y++) {
+            for (int z = 0; z < n; z++) {
+                for (const auto& order : axes) {
+                    std::array<int, 3> c = {{x, y, z}};
+                    std::array<size_t, 4> tet;
+                    tet[0] = grid_vid(c[0], c[1], c[2]);
+                    for (int k = 0; k < 3; k++) {
+                        c[order[k]]++;
+                        tet[k + 1] = grid_vid(c[0], c[1], c[2]);
+                    }
+                    tets.push_back(tet);
+                }
+            }
+        }
+    }
+    const size_t n_vertices = (n + 1) * (n + 1) * (n + 1);
+    TetMesh mesh;
+    mesh.init(n_vertices, tets);
+
+    // grid points, a third of them moved off the grid planes by a few ulps, so that many
+    // orientation tests are exactly or nearly degenerate
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> ulps(-4, 4);
+    std::vector<Vector3d> positions(n_vertices);
+    for (int x = 0; x <= n; x++) {
+        for (int y = 0; y <= n; y++) {
+            for (int z = 0; z <= n; z++) {
+                Vector3d p(x, y, z);
+                if (grid_vid(x, y, z) % 3 == 0) {
+                    for (int k = 0; k < 3; k++) p[k] += ulps(gen) * 1e-16 * std::max(p[k], 1.);
+                }
+                positions[grid_vid(x, y, z)] = p;
+            }
+        }
+    }
+    auto vertex_pos_r = [&](size_t i) -> Vector3r { return positions[i].cast<Rational>(); };
+    auto exact_interval = [&](size_t i) -> Interval3 {
+        return {{positions[i][0], positions[i][1], positions[i][2]}};
+    };
+    auto widened_interval = [&](size_t i) -> Interval3 {
+        return {
+            {Interval::around(positions[i][0]),
+             Interval::around(positions[i][1]),
+             Interval::around(positions[i][2])}};
+    };
+
+    // triangles in the grid planes and diagonal planes, and random ones
+    std::vector<std::array<size_t, 3>> faces = {
+        {{grid_vid(0, 0, 2), grid_vid(4, 0, 2), grid_vid(0, 4, 2)}},
+        {{grid_vid(1, 1, 1), grid_vid(3, 3, 3), grid_vid(3, 1, 1)}},
+        {{grid_vid(0, 0, 0), grid_vid(4, 4, 4), grid_vid(4, 0, 0)}},
+        {{grid_vid(2, 0, 0), grid_vid(2, 4, 1), grid_vid(2, 1, 4)}},
+        {{grid_vid(0, 2, 1), grid_vid(4, 2, 3), grid_vid(1, 2, 4)}},
+        {{grid_vid(1, 0, 3), grid_vid(3, 4, 3), grid_vid(0, 4, 1)}}};
+    std::uniform_int_distribution<size_t> vertex(0, n_vertices - 1);
+    while (faces.size() < 40) {
+        const std::array<size_t, 3> f = {{vertex(gen), vertex(gen), vertex(gen)}};
+        const Vector3d normal =
+            (positions[f[1]] - positions[f[0]]).cross(positions[f[2]] - positions[f[0]]);
+        if (normal.squaredNorm() > 0) faces.push_back(f);
+    }
+
+    auto acquire_triangle = [](const std::array<size_t, 3>&) { return true; };
+    auto acquire_tetra = [](const std::vector<Tuple>&) { return true; };
+    auto tids = [&](const std::vector<Tuple>& tuples) {
+        std::vector<size_t> ids;
+        for (const auto& t : tuples) ids.push_back(t.tid(mesh));
+        return ids;
+    };
+    auto edge_vids = [&](const std::vector<Tuple>& tuples) {
+        std::vector<std::array<size_t, 2>> ids;
+        for (const auto& t : tuples)
+            ids.push_back({{t.vid(mesh), t.switch_vertex(mesh).vid(mesh)}});
+        return ids;
+    };
+    for (const auto& f : faces) {
+        std::vector<std::array<size_t, 3>> exact_marked;
+        const auto [exact_ok, exact_tets, exact_edges, exact_points] =
+            triangle_insert_prepare_info<Rational>(
+                mesh,
+                f,
+                exact_marked,
+                acquire_triangle,
+                acquire_tetra,
+                vertex_pos_r);
+        REQUIRE(exact_ok);
+
+        // the same classifications with point enclosures and with one-ulp enclosures
+        for (const auto& intervals :
+             {std::function<Interval3(size_t)>(exact_interval),
+              std::function<Interval3(size_t)>(widened_interval)}) {
+            std::vector<std::array<size_t, 3>> marked;
+            const auto [ok, filtered_tets, filtered_edges, points] =
+                triangle_insert_prepare_info<Rational>(
+                    mesh,
+                    f,
+                    marked,
+                    acquire_triangle,
+                    acquire_tetra,
+                    vertex_pos_r,
+                    intervals);
+            REQUIRE(ok);
+            REQUIRE(marked == exact_marked);
+            REQUIRE(tids(filtered_tets) == tids(exact_tets));
+            REQUIRE(edge_vids(filtered_edges) == edge_vids(exact_edges));
+            REQUIRE(points.size() == exact_points.size());
+            for (size_t i = 0; i < points.size(); i++) REQUIRE((points[i] == exact_points[i]));
+        }
+    }
+}
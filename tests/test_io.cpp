@@ -1,8 +1,13 @@
+#include <wmtk/TetMesh.h>
 #include <wmtk/utils/Delaunay.hpp>
+#include <wmtk/utils/MshStreamWriter.hpp>
 #include <wmtk/utils/io.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <cstdio>
+#include <filesystem>
+#include <random>
 #include <sstream>
 
 TEST_CASE("io", "[io][mshio]")
@@ -97,6 +102,110 @@ TEST_CASE("io", "[io][mshio]")
         });
         REQUIRE(tet_indices == std::vector<size_t>({0}));
     }
+
+    SECTION("Attribute columns")
+    {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> coord(0, 1);
+        std::vector<Point3D> points(1000);
+        for (auto& p : points) p = {{coord(gen), coord(gen), coord(gen)}};
+        const auto [vertices, tets] = delaunay3D(points);
+
+        MshData msh;
+        msh.add_tet_vertices(vertices.size(), [&](size_t i) { return vertices[i]; });
+        msh.add_tets(tets.size(), [&](size_t i) { return tets[i]; });
+        msh.add_tet_vertex_attribute<3>("tv position", [&](size_t i) { return vertices[i]; });
+        msh.add_tet_attribute<1>("t index", [&](size_t i) { return 0.5 * i; });
+
+        const auto check = [&](MshData& m) {
+            REQUIRE(m.get_tet_vertex_attribute_names() == std::vector<std::string>{"tv position"});
+            REQUIRE(m.get_tet_attribute_names() == std::vector<std::string>{"t index"});
+            std::vector<Point3D> positions(m.get_num_tet_vertices());
+            m.extract_tet_vertex_attribute(
+                "tv position",
+                [&](size_t i, const std::vector<double>& data) {
+                    REQUIRE(data.size() == 3);
+                    positions[i] = {{data[0], data[1], data[2]}};
+                });
+            REQUIRE(positions == vertices);
+            std::vector<double> indices(m.get_num_tets(), -1);
+            m.extract_tet_attribute("t index", [&](size_t i, const std::vector<double>& data) {
+                REQUIRE(data.size() == 1);
+                indices[i] = data[0];
+            });
+            for (size_t i = 0; i < indices.size(); i++) REQUIRE(indices[i] == 0.5 * i);
+        };
+        check(msh);
+
+        for (bool binary : {true, false}) {
+            std::stringstream ss;
+            msh.save(ss, binary);
+            MshData msh2;
+            msh2.load(ss);
+            REQUIRE(msh2.get_num_tets() == tets.size());
+            check(msh2);
+        }
+    }
+}
+
+TEST_CASE("msh_stream_writer", "[io][mshio]")
+{
+    using namespace wmtk;
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coord(0, 1);
+    std::vector<Point3D> points(300);
+    for (auto& p : points) p = {{coord(gen), coord(gen), coord(gen)}};
+    const auto [vertices, tets] = delaunay3D(points);
+
+    // removing the tets around vertex 0 removes it too, the vertices are renumbered
+    TetMesh mesh;
+    mesh.init(vertices.size(), tets);
+    const auto one_ring = mesh.get_one_ring_tids_for_vertex(mesh.tuple_from_vertex(0));
+    mesh.remove_tets_by_ids(one_ring);
+    const auto live_vertices = mesh.get_vertices();
+    const auto live_tets = mesh.get_tets();
+    REQUIRE(live_vertices.size() < vertices.size());
+    std::vector<size_t> remap(vertices.size(), 0);
+    for (size_t i = 0; i < live_vertices.size(); i++) remap[live_vertices[i].vid(mesh)] = i;
+
+    const auto path = (std::filesystem::temp_directory_path() / "wmtk_stream.msh").string();
+    MshStreamWriter writer(mesh);
+    REQUIRE(writer.num_vertices() == live_vertices.size());
+    REQUIRE(writer.num_tets() == live_tets.size());
+    writer.set_positions([&](size_t i) { return vertices[i]; });
+    writer.add_vertex_attribute<1>("tv index", [](size_t i) { return double(i); });
+    writer.add_tet_attribute<1>("t index", [](size_t i) { return double(i); });
+    writer.write(path);
+
+    MshData msh;
+    msh.load(path);
+    REQUIRE(msh.get_num_tet_vertices() == live_vertices.size());
+    REQUIRE(msh.get_num_tets() == live_tets.size());
+    std::vector<Point3D> out_vertices(msh.get_num_tet_vertices());
+    msh.extract_tet_vertices([&](size_t i, double x, double y, double z) {
+        out_vertices[i] = {{x, y, z}};
+    });
+    for (size_t i = 0; i < live_vertices.size(); i++)
+        REQUIRE(out_vertices[i] == vertices[live_vertices[i].vid(mesh)]);
+    std::vector<double> vertex_ids(msh.get_num_tet_vertices());
+    msh.extract_tet_vertex_attribute("tv index", [&](size_t i, const std::vector<double>& data) {
+        vertex_ids[i] = data[0];
+    });
+    for (size_t i = 0; i < live_vertices.size(); i++)
+        REQUIRE(vertex_ids[i] == live_vertices[i].vid(mesh));
+
+    std::vector<size_t> tet_ids(msh.get_num_tets());
+    msh.extract_tet_attribute("t index", [&](size_t i, const std::vector<double>& data) {
+        tet_ids[i] = size_t(data[0]);
+    });
+    msh.extract_tets([&](size_t i, size_t v0, size_t v1, size_t v2, size_t v3) {
+        REQUIRE(tet_ids[i] == live_tets[i].tid(mesh));
+        const auto expected = mesh.oriented_tet_vids(live_tets[i]);
+        const std::array<size_t, 4> out = {{v0, v1, v2, v3}};
+        for (int j = 0; j < 4; j++) REQUIRE(out[j] == remap[expected[j]]);
+    });
+    std::remove(path.c_str());
 }
 
 TEST_CASE("io-hang", "[io][mshio]")
@@ -3,10 +3,15 @@
 #include <catch2/catch.hpp>
 
 #include <wmtk/utils/ManifoldUtils.hpp>
+#include <wmtk/utils/MeshCleanup.hpp>
+#include <wmtk/utils/Reader.hpp>
 #include "wmtk/utils/Logger.hpp"
 
+#include <igl/Timer.h>
 #include <igl/is_edge_manifold.h>
 #include <igl/is_vertex_manifold.h>
+#include <igl/remove_duplicate_vertices.h>
+#include <igl/remove_unreferenced.h>
 #include <Eigen/Core>
 
 TEST_CASE("separate-manifold-patch", "[test_util]")
@@ -45,3 +50,82 @@ TEST_CASE("manifold-separate-test-37989", "[test_util]")
     Eigen::VectorXi VI;
     REQUIRE(igl::is_vertex_manifold(F, VI));
 }
+
+TEST_CASE("split-nonmanifold-vertices", "[test_util]")
+{
+    // two fans around vertex 0: a bowtie
+    std::vector<Eigen::Vector3d> vertices = {
+        {Eigen::Vector3d(0, 0, 0),
+         Eigen::Vector3d(1, 0, 0),
+         Eigen::Vector3d(1, 1, 0),
+         Eigen::Vector3d(-1, 0, 0),
+         Eigen::Vector3d(-1, -1, 0)}};
+    std::vector<std::array<size_t, 3>> faces = {{{{0, 1, 2}}, {{0, 3, 4}}}};
+    std::vector<size_t> modified_vertices;
+    REQUIRE(wmtk::split_nonmanifold_vertices(vertices, faces, modified_vertices));
+    REQUIRE(vertices.size() == 6);
+    REQUIRE(vertices[5] == vertices[0]);
+    REQUIRE(modified_vertices == std::vector<size_t>{0, 5});
+    REQUIRE(faces[0] == std::array<size_t, 3>{{0, 1, 2}});
+    REQUIRE(faces[1] == std::array<size_t, 3>{{5, 3, 4}});
+
+    // three faces on an edge are left to separate_to_manifold
+    std::vector<std::array<size_t, 3>> edge_faces = {{{{0, 1, 2}}, {{0, 1, 3}}, {{0, 1, 4}}}};
+    const auto expected = edge_faces;
+    REQUIRE_FALSE(wmtk::split_nonmanifold_vertices(vertices, edge_faces, modified_vertices));
+    REQUIRE(edge_faces == expected);
+}
+
+TEST_CASE("input-cleanup-37322", "[test_util]")
+{
+    Eigen::MatrixXd inV;
+    Eigen::MatrixXi inF;
+    wmtk::stl_to_eigen(WMT_DATA_DIR "/37322.stl", inV, inF);
+    const double eps = 1e-5;
+    igl::Timer timer;
+
+    // the serial pipeline stl_to_manifold_wmtk_input used before
+    timer.start();
+    Eigen::MatrixXd V, SV;
+    Eigen::MatrixXi F, SF;
+    Eigen::VectorXi I, SVI, SVJ;
+    igl::remove_unreferenced(inV, inF, V, F, I);
+    igl::remove_duplicate_vertices(V, eps, SV, SVI, SVJ);
+    for (int i = 0; i < F.rows(); i++)
+        for (int j : {0, 1, 2}) F(i, j) = SVJ[F(i, j)];
+    wmtk::resolve_duplicated_faces(F, SF);
+    Eigen::VectorXi dummy;
+    const bool is_manifold = igl::is_edge_manifold(SF) && igl::is_vertex_manifold(SF, dummy);
+    const double serial_time = timer.getElapsedTime();
+
+    std::vector<Eigen::Vector3d> verts(inV.rows());
+    std::vector<std::array<size_t, 3>> tris(inF.rows());
+    wmtk::eigen_to_wmtk_input(verts, tris, inV, inF);
+    timer.start();
+    wmtk::remove_unreferenced_vertices(verts, tris);
+    wmtk::weld_vertices(verts, tris, eps);
+    wmtk::remove_duplicate_faces(tris);
+    std::vector<size_t> modified_vertices;
+    const bool is_split = wmtk::split_nonmanifold_vertices(verts, tris, modified_vertices);
+    const double parallel_time = timer.getElapsedTime();
+    wmtk::logger().info(
+        "input cleanup of {} faces: serial {}s, parallel {}s",
+        inF.rows(),
+        serial_time,
+        parallel_time);
+
+    // the representative of a cell may differ, not the cell
+    REQUIRE(verts.size() == SV.rows());
+    for (size_t i = 0; i < verts.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            REQUIRE(std::round(verts[i][j] / eps) == std::round(SV(i, j) / eps));
+        }
+    }
+    if (is_manifold) REQUIRE((is_split && modified_vertices.empty()));
+    REQUIRE(tris.size() == SF.rows());
+    if (modified_vertices.empty()) {
+        for (size_t i = 0; i < tris.size(); i++) {
+            for (int j = 0; j < 3; j++) REQUIRE(tris[i][j] == SF(i, j));
+        }
+    }
+}
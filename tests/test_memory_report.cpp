@@ -0,0 +1,84 @@
+#include <wmtk/AttributeCollection.hpp>
+#include <wmtk/ExecutionScheduler.hpp>
+#include <wmtk/TetMesh.h>
+#include <wmtk/TriMesh.h>
+#include <wmtk/utils/MemoryReport.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace wmtk;
+
+namespace {
+MemoryUsage entry(const MemoryReport& report, const std::string& name)
+{
+    for (const auto& [n, usage] : report.entries()) {
+        if (n == name) return usage;
+    }
+    FAIL("no entry " << name);
+    return {};
+}
+} // namespace
+
+TEST_CASE("tet_mesh_memory_report", "[memory]")
+{
+    const size_t n_vertices = 6;
+    const std::vector<std::array<size_t, 4>> tets = {
+        {{0, 1, 2, 3}},
+        {{1, 2, 3, 4}},
+        {{2, 3, 4, 5}}};
+
+    TetMesh mesh;
+    AttributeCollection<double> vertex_attrs;
+    mesh.p_vertex_attrs = &vertex_attrs;
+    vertex_attrs.resize(n_vertices);
+    mesh.init(n_vertices, tets);
+
+    const auto report = mesh.memory_report();
+    const auto tet_conn = entry(report, "tet_connectivity");
+    REQUIRE(tet_conn.used >= tets.size() * sizeof(TetMesh::TetrahedronConnectivity));
+    REQUIRE(tet_conn.reserved >= tet_conn.used);
+    // each tet is in the star of its four vertices
+    const auto stars = entry(report, "vertex_stars");
+    REQUIRE(stars.used >= 4 * tets.size() * sizeof(size_t));
+    REQUIRE(stars.reserved >= stars.used);
+    REQUIRE(entry(report, "vertex_attrs").used >= n_vertices * sizeof(double));
+    REQUIRE(entry(report, "edge_attrs").used == 0);
+    REQUIRE(entry(report, "vertex_mutex").used > 0);
+    entry(report, "attribute_rollback");
+    entry(report, "thread_caches");
+
+    const auto total = report.total();
+    REQUIRE(total.used >= tet_conn.used + stars.used);
+    REQUIRE(total.reserved >= total.used);
+    REQUIRE(report.to_string().find("vertex_stars") != std::string::npos);
+
+    // the rollback buffers hold the attributes changed by an operation
+    vertex_attrs.begin_protect();
+    for (size_t i = 0; i < n_vertices; i++) vertex_attrs[i] = 1.;
+    REQUIRE(vertex_attrs.rollback_memory_usage().used >= n_vertices * sizeof(double));
+    vertex_attrs.rollback();
+}
+
+TEST_CASE("tri_mesh_memory_report", "[memory]")
+{
+    TriMesh m;
+    m.create_mesh(4, {{{0, 1, 2}}, {{0, 2, 3}}});
+    ExecutePass<TriMesh> pass;
+    std::vector<std::pair<Op, TriMesh::Tuple>> ops;
+    for (auto& e : m.get_edges()) ops.emplace_back("edge_split", e);
+    pass(m, ops);
+
+    const auto report = m.memory_report();
+    REQUIRE(entry(report, "tri_connectivity").used > 0);
+    REQUIRE(entry(report, "vertex_stars").used > 0);
+    REQUIRE(entry(report, "vertex_attrs").used == 0); // no attributes
+
+    const auto queues = pass.memory_report();
+    REQUIRE(entry(queues, "initial_queues").used == ops.size() * sizeof(decltype(pass)::Elem));
+    REQUIRE(entry(queues, "serial_queue").used == 0);
+
+    MemoryReport combined = report;
+    combined.add("pass.", queues);
+    REQUIRE(combined.entries().size() == report.entries().size() + queues.entries().size());
+    REQUIRE(combined.total().used == report.total().used + queues.total().used);
+}
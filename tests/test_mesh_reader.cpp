@@ -0,0 +1,135 @@
+#include <wmtk/utils/MeshReader.hpp>
+
+#include <igl/read_triangle_mesh.h>
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string temp_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// the two triangles of the unit square in the z = 0 plane
+const std::vector<std::array<float, 9>> square = {
+    {{0, 0, 0, 1, 0, 0, 1, 1, 0}},
+    {{0, 0, 0, 1, 1, 0, 0, 1, 0}}};
+
+void check_square(
+    const std::vector<Eigen::Vector3d>& vertices,
+    const std::vector<std::array<size_t, 3>>& faces)
+{
+    REQUIRE(vertices.size() == 4);
+    REQUIRE(faces.size() == 2);
+    for (size_t f = 0; f < 2; f++) {
+        for (int j = 0; j < 3; j++) {
+            for (int k = 0; k < 3; k++) REQUIRE(vertices[faces[f][j]][k] == square[f][3 * j + k]);
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("read_binary_stl", "[reader]")
+{
+    const auto path = temp_path("wmtk_reader_binary.stl");
+    {
+        // a header starting with "solid" as some exporters write
+        std::ofstream out(path, std::ios::binary);
+        char header[80] = "solid but binary";
+        out.write(header, 80);
+        const uint32_t n = square.size();
+        out.write(reinterpret_cast<const char*>(&n), 4);
+        for (const auto& t : square) {
+            const float normal[3] = {0, 0, 1};
+            const uint16_t attribute = 0;
+            out.write(reinterpret_cast<const char*>(normal), sizeof(normal));
+            out.write(reinterpret_cast<const char*>(t.data()), 9 * sizeof(float));
+            out.write(reinterpret_cast<const char*>(&attribute), 2);
+        }
+    }
+    std::vector<Eigen::Vector3d> vertices;
+    std::vector<std::array<size_t, 3>> faces;
+    REQUIRE(wmtk::read_surface_mesh(path, vertices, faces));
+    check_square(vertices, faces);
+    // corners are welded in order of first appearance
+    REQUIRE(faces[0] == std::array<size_t, 3>{{0, 1, 2}});
+    REQUIRE(faces[1] == std::array<size_t, 3>{{0, 2, 3}});
+    std::remove(path.c_str());
+}
+
+TEST_CASE("read_ascii_stl", "[reader]")
+{
+    const auto path = temp_path("wmtk_reader_ascii.STL");
+    {
+        std::ofstream out(path);
+        out << "solid square\n";
+        for (const auto& t : square) {
+            out << "  facet normal 0 0 1\r\n    outer loop\n";
+            for (int j = 0; j < 3; j++)
+                out << "      vertex " << t[3 * j] << " " << t[3 * j + 1] << " " << t[3 * j + 2]
+                    << "\n";
+            out << "    endloop\n  endfacet\n";
+        }
+        out << "endsolid square";
+    }
+    std::vector<Eigen::Vector3d> vertices;
+    std::vector<std::array<size_t, 3>> faces;
+    REQUIRE(wmtk::read_surface_mesh(path, vertices, faces));
+    check_square(vertices, faces);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("read_obj", "[reader]")
+{
+    const auto path = temp_path("wmtk_reader.obj");
+    {
+        std::ofstream out(path);
+        out << "# a square as a quad, then as triangles with relative ids, and trailing comments\n";
+        out << "v 0 0 0\nv 1 0 0\nvt 0.5 0.5\nv 1 1 0\nvn 0 0 1\nv 0 1 0\n";
+        out << "g square\nf 1/1/1 2/1/1 3/1/1 4/1/1 # the quad\n";
+        out << "v 2 0 0\r\nv 2 1 0 #right\r\nf -6//1 -5//1 -1//1\t# 3 4 5\r\n  # f 1 2 3\r\n";
+        out << "f 5 6 -3#";
+    }
+    std::vector<Eigen::Vector3d> vertices;
+    std::vector<std::array<size_t, 3>> faces;
+    REQUIRE(wmtk::read_surface_mesh(path, vertices, faces));
+    REQUIRE(vertices.size() == 6);
+    REQUIRE(vertices[3] == Eigen::Vector3d(0, 1, 0));
+    REQUIRE(vertices[5] == Eigen::Vector3d(2, 1, 0));
+    const std::vector<std::array<size_t, 3>> expected = {
+        {{0, 1, 2}},
+        {{0, 2, 3}},
+        {{0, 1, 5}},
+        {{4, 5, 3}}};
+    REQUIRE(faces == expected);
+
+    {
+        std::ofstream out(path);
+        out << "v 0 0 0\nf 1 2 3\n";
+    }
+    REQUIRE_THROWS(wmtk::read_surface_mesh(path, vertices, faces));
+    std::remove(path.c_str());
+
+    REQUIRE_FALSE(wmtk::read_surface_mesh(temp_path("wmtk_reader.ply"), vertices, faces));
+}
+
+TEST_CASE("read_surface_mesh_37322", "[reader]")
+{
+    const std::string path = WMT_DATA_DIR "/37322.stl";
+    std::vector<Eigen::Vector3d> vertices;
+    std::vector<std::array<size_t, 3>> faces;
+    REQUIRE(wmtk::read_surface_mesh(path, vertices, faces));
+
+    // igl reads the triangle soup as is
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi F;
+    REQUIRE(igl::read_triangle_mesh(path, V, F));
+    REQUIRE(faces.size() == F.rows());
+    for (size_t f = 0; f < faces.size(); f++) {
+        for (int j = 0; j < 3; j++) REQUIRE(vertices[faces[f][j]] == V.row(F(f, j)).transpose());
+    }
+}
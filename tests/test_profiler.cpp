@@ -0,0 +1,177 @@
+#include <wmtk/ExecutionScheduler.hpp>
+#include <wmtk/TriMesh.h>
+#include <wmtk/utils/Profiler.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace wmtk;
+
+namespace {
+std::string profile_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+/// puts the profiler back as the test found it, e.g. as set up by WMTK_PROFILE
+class RestoreProfiler
+{
+public:
+    RestoreProfiler()
+        : m_enabled(Profiler::enabled())
+        , m_output(Profiler::instance().output())
+        , m_path(Profiler::instance().path())
+        , m_events(Profiler::instance().events_per_thread())
+    {}
+    ~RestoreProfiler()
+    {
+        auto& profiler = Profiler::instance();
+        profiler.clear();
+        profiler.enable(m_output, m_path, m_events);
+        if (!m_enabled) profiler.disable();
+    }
+
+private:
+    bool m_enabled;
+    Profiler::Output m_output;
+    std::string m_path;
+    size_t m_events;
+};
+
+void nested_zones()
+{
+    WMTK_PROFILE_SCOPE("test::outer");
+    for (int i = 0; i < 3; i++) {
+        WMTK_PROFILE_SCOPE("test::inner");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+} // namespace
+
+TEST_CASE("profiler_zones", "[profiler]")
+{
+    auto& profiler = Profiler::instance();
+    RestoreProfiler restore;
+    const auto trace = profile_path("wmtk_test_trace.json");
+    profiler.enable(Profiler::Output::kTrace, trace);
+    profiler.clear();
+
+    nested_zones();
+    std::thread worker(nested_zones);
+    worker.join();
+
+    profiler.write_trace(trace);
+    const auto json = read_file(trace);
+    REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(json.find("\"name\": \"test::outer\"") != std::string::npos);
+    REQUIRE(json.find("\"name\": \"test::inner\"") != std::string::npos);
+    REQUIRE(json.find("\"dropped_events\": 0") != std::string::npos);
+
+    const auto flat = profile_path("wmtk_test_flat.txt");
+    profiler.write_flat_profile(flat);
+    std::istringstream lines(read_file(flat));
+    std::string line;
+    std::getline(lines, line); // header
+    // sorted by total time, the outer zones contain the inner ones
+    std::string name;
+    size_t calls;
+    double total, self, mean;
+    lines >> name >> calls >> total >> self >> mean;
+    REQUIRE(name == "test::outer");
+    REQUIRE(calls == 2);
+    REQUIRE(self < total);
+    lines >> name >> calls >> total >> self >> mean;
+    REQUIRE(name == "test::inner");
+    REQUIRE(calls == 6);
+    REQUIRE(total >= 6.);
+    REQUIRE(self == Approx(total));
+
+    std::filesystem::remove(trace);
+    std::filesystem::remove(flat);
+}
+
+TEST_CASE("profiler_ring_buffer", "[profiler]")
+{
+    auto& profiler = Profiler::instance();
+    RestoreProfiler restore;
+    // the rings of the threads that already traced keep their size, use a new thread
+    const auto trace = profile_path("wmtk_test_ring.json");
+    profiler.enable(Profiler::Output::kTrace, trace, 4);
+    profiler.clear();
+    std::thread worker([] {
+        for (int i = 0; i < 10; i++) {
+            WMTK_PROFILE_SCOPE("test::ring");
+        }
+    });
+    worker.join();
+
+    profiler.write_trace(trace);
+    const auto json = read_file(trace);
+    REQUIRE(json.find("\"dropped_events\": 6") != std::string::npos);
+    std::filesystem::remove(trace);
+
+    // the totals are exact however many events are dropped
+    const auto flat = profile_path("wmtk_test_ring.txt");
+    profiler.write_flat_profile(flat);
+    std::istringstream lines(read_file(flat));
+    std::string line, name;
+    size_t calls;
+    std::getline(lines, line);
+    lines >> name >> calls;
+    REQUIRE(name == "test::ring");
+    REQUIRE(calls == 10);
+    std::filesystem::remove(flat);
+
+    // without the trace output the threads keep no events, only the totals
+    profiler.enable();
+    profiler.clear();
+    std::thread untraced([] {
+        for (int i = 0; i < 10; i++) {
+            WMTK_PROFILE_SCOPE("test::untraced");
+        }
+    });
+    untraced.join();
+    profiler.write_trace(trace);
+    const auto empty = read_file(trace);
+    REQUIRE(empty.find("test::untraced") == std::string::npos);
+    REQUIRE(empty.find("\"dropped_events\": 0") != std::string::npos);
+    std::filesystem::remove(trace);
+    profiler.write_flat_profile(flat);
+    REQUIRE(read_file(flat).find("test::untraced") != std::string::npos);
+    std::filesystem::remove(flat);
+}
+
+TEST_CASE("profiler_execute_pass", "[profiler]")
+{
+    auto& profiler = Profiler::instance();
+    RestoreProfiler restore;
+    profiler.enable();
+    profiler.clear();
+
+    TriMesh m;
+    m.create_mesh(4, {{{0, 1, 2}}, {{0, 2, 3}}});
+    ExecutePass<TriMesh> pass;
+    std::vector<std::pair<Op, TriMesh::Tuple>> ops;
+    for (auto& e : m.get_edges()) ops.emplace_back("edge_split", e);
+    pass(m, ops);
+
+    const auto flat = profile_path("wmtk_test_pass.txt");
+    profiler.write_flat_profile(flat);
+    const auto text = read_file(flat);
+    REQUIRE(text.find("ExecutePass ") != std::string::npos);
+    REQUIRE(text.find("ExecutePass::edge_split") != std::string::npos);
+    REQUIRE(text.find("TriMesh::split_edge") != std::string::npos);
+    std::filesystem::remove(flat);
+}
@@ -0,0 +1,109 @@
+#include <wmtk/utils/AMIPS.h>
+#include <wmtk/utils/Rational.hpp>
+
+#include <catch2/catch.hpp>
+#include <random>
+
+using namespace wmtk;
+
+namespace {
+// reference value computed directly with gmp
+struct Mpq
+{
+    mpq_t q;
+    Mpq(double d)
+    {
+        mpq_init(q);
+        mpq_set_d(q, d);
+    }
+    ~Mpq() { mpq_clear(q); }
+};
+} // namespace
+
+TEST_CASE("rational_fast_path_matches_gmp", "[rational]")
+{
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-10, 10);
+
+    Rational r = 0.5;
+    Mpq ref(0.5);
+    for (int i = 0; i < 200; i++) {
+        const double d = i % 4 == 3 ? std::round(dist(gen)) : dist(gen);
+        Mpq md(d);
+        switch (i % 4) {
+        case 0:
+            r += d;
+            mpq_add(ref.q, ref.q, md.q);
+            break;
+        case 1:
+            r -= d;
+            mpq_sub(ref.q, ref.q, md.q);
+            break;
+        case 2:
+            r *= d;
+            mpq_mul(ref.q, ref.q, md.q);
+            break;
+        default:
+            if (d == 0) continue;
+            r /= d;
+            mpq_div(ref.q, ref.q, md.q);
+        }
+        REQUIRE(r == Rational(ref.q));
+        REQUIRE(r.to_double() == mpq_get_d(ref.q));
+        REQUIRE(r.get_sign() == mpq_sgn(ref.q));
+    }
+}
+
+TEST_CASE("rational_promotion", "[rational]")
+{
+    // inexact in double precision
+    const Rational a = Rational(0.1) + Rational(0.2);
+    REQUIRE(a != Rational(0.3));
+    REQUIRE(a - Rational(0.2) == Rational(0.1));
+
+    const Rational third = Rational(1) / 3;
+    REQUIRE(third * 3 == 1);
+    REQUIRE(third > 0.333);
+    REQUIRE(-third < -0.333);
+    REQUIRE(abs(-third) == third);
+
+    REQUIRE(pow(Rational(3), 4) == 81);
+    REQUIRE(pow(third, -2) == 9);
+    REQUIRE(pow(third, 3) * 27 == 1);
+
+    Rational b = third;
+    Rational c = std::move(b);
+    REQUIRE(c == third);
+    REQUIRE(b == 0);
+    b = std::move(c);
+    REQUIRE(b == third);
+}
+
+TEST_CASE("rational_string_round_trip", "[rational]")
+{
+    const Rational third = Rational(1) / 3;
+    const std::vector<Rational> values = {
+        0,
+        -0.75,
+        1e300,
+        std::ldexp(1., -1070),
+        third,
+        -third * third + 1e-20,
+        pow(Rational(7), 40) / 3};
+    for (const auto& r : values) {
+        const auto str = r.to_string();
+        const auto back = Rational::from_string(str);
+        REQUIRE(back == r);
+        REQUIRE(back.to_double() == r.to_double());
+    }
+    REQUIRE(Rational(0.5).to_string() == "1/2");
+    REQUIRE_THROWS(Rational::from_string("1.5"));
+    REQUIRE_THROWS(Rational::from_string("1/0"));
+}
+
+TEST_CASE("rational_amips", "[rational]")
+{
+    const std::array<double, 12> T = {{0, 0, 0, 1, 0, 0, 0.5, 0.8, 0, 0.5, 0.3, 0.7}};
+    const double expected = std::pow(AMIPS_energy(T), 3);
+    REQUIRE(AMIPS_energy_rational_p3<Rational>(T) == Approx(expected));
+}
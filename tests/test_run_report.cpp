@@ -0,0 +1,115 @@
+#include <wmtk/TriMesh.h>
+#include <wmtk/utils/RunReport.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace wmtk;
+
+namespace {
+std::string report_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/// the "key: value" lines of a written report, in order
+std::vector<std::pair<std::string, double>> read_lines(const std::string& path)
+{
+    std::ifstream in(path);
+    std::vector<std::pair<std::string, double>> lines;
+    for (std::string line; std::getline(in, line);) {
+        const auto colon = line.find(": ");
+        REQUIRE(colon != std::string::npos);
+        lines.emplace_back(line.substr(0, colon), std::stod(line.substr(colon + 2)));
+    }
+    return lines;
+}
+
+double value_of(const std::vector<std::pair<std::string, double>>& lines, const std::string& key)
+{
+    for (const auto& [k, v] : lines) {
+        if (k == key) return v;
+    }
+    FAIL("no line " << key);
+    return 0;
+}
+} // namespace
+
+TEST_CASE("run_report_write", "[run_report]")
+{
+    RunReport report;
+    report.add_time("split", 1);
+    report.add_time("collapse", 2);
+    report.add_time("split", 0.5); // accumulated, in order of first use
+    report.set("tets", 10);
+    report.set("tets", 20); // replaced
+    report.set("avg_energy", 0.25);
+
+    const auto path = report_path("wmtk_run_report.txt");
+    report.write(path);
+    const auto lines = read_lines(path);
+    REQUIRE(lines.size() == 5);
+    REQUIRE(lines[0] == std::make_pair(std::string("time_split"), 1.5));
+    REQUIRE(lines[1] == std::make_pair(std::string("time_collapse"), 2.));
+    REQUIRE(lines[2] == std::make_pair(std::string("tets"), 20.));
+    REQUIRE(lines[3] == std::make_pair(std::string("avg_energy"), 0.25));
+    REQUIRE(lines[4].first == "peak_memory_mb");
+    REQUIRE(lines[4].second > 0);
+    std::filesystem::remove(path);
+
+    REQUIRE_THROWS(report.write(report_path("wmtk_missing_folder/report.txt")));
+}
+
+TEST_CASE("run_report_total_time", "[run_report]")
+{
+    RunReport report;
+    REQUIRE_THROWS(report.stop_total());
+    report.start_total();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    report.stop_total();
+    REQUIRE_THROWS(report.stop_total()); // it is stopped once
+
+    const auto path = report_path("wmtk_run_report_total.txt");
+    report.write(path);
+    REQUIRE(value_of(read_lines(path), "total_time") >= 0.01);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("run_report_global", "[run_report]")
+{
+    // the phases of the threads add up
+    auto phase = [] {
+        ScopedPhase phase("test::phase");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    };
+    std::thread worker(phase);
+    phase();
+    worker.join();
+
+    // the unit square as two triangles, the diagonal is 0 2
+    TriMesh mesh;
+    mesh.create_mesh(4, {{{0, 1, 2}}, {{0, 2, 3}}});
+    const std::vector<Eigen::Vector3d> positions = {
+        Eigen::Vector3d(0, 0, 0),
+        Eigen::Vector3d(1, 0, 0),
+        Eigen::Vector3d(1, 1, 0),
+        Eigen::Vector3d(0, 1, 0)};
+    report_edge_length_valence(mesh, [&](size_t i) { return positions[i]; });
+
+    const auto path = report_path("wmtk_run_report_global.txt");
+    RunReport::global().write(path);
+    const auto lines = read_lines(path);
+    REQUIRE(value_of(lines, "time_test::phase") >= 0.01);
+    REQUIRE(value_of(lines, "avg_edge_length") == Approx((4 + std::sqrt(2.)) / 5));
+    REQUIRE(value_of(lines, "max_edge_length") == Approx(std::sqrt(2.)));
+    REQUIRE(value_of(lines, "min_edge_length") == Approx(1));
+    REQUIRE(value_of(lines, "avg_valence") == Approx(2.5));
+    REQUIRE(value_of(lines, "max_valence") == 3);
+    REQUIRE(value_of(lines, "min_valence") == 2);
+    std::filesystem::remove(path);
+}
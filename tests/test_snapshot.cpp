@@ -0,0 +1,179 @@
+#include <wmtk/TetMesh.h>
+#include <wmtk/TriMesh.h>
+#include <wmtk/utils/Delaunay.hpp>
+#include <wmtk/utils/MeshSnapshot.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace wmtk;
+
+namespace {
+std::string snapshot_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// overwrites the i-th uint64 of a section, found in the table after the 64 byte header
+void patch_id(const std::string& path, const std::string& section, size_t i, uint64_t value)
+{
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    uint64_t num_sections;
+    file.seekg(40);
+    file.read(reinterpret_cast<char*>(&num_sections), 8);
+    for (size_t k = 0; k < num_sections; k++) {
+        char name[40];
+        uint64_t offset;
+        file.seekg(64 + 64 * k);
+        file.read(name, 40);
+        file.read(reinterpret_cast<char*>(&offset), 8);
+        if (section != name) continue;
+        file.seekp(offset + 8 * i);
+        file.write(reinterpret_cast<const char*>(&value), 8);
+        return;
+    }
+    FAIL("no section " << section);
+}
+} // namespace
+
+TEST_CASE("tet_mesh_snapshot", "[snapshot]")
+{
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> coord(0, 1);
+    std::vector<Point3D> points(500);
+    for (auto& p : points) p = {{coord(gen), coord(gen), coord(gen)}};
+    const auto [vertices, tets] = delaunay3D(points);
+
+    TetMesh mesh;
+    mesh.init(vertices.size(), tets);
+    mesh.remove_tets_by_ids({0, 10, 20});
+
+    const auto path = snapshot_path("wmtk_tet_mesh.snapshot");
+    {
+        MeshSnapshotWriter writer(mesh);
+        writer.add_attribute<double, 3>("position", vertices.size(), [&](size_t i) {
+            return vertices[i];
+        });
+        writer.add_attribute<int64_t>("tag", tets.size(), [](size_t i) { return -int64_t(i); });
+        writer.write(path);
+    }
+
+    MeshSnapshot snapshot(path);
+    REQUIRE(snapshot.dimension() == 3);
+    REQUIRE(snapshot.num_vertices() == mesh.vert_capacity());
+    REQUIRE(snapshot.num_cells() == mesh.tet_capacity());
+    REQUIRE(snapshot.attribute_names() == std::vector<std::string>{"position", "tag"});
+
+    const auto position = snapshot.attribute<double>("position");
+    REQUIRE(position.size == vertices.size());
+    REQUIRE(position.num_fields == 3);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        for (int j = 0; j < 3; j++) REQUIRE(position[i][j] == vertices[i][j]);
+    }
+    const auto tag = snapshot.attribute<int64_t>("tag");
+    REQUIRE(tag.size == tets.size());
+    for (size_t i = 0; i < tets.size(); i++) REQUIRE(tag[i][0] == -int64_t(i));
+    REQUIRE_THROWS(snapshot.attribute<float>("position"));
+    REQUIRE_THROWS(snapshot.attribute<double>("missing"));
+
+    TetMesh loaded;
+    loaded.init(snapshot);
+    REQUIRE(loaded.vert_capacity() == mesh.vert_capacity());
+    REQUIRE(loaded.tet_capacity() == mesh.tet_capacity());
+    REQUIRE(loaded.tet_size() == mesh.tet_size());
+    REQUIRE(loaded.vertex_size() == mesh.vertex_size());
+    REQUIRE(loaded.check_mesh_connectivity_validity());
+    const auto expected_tets = mesh.get_tets();
+    const auto loaded_tets = loaded.get_tets();
+    REQUIRE(loaded_tets.size() == expected_tets.size());
+    for (size_t i = 0; i < loaded_tets.size(); i++) {
+        REQUIRE(
+            loaded.oriented_tet_vids(loaded_tets[i]) == mesh.oriented_tet_vids(expected_tets[i]));
+    }
+    const auto expected_vertices = mesh.get_vertices();
+    const auto loaded_vertices = loaded.get_vertices();
+    REQUIRE(loaded_vertices.size() == expected_vertices.size());
+    for (size_t i = 0; i < loaded_vertices.size(); i++) {
+        REQUIRE(
+            loaded.get_one_ring_tids_for_vertex(loaded_vertices[i]) ==
+            mesh.get_one_ring_tids_for_vertex(expected_vertices[i]));
+    }
+
+    TriMesh wrong_kind;
+    REQUIRE_THROWS(wrong_kind.create_mesh(snapshot));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("tri_mesh_snapshot", "[snapshot]")
+{
+    TriMesh mesh;
+    mesh.create_mesh(5, {{{0, 1, 2}}, {{0, 2, 3}}, {{0, 3, 4}}, {{0, 4, 1}}});
+
+    const auto path = snapshot_path("wmtk_tri_mesh.snapshot");
+    MeshSnapshotWriter(mesh).write(path);
+    MeshSnapshot snapshot(path);
+    REQUIRE(snapshot.dimension() == 2);
+    REQUIRE(snapshot.attribute_names().empty());
+    REQUIRE(snapshot.star_offsets()[1] == 4);
+
+    TriMesh loaded;
+    loaded.create_mesh(snapshot);
+    REQUIRE(loaded.vert_capacity() == 5);
+    REQUIRE(loaded.tri_capacity() == 4);
+    const auto expected_faces = mesh.get_faces();
+    const auto loaded_faces = loaded.get_faces();
+    REQUIRE(loaded_faces.size() == expected_faces.size());
+    for (size_t i = 0; i < loaded_faces.size(); i++) {
+        const auto a = loaded.oriented_tri_vertices(loaded_faces[i]);
+        const auto b = mesh.oriented_tri_vertices(expected_faces[i]);
+        for (int j = 0; j < 3; j++) REQUIRE(a[j].vid(loaded) == b[j].vid(mesh));
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("invalid_snapshot", "[snapshot]")
+{
+    REQUIRE_THROWS(MeshSnapshot(snapshot_path("wmtk_missing.snapshot")));
+
+    const auto path = snapshot_path("wmtk_invalid.snapshot");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "this is not a snapshot, but it is long enough to hold a header, and more text";
+    }
+    REQUIRE_THROWS(MeshSnapshot(path));
+
+    // a valid header and section table, cut in the middle of the sections
+    TriMesh mesh;
+    mesh.create_mesh(3, {{{0, 1, 2}}});
+    MeshSnapshotWriter(mesh).write(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 100);
+    REQUIRE_THROWS(MeshSnapshot(path));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("invalid_snapshot_connectivity", "[snapshot]")
+{
+    TriMesh mesh;
+    mesh.create_mesh(4, {{{0, 1, 2}}, {{0, 2, 3}}});
+    const auto path = snapshot_path("wmtk_invalid_connectivity.snapshot");
+    const auto corrupted = [&](const std::string& section, size_t i, uint64_t value) {
+        MeshSnapshotWriter(mesh).write(path);
+        patch_id(path, section, i, value);
+        MeshSnapshot snapshot(path);
+        TriMesh loaded;
+        REQUIRE_THROWS_AS(loaded.create_mesh(snapshot), std::runtime_error);
+        REQUIRE_THROWS_AS(snapshot.check_connectivity(), std::runtime_error);
+    };
+
+    MeshSnapshotWriter(mesh).write(path);
+    REQUIRE_NOTHROW(MeshSnapshot(path).check_connectivity());
+    // vertex 0 is in both triangles, the offsets are 0 2 3 5 6
+    corrupted("cells", 1, 4);
+    corrupted("star_offsets", 1, 4);
+    corrupted("stars", 0, 2);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,119 @@
+#include <wmtk/utils/FastWindingNumber.hpp>
+
+#include <catch2/catch.hpp>
+#include <random>
+
+using namespace wmtk;
+
+namespace {
+// a closed sphere of radius 1, oriented outwards, with a few thousand triangles
+void uv_sphere(int n, Eigen::MatrixXd& V, Eigen::MatrixXi& F)
+{
+    const int rings = n, segments = 2 * n;
+    V.resize(2 + (rings - 1) * segments, 3);
+    V.row(0) << 0, 0, 1;
+    V.row(1) << 0, 0, -1;
+    for (int i = 1; i < rings; i++) {
+        const double theta = M_PI * i / rings;
+        for (int j = 0; j < segments; j++) {
+            const double phi = 2 * M_PI * j / segments;
+            V.row(2 + (i - 1) * segments + j) << std::sin(theta) * std::cos(phi),
+                std::sin(theta) * std::sin(phi), std::cos(theta);
+        }
+    }
+    auto vid = [&](int i, int j) { return 2 + (i - 1) * segments + (j % segments); };
+    std::vector<Eigen::Vector3i> faces;
+    for (int j = 0; j < segments; j++) {
+        faces.emplace_back(0, vid(1, j), vid(1, j + 1));
+        faces.emplace_back(1, vid(rings - 1, j + 1), vid(rings - 1, j));
+        for (int i = 1; i < rings - 1; i++) {
+            faces.emplace_back(vid(i, j), vid(i + 1, j), vid(i + 1, j + 1));
+            faces.emplace_back(vid(i, j), vid(i + 1, j + 1), vid(i, j + 1));
+        }
+    }
+    F.resize(faces.size(), 3);
+    for (size_t i = 0; i < faces.size(); i++) F.row(i) = faces[i];
+}
+} // namespace
+
+TEST_CASE("triangle_winding_number", "[winding_number]")
+{
+    const Eigen::Vector3d a(0, 0, 1), b(1, 0, 1), c(0, 1, 1);
+    // a triangle facing away from the point counts positively
+    REQUIRE(triangle_winding_number(Eigen::Vector3d::Zero(), a, b, c) > 0);
+    REQUIRE(
+        triangle_winding_number(Eigen::Vector3d::Zero(), a, c, b) ==
+        Approx(-triangle_winding_number(Eigen::Vector3d::Zero(), a, b, c)));
+    // seen from right below its corner, a huge triangle covers a quarter of the half space
+    const Eigen::Vector3d far_b(1e6, 0, 1), far_c(0, 1e6, 1);
+    REQUIRE(
+        triangle_winding_number(Eigen::Vector3d::Zero(), a, far_b, far_c) ==
+        Approx(0.125).epsilon(1e-4));
+}
+
+TEST_CASE("fast_winding_number_sphere", "[winding_number]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi F;
+    uv_sphere(40, V, F);
+    FastWindingNumber fwn(V, F);
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(-2, 2);
+    Eigen::MatrixXd Q(2000, 3);
+    for (int i = 0; i < Q.rows(); i++) Q.row(i) << dist(gen), dist(gen), dist(gen);
+
+    const double inscribed = std::cos(M_PI / 40);
+    double max_error = 0;
+    for (int i = 0; i < Q.rows(); i++) {
+        const Eigen::Vector3d q = Q.row(i);
+        const double exact = fwn.winding_number(q, 0.);
+        if (q.norm() < 0.95 * inscribed) REQUIRE(exact == Approx(1).margin(1e-8));
+        if (q.norm() > 1.05) REQUIRE(exact == Approx(0).margin(1e-8));
+        max_error = std::max(max_error, std::abs(fwn.winding_number(q) - exact));
+    }
+    REQUIRE(max_error < 0.1);
+
+    // the classification with refinement is the exact one
+    const auto W = fwn.winding_numbers(Q);
+    for (int i = 0; i < Q.rows(); i++)
+        REQUIRE((W[i] > 0.5) == (fwn.winding_number(Q.row(i), 0.) > 0.5));
+
+    // flipping all the triangles negates the winding number
+    Eigen::MatrixXi flipped = F;
+    flipped.col(1).swap(flipped.col(2));
+    FastWindingNumber inverted(V, flipped);
+    for (int i = 0; i < 100; i++)
+        REQUIRE(
+            inverted.winding_number(Q.row(i), 0.) ==
+            Approx(-fwn.winding_number(Q.row(i), 0.)).margin(1e-10));
+
+    REQUIRE(FastWindingNumber(V, Eigen::MatrixXi(0, 3)).winding_number(Q.row(0)) == 0);
+}
+
+TEST_CASE("fast_winding_number_benchmark", "[winding_number][.benchmark]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi F;
+    uv_sphere(150, V, F);
+    FastWindingNumber fwn(V, F);
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(-1.5, 1.5);
+    Eigen::MatrixXd Q(10000, 3);
+    for (int i = 0; i < Q.rows(); i++) Q.row(i) << dist(gen), dist(gen), dist(gen);
+
+    BENCHMARK("build 90k triangles")
+    {
+        return FastWindingNumber(V, F).num_nodes();
+    };
+    const Eigen::MatrixXd Q100 = Q.topRows(100);
+    BENCHMARK("100 points, exact")
+    {
+        return fwn.winding_numbers(Q100, 0.);
+    };
+    BENCHMARK("10k points, accuracy 2")
+    {
+        return fwn.winding_numbers(Q);
+    };
+}